@@ -201,6 +201,36 @@
 #define ONLP_SNMP_CONFIG_RESOURCE_UPDATE_SECONDS 5
 #endif
 
+/**
+ * ONLP_SNMP_CONFIG_DISCOVERY_PERIOD
+ *
+ * Sensor rediscovery period in seconds when no presence change is seen. Zero disables periodic rediscovery. */
+
+
+#ifndef ONLP_SNMP_CONFIG_DISCOVERY_PERIOD
+#define ONLP_SNMP_CONFIG_DISCOVERY_PERIOD 60
+#endif
+
+/**
+ * ONLP_SNMP_CONFIG_SENSOR_INDEX_SIZE
+ *
+ * The number of OID ids per sensor type indexed directly. Sensors with larger ids are found by search. */
+
+
+#ifndef ONLP_SNMP_CONFIG_SENSOR_INDEX_SIZE
+#define ONLP_SNMP_CONFIG_SENSOR_INDEX_SIZE 256
+#endif
+
+/**
+ * ONLP_SNMP_CONFIG_RESOURCE_CPUS_MAX
+ *
+ * Maximum number of CPUs reported individually in the resource objects. */
+
+
+#ifndef ONLP_SNMP_CONFIG_RESOURCE_CPUS_MAX
+#define ONLP_SNMP_CONFIG_RESOURCE_CPUS_MAX 64
+#endif
+
 
 
 /**
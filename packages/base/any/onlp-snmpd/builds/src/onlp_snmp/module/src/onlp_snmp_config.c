@@ -99,6 +99,21 @@ onlp_snmp_config_settings_t onlp_snmp_config_settings[] =
     { __onlp_snmp_config_STRINGIFY_NAME(ONLP_SNMP_CONFIG_RESOURCE_UPDATE_SECONDS), __onlp_snmp_config_STRINGIFY_VALUE(ONLP_SNMP_CONFIG_RESOURCE_UPDATE_SECONDS) },
 #else
 { ONLP_SNMP_CONFIG_RESOURCE_UPDATE_SECONDS(__onlp_snmp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_SNMP_CONFIG_DISCOVERY_PERIOD
+    { __onlp_snmp_config_STRINGIFY_NAME(ONLP_SNMP_CONFIG_DISCOVERY_PERIOD), __onlp_snmp_config_STRINGIFY_VALUE(ONLP_SNMP_CONFIG_DISCOVERY_PERIOD) },
+#else
+{ ONLP_SNMP_CONFIG_DISCOVERY_PERIOD(__onlp_snmp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_SNMP_CONFIG_SENSOR_INDEX_SIZE
+    { __onlp_snmp_config_STRINGIFY_NAME(ONLP_SNMP_CONFIG_SENSOR_INDEX_SIZE), __onlp_snmp_config_STRINGIFY_VALUE(ONLP_SNMP_CONFIG_SENSOR_INDEX_SIZE) },
+#else
+{ ONLP_SNMP_CONFIG_SENSOR_INDEX_SIZE(__onlp_snmp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_SNMP_CONFIG_RESOURCE_CPUS_MAX
+    { __onlp_snmp_config_STRINGIFY_NAME(ONLP_SNMP_CONFIG_RESOURCE_CPUS_MAX), __onlp_snmp_config_STRINGIFY_VALUE(ONLP_SNMP_CONFIG_RESOURCE_CPUS_MAX) },
+#else
+{ ONLP_SNMP_CONFIG_RESOURCE_CPUS_MAX(__onlp_snmp_config_STRINGIFY_NAME), "__undefined__" },
 #endif
     { NULL, NULL }
 };
@@ -26,14 +26,15 @@
 #include "onlp_snmp_log.h"
 
 #include <AIM/aim_time.h>
-#include <cjson/cJSON.h>
-#include <cjson_util/cjson_util.h>
 #include <net-snmp/net-snmp-config.h>
 #include <net-snmp/net-snmp-includes.h>
 #include <net-snmp/agent/net-snmp-agent-includes.h>
 #include <onlp/sys.h>
+#include <onlplib/file.h>
 
 #include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <unistd.h>
 
 static void
@@ -76,28 +77,70 @@ platform_int_register(int index, char* desc, int value)
 }
 
 static void
-resource_int_register(int index, const char* desc,
-                      Netsnmp_Node_Handler *handler)
+resource_gauge_register(oid *tree, size_t tree_len, const char* desc,
+                        size_t offset, Netsnmp_Node_Handler *handler)
 {
-    oid tree[] = { 1, 3, 6, 1, 4, 1, 42623, 1, 3, 1, 1 };
-    tree[10] = index;
-
     netsnmp_handler_registration *reg =
         netsnmp_create_handler_registration(desc, handler,
-                                            tree, OID_LENGTH(tree),
+                                            tree, tree_len,
                                             HANDLER_CAN_RONLY);
+    /* the handler reads the gauge at this offset in the resources */
+    reg->handler->myvoid = (void *)offset;
     if (netsnmp_register_instance(reg) != MIB_REGISTERED_OK) {
         AIM_LOG_ERROR("registering handler for %s failed", desc);
     }
 }
 
+static void
+resource_int_register(int index, const char* desc, size_t offset,
+                      Netsnmp_Node_Handler *handler)
+{
+    oid tree[] = { 1, 3, 6, 1, 4, 1, 42623, 1, 3, 1, 1 };
+    tree[10] = index;
+
+    resource_gauge_register(tree, OID_LENGTH(tree), desc, offset, handler);
+}
+
+static void
+resource_cpu_int_register(int index, int cpu, const char* desc,
+                          size_t offset, Netsnmp_Node_Handler *handler)
+{
+    /* onlResource.CpuTable.CpuEntry.<column>.<cpu + 1> */
+    oid tree[] = { 1, 3, 6, 1, 4, 1, 42623, 1, 3, 2, 1, 1, 1 };
+    tree[11] = index;
+    tree[12] = cpu + 1;
+
+    char* s = aim_fstrdup("Cpu%d%s", cpu, desc);
+    resource_gauge_register(tree, OID_LENGTH(tree), s, offset, handler);
+    aim_free(s);
+}
+
 /* updates happen in this pthread */
 static pthread_t update_thread_handle;
 
-/* resource objects */
+/* cpu time shares, in hundredths of a percent */
 typedef struct {
     uint32_t utilization_percent;
     uint32_t idle_percent;
+    uint32_t iowait_percent;
+    uint32_t softirq_percent;
+} cpu_resources_t;
+
+/* resource objects */
+typedef struct {
+    cpu_resources_t all;
+    /* load averages, in hundredths */
+    uint32_t load_average_1;
+    uint32_t load_average_5;
+    uint32_t load_average_15;
+    /* memory, in kB */
+    uint32_t mem_total;
+    uint32_t mem_free;
+    uint32_t mem_available;
+    uint32_t mem_buffers;
+    uint32_t mem_cached;
+    uint32_t num_cpus;
+    cpu_resources_t cpus[ONLP_SNMP_CONFIG_RESOURCE_CPUS_MAX];
 } resources_t;
 
 #define NUM_RESOURCE_BUFFERS (2)
@@ -125,75 +168,209 @@ swap_curr_next_resources(void)
     curr_resource = next_resource();
 }
 
+/*
+ * The /proc files are held open and re-read with pread
+ * on every update.
+ */
+static onlp_file_handle_t *proc_stat__;
+static onlp_file_handle_t *proc_loadavg__;
+static onlp_file_handle_t *proc_meminfo__;
+
+/* cpu times from the previous /proc/stat sample, "cpu" first */
+typedef struct {
+    bool valid;
+    uint64_t total;
+    uint64_t idle;
+    uint64_t iowait;
+    uint64_t softirq;
+} cpu_times_t;
+
+static cpu_times_t cpu_times__[ONLP_SNMP_CONFIG_RESOURCE_CPUS_MAX+1];
+
+static int
+proc_read__(onlp_file_handle_t **h, const char *name,
+            char *buf, int size)
+{
+    int rv, len;
+
+    if (*h == NULL) {
+        rv = onlp_file_handle_open(h, "%s", name);
+        if (rv < 0) {
+            return rv;
+        }
+    }
+
+    rv = onlp_file_handle_read(*h, (uint8_t *)buf, size-1, &len);
+    if (rv < 0) {
+        return rv;
+    }
+    buf[len] = 0;
+    return len;
+}
+
+static uint32_t
+cpu_percent__(uint64_t part, uint64_t total)
+{
+    return (uint32_t)((part * 100 * 100) / total);
+}
+
+/*
+ * Update cpu_resources from the change in cpu times since the
+ * previous sample. The first sample only records the times.
+ */
 static void
-resource_update(void)
+cpu_times_update__(cpu_times_t *prev, cpu_times_t *now,
+                   cpu_resources_t *cr)
 {
-    uint64_t now = aim_time_monotonic();
-    if (now - last_resource_update_time >
-        (ONLP_SNMP_CONFIG_RESOURCE_UPDATE_SECONDS * 1000 * 1000)) {
-        last_resource_update_time = now;
+    uint64_t total = now->total - prev->total;
+
+    if (prev->valid && now->total > prev->total) {
+        cr->idle_percent = cpu_percent__(now->idle - prev->idle, total);
+        cr->iowait_percent = cpu_percent__(now->iowait - prev->iowait, total);
+        cr->softirq_percent = cpu_percent__(now->softirq - prev->softirq,
+                                            total);
+        cr->utilization_percent = 100*100 - cr->idle_percent;
+    }
+    *prev = *now;
+}
+
+static void
+cpu_update__(resources_t *next)
+{
+    static char buf[(ONLP_SNMP_CONFIG_RESOURCE_CPUS_MAX+2) * 256];
+    char *line, *end, *saveptr;
+    int cpu;
 
-        /* invoke mpstat collection script for json output */
-        FILE *fp = popen("/usr/bin/onl-snmp-mpstat", "r");
-        if (fp == NULL) {
-            AIM_LOG_ERROR("failed invoking onl-snmp-mpstat");
-            return;
+    if (proc_read__(&proc_stat__, "/proc/stat", buf, sizeof(buf)) < 0) {
+        return;
+    }
+
+    /* the per-cpu lines are first; ignore any line cut short */
+    if ((end = strrchr(buf, '\n')) == NULL) {
+        return;
+    }
+    end[1] = 0;
+
+    next->num_cpus = 0;
+    for (line = strtok_r(buf, "\n", &saveptr); line;
+         line = strtok_r(NULL, "\n", &saveptr)) {
+        unsigned long long v[8];
+        cpu_times_t now;
+
+        if (strncmp(line, "cpu", 3)) {
+            break;
+        }
+        if (line[3] == ' ') {
+            cpu = -1;
+        } else if (sscanf(line+3, "%d", &cpu) != 1 ||
+                   cpu < 0 || cpu >= ONLP_SNMP_CONFIG_RESOURCE_CPUS_MAX) {
+            continue;
         }
 
-        /* parse json output */
-        char line[1024];
-        while (fgets(line, sizeof(line), fp) != NULL) {
-            cJSON *root = cJSON_Parse(line);
-            int result;
-            int rv = cjson_util_lookup_int(root, &result, "all.%%idle");
-            if (rv == 0) {
-                resources_t *next = get_next_resources();
-                /* save it */
-                next->idle_percent = result;
-                next->utilization_percent = 100*100 - result;
-                /* swap buffers */
-                swap_curr_next_resources();
-            }
-            cJSON_Delete(root);
+        /* user nice system idle iowait irq softirq steal */
+        if (sscanf(line, "%*s %llu %llu %llu %llu %llu %llu %llu %llu",
+                   &v[0], &v[1], &v[2], &v[3],
+                   &v[4], &v[5], &v[6], &v[7]) != 8) {
+            continue;
+        }
+        now.valid = true;
+        now.total = v[0] + v[1] + v[2] + v[3] + v[4] + v[5] + v[6] + v[7];
+        now.idle = v[3];
+        now.iowait = v[4];
+        now.softirq = v[6];
+
+        cpu_times_update__(&cpu_times__[cpu+1], &now,
+                           (cpu < 0)? &next->all: &next->cpus[cpu]);
+        if (cpu >= 0) {
+            next->num_cpus++;
         }
+    }
+}
+
+static void
+load_update__(resources_t *next)
+{
+    char buf[128];
+    double l1, l5, l15;
 
-        pclose(fp);
+    if (proc_read__(&proc_loadavg__, "/proc/loadavg", buf, sizeof(buf)) < 0) {
+        return;
+    }
+    if (sscanf(buf, "%lf %lf %lf", &l1, &l5, &l15) == 3) {
+        next->load_average_1 = (uint32_t)(l1 * 100 + 0.5);
+        next->load_average_5 = (uint32_t)(l5 * 100 + 0.5);
+        next->load_average_15 = (uint32_t)(l15 * 100 + 0.5);
     }
 }
 
-static int
-utilization_handler(netsnmp_mib_handler *handler,
-             netsnmp_handler_registration *reginfo,
-             netsnmp_agent_request_info *reqinfo,
-             netsnmp_request_info *requests)
+static void
+mem_update__(resources_t *next)
 {
-    if (MODE_GET == reqinfo->mode) {
-        resources_t *curr = get_curr_resources();
-        snmp_set_var_typed_value(requests->requestvb, ASN_GAUGE,
-                                 (u_char *) &curr->utilization_percent,
-                                 sizeof(curr->utilization_percent));
-    } else {
-        netsnmp_assert("bad mode in RO handler");
+    static char buf[4096];
+    char *line, *saveptr;
+
+    if (proc_read__(&proc_meminfo__, "/proc/meminfo", buf, sizeof(buf)) < 0) {
+        return;
     }
 
-    if (handler->next && handler->next->access_method) {
-        return netsnmp_call_next_handler(handler, reginfo, reqinfo, requests);
+    for (line = strtok_r(buf, "\n", &saveptr); line;
+         line = strtok_r(NULL, "\n", &saveptr)) {
+        char key[32];
+        unsigned long long kb;
+
+        if (sscanf(line, "%31[^:]: %llu", key, &kb) != 2) {
+            continue;
+        }
+        if (!strcmp(key, "MemTotal")) {
+            next->mem_total = kb;
+        } else if (!strcmp(key, "MemFree")) {
+            next->mem_free = kb;
+        } else if (!strcmp(key, "MemAvailable")) {
+            next->mem_available = kb;
+        } else if (!strcmp(key, "Buffers")) {
+            next->mem_buffers = kb;
+        } else if (!strcmp(key, "Cached")) {
+            next->mem_cached = kb;
+            /* the remaining fields are not used */
+            break;
+        }
     }
+}
 
-    return SNMP_ERR_NOERROR;
+static void
+resource_update(void)
+{
+    uint64_t now = aim_time_monotonic();
+    if (now - last_resource_update_time >
+        (ONLP_SNMP_CONFIG_RESOURCE_UPDATE_SECONDS * 1000 * 1000)) {
+        last_resource_update_time = now;
+
+        /* start from the current values, so that anything which
+         * cannot be sampled this time keeps its last value */
+        resources_t *next = get_next_resources();
+        *next = *get_curr_resources();
+
+        cpu_update__(next);
+        load_update__(next);
+        mem_update__(next);
+
+        /* swap buffers */
+        swap_curr_next_resources();
+    }
 }
 
 static int
-idle_handler(netsnmp_mib_handler *handler,
-             netsnmp_handler_registration *reginfo,
-             netsnmp_agent_request_info *reqinfo,
-             netsnmp_request_info *requests)
+resource_handler(netsnmp_mib_handler *handler,
+                 netsnmp_handler_registration *reginfo,
+                 netsnmp_agent_request_info *reqinfo,
+                 netsnmp_request_info *requests)
 {
     if (MODE_GET == reqinfo->mode) {
         resources_t *curr = get_curr_resources();
+        uint32_t *value = (uint32_t *)((uint8_t *)curr +
+                                       (size_t)handler->myvoid);
         snmp_set_var_typed_value(requests->requestvb, ASN_GAUGE,
-                                 (u_char *) &curr->idle_percent,
-                                 sizeof(curr->idle_percent));
+                                 (u_char *) value, sizeof(*value));
     } else {
         netsnmp_assert("bad mode in RO handler");
     }
@@ -246,8 +423,47 @@ onlp_snmp_platform_init(void)
         REGISTER_STR(15, onie_version);
     }
 
-    resource_int_register(1, "CpuAllPercentUtilization", utilization_handler);
-    resource_int_register(2, "CpuAllPercentIdle", idle_handler);
+#define REGISTER_RESOURCE(_index, _desc, _field)                        \
+    resource_int_register(_index, _desc,                                \
+                          offsetof(resources_t, _field), resource_handler)
+
+    REGISTER_RESOURCE(1,  "CpuAllPercentUtilization", all.utilization_percent);
+    REGISTER_RESOURCE(2,  "CpuAllPercentIdle",        all.idle_percent);
+    REGISTER_RESOURCE(3,  "CpuAllPercentIowait",      all.iowait_percent);
+    REGISTER_RESOURCE(4,  "CpuAllPercentSoftirq",     all.softirq_percent);
+    REGISTER_RESOURCE(5,  "LoadAverage1",             load_average_1);
+    REGISTER_RESOURCE(6,  "LoadAverage5",             load_average_5);
+    REGISTER_RESOURCE(7,  "LoadAverage15",            load_average_15);
+    REGISTER_RESOURCE(8,  "MemTotal",                 mem_total);
+    REGISTER_RESOURCE(9,  "MemFree",                  mem_free);
+    REGISTER_RESOURCE(10, "MemAvailable",             mem_available);
+    REGISTER_RESOURCE(11, "MemBuffers",               mem_buffers);
+    REGISTER_RESOURCE(12, "MemCached",                mem_cached);
+    REGISTER_RESOURCE(13, "CpuCount",                 num_cpus);
+
+    /**
+     * Per-cpu objects, indexed by cpu number + 1. Column 1 is
+     * the index itself and is not accessible.
+     */
+    int cpu;
+    long ncpus = sysconf(_SC_NPROCESSORS_CONF);
+    if (ncpus > ONLP_SNMP_CONFIG_RESOURCE_CPUS_MAX) {
+        ncpus = ONLP_SNMP_CONFIG_RESOURCE_CPUS_MAX;
+    }
+    for (cpu = 0; cpu < ncpus; cpu++) {
+
+#define REGISTER_CPU_RESOURCE(_index, _desc, _field)                    \
+        resource_cpu_int_register(_index, cpu, _desc,                   \
+                                  offsetof(resources_t, cpus) +         \
+                                  cpu * sizeof(cpu_resources_t) +       \
+                                  offsetof(cpu_resources_t, _field),    \
+                                  resource_handler)
+
+        REGISTER_CPU_RESOURCE(2, "PercentUtilization", utilization_percent);
+        REGISTER_CPU_RESOURCE(3, "PercentIdle",        idle_percent);
+        REGISTER_CPU_RESOURCE(4, "PercentIowait",      iowait_percent);
+        REGISTER_CPU_RESOURCE(5, "PercentSoftirq",     softirq_percent);
+    }
 }
 
 #define MIN(a,b) ((a)<(b)? (a): (b))
@@ -266,7 +482,7 @@ cpu_utilization_handler__(int fd, void* cookie)
 {
     char svalue[64];
     resources_t *curr = get_curr_resources();
-    sprintf(svalue, "%d", curr->utilization_percent);
+    sprintf(svalue, "%d", curr->all.utilization_percent);
     write(fd, svalue, strlen(svalue));
     close(fd);
     return 0;
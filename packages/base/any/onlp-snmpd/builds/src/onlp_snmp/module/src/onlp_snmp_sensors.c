@@ -33,6 +33,8 @@
 #include <AIM/aim_time.h>
 
 #include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <unistd.h>
 
 #include <onlp/thermal.h>
@@ -51,15 +53,10 @@ typedef struct sensor_info_s {
     } data;
 } sensor_info_t;
 
-/* for front-back buffers */
-#define NUM_SENSOR_INFO (2)
-
 /**
  * Individual Sensor Control structure.
- * The valid field in the sensor_info_t structure above
- * is used snmp table maintenance:
- * - A table row is added when previously invalid sensor is now valid.
- * - A table row is deleted when previously valid sensor is now invalid
+ * Owned by the update thread, which refreshes the sensor info
+ * and publishes a copy of each valid sensor as a table row.
  */
 typedef struct onlp_snmp_sensor_s {
     list_links_t links;  /* for tracking sensors of the same type */
@@ -68,38 +65,62 @@ typedef struct onlp_snmp_sensor_s {
     char desc[ONLP_SNMP_CONFIG_MAX_DESC_LENGTH];
     onlp_snmp_sensor_type_t sensor_type;
     uint32_t index;      /* snmp table column */
-    sensor_info_t sensor_info[NUM_SENSOR_INFO];
+    bool discovered;     /* found by the last discovery */
+    sensor_info_t info;
 } onlp_snmp_sensor_t;
 
-static int curr_info;
-static int
-next_info(void)
-{
-    return (curr_info+1) % NUM_SENSOR_INFO;
-}
-static sensor_info_t *
-get_curr_info(onlp_snmp_sensor_t *ss)
-{
-    return &ss->sensor_info[curr_info];
-}
-static sensor_info_t *
-get_next_info(onlp_snmp_sensor_t *ss)
-{
-    return &ss->sensor_info[next_info()];
-}
-static void
-swap_curr_next_info(void)
-{
-    curr_info = next_info();
-}
+/**
+ * Published copy of a sensor, as read by the snmp handlers.
+ */
+typedef struct sensor_row_s {
+    int sensor_id;
+    uint32_t index;
+    char name[ONLP_SNMP_CONFIG_MAX_NAME_LENGTH];
+    char desc[ONLP_SNMP_CONFIG_MAX_DESC_LENGTH];
+    sensor_info_t info;
+} sensor_row_t;
+
+/**
+ * A table cell, encoded when its snapshot is built.
+ */
+typedef struct sensor_cell_s {
+    u_char type;         /* ASN type, 0 if the cell has no value */
+    long integer;        /* value, if data is NULL */
+    u_char *data;        /* value, owned by the cell */
+    size_t len;
+} sensor_cell_t;
+
+/**
+ * Immutable snapshot of one sensor table, rows sorted by index.
+ * A new snapshot is published after every update; members_epoch
+ * only changes when rows were added or removed.
+ *
+ * Cells are stored by column, so that walks (which visit every row
+ * of one column before the next column) read them in order.
+ * Rows are found through the position map when their index is
+ * below ONLP_SNMP_CONFIG_SENSOR_INDEX_SIZE.
+ */
+typedef struct sensor_snapshot_s {
+    struct sensor_snapshot_s *retired_next;
+    uint64_t retired_epoch;
+    uint64_t members_epoch;
+    int columns;
+    sensor_cell_t *cells;  /* [column-1][row] */
+    uint32_t positions;
+    int *position;         /* [index] = row + 1, 0 if no row */
+    int count;
+    sensor_row_t rows[];
+} sensor_snapshot_t;
 
 /* timestamp used to trigger sensor update */
 static uint64_t last_sensor_update_time;
 
-/* true if table restructuring is to happen;
- * set after all tables updated;
- * cleared after all tables restructured */
-static bool restructure_trigger;
+/* true if sensors are to be rediscovered on the next update;
+ * set at startup and when a sensor's presence changes */
+static bool discovery_trigger = true;
+
+/* timestamp of the last sensor discovery */
+static uint64_t last_sensor_discovery_time;
 
 /* updates happen in this pthread */
 static pthread_t update_thread_handle;
@@ -107,9 +128,9 @@ static pthread_t update_thread_handle;
 /**
  * NET SNMP handler
  */
-typedef void (*onlp_snmp_handler_fn)(netsnmp_request_info *req,
+typedef void (*onlp_snmp_handler_fn)(sensor_cell_t *cell,
                                      uint32_t index,
-                                     onlp_snmp_sensor_t *ss);
+                                     const sensor_row_t *ss);
 /**
  * Update handler
  */
@@ -122,6 +143,8 @@ typedef int (*update_handler_fn)(onlp_snmp_sensor_t *ss);
 typedef struct onlp_snmp_sensor_ctrl_s {
     char name[20];
     list_head_t sensors;
+    /* sensors indexed by OID id */
+    onlp_snmp_sensor_t *by_id[ONLP_SNMP_CONFIG_SENSOR_INDEX_SIZE];
 } onlp_snmp_sensor_ctrl_t;
 
 static onlp_snmp_sensor_ctrl_t sensor_ctrls__[ONLP_SNMP_SENSOR_TYPE_MAX+1];
@@ -134,24 +157,170 @@ get_sensor_ctrl__(int sensor_type)
 }
 
 
+static onlp_snmp_sensor_t *
+find_sensor__(onlp_snmp_sensor_ctrl_t *ctrl, int sensor_id)
+{
+    list_links_t *curr;
+    onlp_snmp_sensor_t *ss;
+    uint32_t id = ONLP_OID_ID_GET(sensor_id);
+
+    if (id < AIM_ARRAYSIZE(ctrl->by_id)) {
+        ss = ctrl->by_id[id];
+        return (ss && ss->sensor_id == sensor_id)? ss: NULL;
+    }
+
+    LIST_FOREACH(&ctrl->sensors, curr) {
+        ss = container_of(curr, links, onlp_snmp_sensor_t);
+        if (ss->sensor_id == sensor_id) {
+            return ss;
+        }
+    }
+    return NULL;
+}
+
+static void
+index_sensor__(onlp_snmp_sensor_ctrl_t *ctrl, onlp_snmp_sensor_t *ss,
+               onlp_snmp_sensor_t *value)
+{
+    uint32_t id = ONLP_OID_ID_GET(ss->sensor_id);
+    if (id < AIM_ARRAYSIZE(ctrl->by_id)) {
+        ctrl->by_id[id] = value;
+    }
+}
+
+
+/*
+ * Snapshot publication.
+ *
+ * The update thread publishes a new snapshot of every table after
+ * each update, and never waits for the snmp agent. The agent thread,
+ * the only reader, accesses the published snapshots between
+ * snapshot_read_begin__ and snapshot_read_end__, which record the
+ * publication epoch seen on entry. A replaced snapshot is retired
+ * with the epoch of its replacement, and freed by the update thread
+ * once the agent is outside a read section or entered it at that
+ * epoch or later.
+ */
+static sensor_snapshot_t *published__[ONLP_SNMP_SENSOR_TYPE_MAX+1];
+static uint64_t publish_epoch__ = 1;
+static uint64_t reader_epoch__;
+
+/* snapshots waiting to be freed; update thread only */
+static sensor_snapshot_t *retired__;
+
+static void
+snapshot_read_begin__(void)
+{
+    uint64_t epoch = __atomic_load_n(&publish_epoch__, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&reader_epoch__, epoch, __ATOMIC_SEQ_CST);
+}
+
+static void
+snapshot_read_end__(void)
+{
+    __atomic_store_n(&reader_epoch__, 0, __ATOMIC_RELEASE);
+}
+
+static const sensor_snapshot_t *
+snapshot_get__(int sensor_type)
+{
+    return __atomic_load_n(&published__[sensor_type], __ATOMIC_SEQ_CST);
+}
+
+/* returns the row of the given index, or -1 */
+static int
+snapshot_row__(const sensor_snapshot_t *snap, uint32_t index)
+{
+    int lo = 0;
+    int hi;
+
+    if (snap == NULL) {
+        return -1;
+    }
+    if (index < snap->positions) {
+        return snap->position[index] - 1;
+    }
+
+    hi = snap->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (snap->rows[mid].index < index) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return (lo < snap->count && snap->rows[lo].index == index)? lo: -1;
+}
+
+static void
+snapshot_free__(sensor_snapshot_t *snap)
+{
+    int i;
+
+    for (i = 0; i < snap->columns * snap->count; i++) {
+        aim_free(snap->cells[i].data);
+    }
+    aim_free(snap->cells);
+    aim_free(snap->position);
+    aim_free(snap);
+}
+
+static void
+snapshot_reclaim__(void)
+{
+    uint64_t reader = __atomic_load_n(&reader_epoch__, __ATOMIC_SEQ_CST);
+    sensor_snapshot_t **pp = &retired__;
+
+    while (*pp) {
+        sensor_snapshot_t *snap = *pp;
+        if (reader == 0 || reader >= snap->retired_epoch) {
+            *pp = snap->retired_next;
+            snapshot_free__(snap);
+        } else {
+            pp = &snap->retired_next;
+        }
+    }
+}
+
+static void
+snapshot_publish__(sensor_snapshot_t *snaps[])
+{
+    sensor_snapshot_t *old[ONLP_SNMP_SENSOR_TYPE_MAX+1];
+    uint64_t epoch;
+    int i;
+
+    for (i = ONLP_SNMP_SENSOR_TYPE_TEMP; i <= ONLP_SNMP_SENSOR_TYPE_MAX; i++) {
+        old[i] = published__[i];
+        __atomic_store_n(&published__[i], snaps[i], __ATOMIC_SEQ_CST);
+    }
+    epoch = __atomic_add_fetch(&publish_epoch__, 1, __ATOMIC_SEQ_CST);
+
+    for (i = ONLP_SNMP_SENSOR_TYPE_TEMP; i <= ONLP_SNMP_SENSOR_TYPE_MAX; i++) {
+        if (old[i]) {
+            old[i]->retired_epoch = epoch;
+            old[i]->retired_next = retired__;
+            retired__ = old[i];
+        }
+    }
+    snapshot_reclaim__();
+}
+
+
 /* for accessing netsnmp table info */
 static netsnmp_tdata *sensor_table__[ONLP_SNMP_SENSOR_TYPE_MAX+1];
 
 
-static void *
-delete_table_row__(netsnmp_tdata *table, uint32_t index)
+/* rows carry their index as their data */
+static uint32_t
+row_index__(netsnmp_tdata_row *row)
 {
-    /* the search oid is the index */
-    oid o[] = { index };
-    netsnmp_tdata_row *row = netsnmp_tdata_row_get_byoid(table,
-                                                         o, OID_LENGTH(o));
-    void *data = netsnmp_tdata_remove_and_delete_row(table, row);
-    return data;
+    return (uint32_t)(uintptr_t)row->data;
 }
 
 /* returns 0 if row is successfully populated, -1 if not */
 static int
-add_table_row__(netsnmp_tdata *table, onlp_snmp_sensor_t *ss)
+add_table_row__(netsnmp_tdata *table, const sensor_row_t *ss)
 {
     netsnmp_tdata_row *row = netsnmp_tdata_create_row();
     netsnmp_variable_list *varlist;
@@ -162,9 +331,8 @@ add_table_row__(netsnmp_tdata *table, onlp_snmp_sensor_t *ss)
         return -1;
     }
 
-    /* assign sensor info to row's private data pointer for later retrieval by
-     * the table's oid handlers */
-    row->data = ss;
+    /* the table's oid handlers look the row up in the current snapshot */
+    row->data = (void *)(uintptr_t)ss->index;
 
     varlist = netsnmp_tdata_row_add_index(row, ASN_INTEGER, &ss->index,
                                           sizeof(ss->index));
@@ -175,38 +343,70 @@ add_table_row__(netsnmp_tdata *table, onlp_snmp_sensor_t *ss)
     return 0;
 }
 
+static void
+cell_set_integer__(sensor_cell_t *cell, u_char type, long value)
+{
+    cell->type = type;
+    cell->integer = value;
+}
+
+static void
+cell_set_value__(sensor_cell_t *cell, u_char type,
+                 const void *value, size_t len)
+{
+    cell->type = type;
+    cell->data = aim_zmalloc(len + 1);
+    AIM_MEMCPY(cell->data, value, len);
+    cell->len = len;
+}
+
+/*
+ * Answers every varbind of the request batch from the cells of one
+ * snapshot, without per-column dispatch.
+ */
 static int
 table_handler__(netsnmp_mib_handler *handler,
                 netsnmp_handler_registration *reg_info,
                 netsnmp_agent_request_info *req_info,
                 netsnmp_request_info *requests,
-                onlp_snmp_handler_fn table_handler_fns[])
+                int sensor_type)
 {
     netsnmp_request_info *req;
+    const sensor_snapshot_t *snap;
 
     if (req_info->mode != MODE_GET && req_info->mode != MODE_GETNEXT) {
         return SNMP_ERR_NOERROR;
     }
 
+    /* all requests are answered from the same snapshot */
+    snapshot_read_begin__();
+    snap = snapshot_get__(sensor_type);
+
     for (req = requests; req; req = req->next) {
-        onlp_snmp_sensor_t *ss =
-            (onlp_snmp_sensor_t *) netsnmp_tdata_extract_entry(req);
+        netsnmp_tdata_row *row = netsnmp_tdata_extract_row(req);
         netsnmp_table_request_info *table_info =
             netsnmp_extract_table_info(req);
-        if (ss == NULL) {
+        int r = row? snapshot_row__(snap, row_index__(row)): -1;
+        const sensor_cell_t *cell;
+
+        if (r < 0 || table_info->colnum < 1 ||
+            table_info->colnum > snap->columns) {
             netsnmp_set_request_error(req_info, req, SNMP_NOSUCHINSTANCE);
             continue;
         }
 
-        if (table_handler_fns[table_info->colnum]) {
-            (*table_handler_fns[table_info->colnum])(req, table_info->colnum,
-                                                     ss);
-        } else {
-            netsnmp_set_request_error(req_info, req, SNMP_NOSUCHINSTANCE);
-            continue;
+        cell = &snap->cells[(table_info->colnum - 1) * snap->count + r];
+        if (cell->data) {
+            snmp_set_var_typed_value(req->requestvb, cell->type,
+                                     cell->data, cell->len);
+        } else if (cell->type) {
+            snmp_set_var_typed_integer(req->requestvb, cell->type,
+                                       cell->integer);
         }
     }
 
+    snapshot_read_end__();
+
     if (handler->next && handler->next->access_method) {
         return netsnmp_call_next_handler(handler, reg_info, req_info, requests);
     }
@@ -275,46 +475,46 @@ register_table__(char table_name[], oid table_oid[], size_t table_oid_len,
 static int
 temp_update_handler__(onlp_snmp_sensor_t *ss)
 {
-    onlp_thermal_info_t *ti = &get_next_info(ss)->data.ti;
+    onlp_thermal_info_t *ti = &ss->info.data.ti;
     onlp_oid_t oid = (onlp_oid_t) ss->sensor_id;
 
     return onlp_thermal_info_get(oid, ti);
 }
 
 static void
-temp_index_handler__(netsnmp_request_info *req,
+temp_index_handler__(sensor_cell_t *cell,
                      uint32_t index,
-                     onlp_snmp_sensor_t *ss)
+                     const sensor_row_t *ss)
 {
-    snmp_set_var_typed_integer(req->requestvb,
-                               ASN_INTEGER,
-                               ss->index);
+    cell_set_integer__(cell,
+                       ASN_INTEGER,
+                       ss->index);
 }
 
 static void
-temp_devname_handler__(netsnmp_request_info *req,
+temp_devname_handler__(sensor_cell_t *cell,
                        uint32_t index,
-                       onlp_snmp_sensor_t *ss)
+                       const sensor_row_t *ss)
 {
     char device_name[ONLP_SNMP_CONFIG_MAX_NAME_LENGTH+ONLP_SNMP_CONFIG_MAX_DESC_LENGTH + 32];
 
     snprintf(device_name,  sizeof(device_name),
              "%s %s%s", "Thermal", ss->name, ss->desc);
 
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_OCTET_STR,
-                             (u_char *) device_name,
-                             strlen(device_name));
+    cell_set_value__(cell,
+                     ASN_OCTET_STR,
+                     (u_char *) device_name,
+                     strlen(device_name));
 }
 
 static void
-temp_status_handler__(netsnmp_request_info *req,
+temp_status_handler__(sensor_cell_t *cell,
                       uint32_t index,
-                      onlp_snmp_sensor_t *ss)
+                      const sensor_row_t *ss)
 {
     int value;
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_thermal_info_t *ti = &si->data.ti;
+    const sensor_info_t *si = &ss->info;
+    const onlp_thermal_info_t *ti = &si->data.ti;
 
     if (!si->valid) {
         return;
@@ -328,19 +528,19 @@ temp_status_handler__(netsnmp_request_info *req,
         }
     }
 
-    snmp_set_var_typed_integer(req->requestvb,
-                               ASN_INTEGER,
-                               value);
+    cell_set_integer__(cell,
+                       ASN_INTEGER,
+                       value);
 }
 
 static void
-temp_value_handler__(netsnmp_request_info *req,
+temp_value_handler__(sensor_cell_t *cell,
                      uint32_t index,
-                     onlp_snmp_sensor_t *ss)
+                     const sensor_row_t *ss)
 {
     int value;
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_thermal_info_t *ti = &si->data.ti;
+    const sensor_info_t *si = &ss->info;
+    const onlp_thermal_info_t *ti = &si->data.ti;
 
     if (!si->valid) {
         return;
@@ -348,10 +548,10 @@ temp_value_handler__(netsnmp_request_info *req,
 
     value = (ti->status & ONLP_THERMAL_STATUS_PRESENT)? ti->mcelsius: 0;
 
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_GAUGE,
-                             (u_char *) &value,
-                             sizeof(value));
+    cell_set_value__(cell,
+                     ASN_GAUGE,
+                     (u_char *) &value,
+                     sizeof(value));
 }
 
 static onlp_snmp_handler_fn temp_handler_fn__[] = {
@@ -369,7 +569,7 @@ temp_table_handler__(netsnmp_mib_handler *handler,
                      netsnmp_request_info *requests)
 {
     return table_handler__(handler, reg, agent_req, requests,
-                           temp_handler_fn__);
+                           ONLP_SNMP_SENSOR_TYPE_TEMP);
 }
 
 
@@ -379,46 +579,46 @@ temp_table_handler__(netsnmp_mib_handler *handler,
 static int
 fan_update_handler__(onlp_snmp_sensor_t *ss)
 {
-    onlp_fan_info_t *fi = &get_next_info(ss)->data.fi;
+    onlp_fan_info_t *fi = &ss->info.data.fi;
     onlp_oid_t oid = (onlp_oid_t) ss->sensor_id;
 
     return onlp_fan_info_get(oid, fi);
 }
 
 static void
-fan_index_handler__(netsnmp_request_info *req,
+fan_index_handler__(sensor_cell_t *cell,
                     uint32_t index,
-                    onlp_snmp_sensor_t *ss)
+                    const sensor_row_t *ss)
 {
-    snmp_set_var_typed_integer(req->requestvb,
-                               ASN_INTEGER,
-                               ss->index);
+    cell_set_integer__(cell,
+                       ASN_INTEGER,
+                       ss->index);
 }
 
 static void
-fan_devname_handler__(netsnmp_request_info *req,
+fan_devname_handler__(sensor_cell_t *cell,
                       uint32_t index,
-                      onlp_snmp_sensor_t *ss)
+                      const sensor_row_t *ss)
 {
     char device_name[ONLP_SNMP_CONFIG_MAX_NAME_LENGTH+ONLP_SNMP_CONFIG_MAX_DESC_LENGTH + 32];
     snprintf(device_name,  sizeof(device_name),
              "%s %s%s", "Fan", ss->name, ss->desc);
 
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_OCTET_STR,
-                             (u_char *) device_name,
-                             strlen(device_name));
+    cell_set_value__(cell,
+                     ASN_OCTET_STR,
+                     (u_char *) device_name,
+                     strlen(device_name));
 }
 
 
 static void
-fan_status_handler__(netsnmp_request_info *req,
+fan_status_handler__(sensor_cell_t *cell,
                      uint32_t index,
-                     onlp_snmp_sensor_t *ss)
+                     const sensor_row_t *ss)
 {
     int value;
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_fan_info_t *fi = &si->data.fi;
+    const sensor_info_t *si = &ss->info;
+    const onlp_fan_info_t *fi = &si->data.fi;
 
     if (!si->valid) {
         return;
@@ -432,19 +632,19 @@ fan_status_handler__(netsnmp_request_info *req,
         }
     }
 
-    snmp_set_var_typed_integer(req->requestvb,
-                               ASN_INTEGER,
-                               value);
+    cell_set_integer__(cell,
+                       ASN_INTEGER,
+                       value);
 }
 
 static void
-fan_flow_type_handler__(netsnmp_request_info *req,
+fan_flow_type_handler__(sensor_cell_t *cell,
                         uint32_t index,
-                        onlp_snmp_sensor_t *ss)
+                        const sensor_row_t *ss)
 {
     int name_index;
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_fan_info_t *fi = &si->data.fi;
+    const sensor_info_t *si = &ss->info;
+    const onlp_fan_info_t *fi = &si->data.fi;
 
     if (!si->valid) {
         return;
@@ -463,19 +663,19 @@ fan_flow_type_handler__(netsnmp_request_info *req,
     }
 
     const char* s = onlp_snmp_fan_flow_type_name(name_index);
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_OCTET_STR,
-                             (u_char*)s, strlen(s));
+    cell_set_value__(cell,
+                     ASN_OCTET_STR,
+                     (u_char*)s, strlen(s));
 }
 
 static void
-fan_rpm_handler__(netsnmp_request_info *req,
+fan_rpm_handler__(sensor_cell_t *cell,
                   uint32_t index,
-                  onlp_snmp_sensor_t *ss)
+                  const sensor_row_t *ss)
 {
     int value;
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_fan_info_t *fi = &si->data.fi;
+    const sensor_info_t *si = &ss->info;
+    const onlp_fan_info_t *fi = &si->data.fi;
 
     if (!si->valid) {
         return;
@@ -483,20 +683,20 @@ fan_rpm_handler__(netsnmp_request_info *req,
 
     value = (fi->status & ONLP_FAN_STATUS_PRESENT)? fi->rpm: 0;
 
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_GAUGE,
-                             (u_char *) &value,
-                             sizeof(value));
+    cell_set_value__(cell,
+                     ASN_GAUGE,
+                     (u_char *) &value,
+                     sizeof(value));
 }
 
 static void
-fan_pct_handler__(netsnmp_request_info *req,
+fan_pct_handler__(sensor_cell_t *cell,
                   uint32_t index,
-                  onlp_snmp_sensor_t *ss)
+                  const sensor_row_t *ss)
 {
     int value;
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_fan_info_t *fi = &si->data.fi;
+    const sensor_info_t *si = &ss->info;
+    const onlp_fan_info_t *fi = &si->data.fi;
 
     if (!si->valid) {
         return;
@@ -504,19 +704,19 @@ fan_pct_handler__(netsnmp_request_info *req,
 
     value = (fi->status & ONLP_FAN_STATUS_PRESENT)? fi->percentage: 0;
 
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_GAUGE,
-                             (u_char *) &value,
-                             sizeof(value));
+    cell_set_value__(cell,
+                     ASN_GAUGE,
+                     (u_char *) &value,
+                     sizeof(value));
 }
 
 static void
-fan_model_handler__(netsnmp_request_info *req,
+fan_model_handler__(sensor_cell_t *cell,
                     uint32_t index,
-                    onlp_snmp_sensor_t *ss)
+                    const sensor_row_t *ss)
 {
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_fan_info_t *fi = &si->data.fi;
+    const sensor_info_t *si = &ss->info;
+    const onlp_fan_info_t *fi = &si->data.fi;
 
     if (!si->valid) {
         return;
@@ -524,19 +724,19 @@ fan_model_handler__(netsnmp_request_info *req,
 
     int len = (fi->status & ONLP_FAN_STATUS_PRESENT)? strlen(fi->model): 0;
 
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_OCTET_STR,
-                             (u_char *) fi->model,
-                             len);
+    cell_set_value__(cell,
+                     ASN_OCTET_STR,
+                     (u_char *) fi->model,
+                     len);
 }
 
 static void
-fan_serial_handler__(netsnmp_request_info *req,
+fan_serial_handler__(sensor_cell_t *cell,
                      uint32_t index,
-                     onlp_snmp_sensor_t *ss)
+                     const sensor_row_t *ss)
 {
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_fan_info_t *fi = &si->data.fi;
+    const sensor_info_t *si = &ss->info;
+    const onlp_fan_info_t *fi = &si->data.fi;
 
     if (!si->valid) {
         return;
@@ -544,10 +744,10 @@ fan_serial_handler__(netsnmp_request_info *req,
 
     int len = (fi->status & ONLP_FAN_STATUS_PRESENT)? strlen(fi->serial): 0;
 
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_OCTET_STR,
-                             (u_char *) fi->serial,
-                             len);
+    cell_set_value__(cell,
+                     ASN_OCTET_STR,
+                     (u_char *) fi->serial,
+                     len);
 }
 
 static onlp_snmp_handler_fn fan_handler_fn__[] = {
@@ -569,7 +769,7 @@ fan_table_handler__(netsnmp_mib_handler *handler,
                     netsnmp_request_info *requests)
 {
     return table_handler__(handler, reg, agent_req, requests,
-                           fan_handler_fn__);
+                           ONLP_SNMP_SENSOR_TYPE_FAN);
 }
 
 
@@ -579,45 +779,45 @@ fan_table_handler__(netsnmp_mib_handler *handler,
 static int
 psu_update_handler__(onlp_snmp_sensor_t *ss)
 {
-    onlp_psu_info_t *pi = &get_next_info(ss)->data.pi;
+    onlp_psu_info_t *pi = &ss->info.data.pi;
     onlp_oid_t oid = (onlp_oid_t) ss->sensor_id;
 
     return onlp_psu_info_get(oid, pi);
 }
 
 static void
-psu_index_handler__(netsnmp_request_info *req,
+psu_index_handler__(sensor_cell_t *cell,
                     uint32_t index,
-                    onlp_snmp_sensor_t *ss)
+                    const sensor_row_t *ss)
 {
-    snmp_set_var_typed_integer(req->requestvb,
-                               ASN_INTEGER,
-                               ss->index);
+    cell_set_integer__(cell,
+                       ASN_INTEGER,
+                       ss->index);
 }
 
 static void
-psu_devname_handler__(netsnmp_request_info *req,
+psu_devname_handler__(sensor_cell_t *cell,
                       uint32_t index,
-                      onlp_snmp_sensor_t *ss)
+                      const sensor_row_t *ss)
 {
     char device_name[ONLP_SNMP_CONFIG_MAX_NAME_LENGTH+ONLP_SNMP_CONFIG_MAX_DESC_LENGTH + 32];
     snprintf(device_name,  sizeof(device_name),
              "%s %s%s", "PSU", ss->name, ss->desc);
 
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_OCTET_STR,
-                             (u_char *) device_name,
-                             strlen(device_name));
+    cell_set_value__(cell,
+                     ASN_OCTET_STR,
+                     (u_char *) device_name,
+                     strlen(device_name));
 }
 
 static void
-psu_status_handler__(netsnmp_request_info *req,
+psu_status_handler__(sensor_cell_t *cell,
                      uint32_t index,
-                     onlp_snmp_sensor_t *ss )
+                     const sensor_row_t *ss)
 {
     int value;
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_psu_info_t *pi = &si->data.pi;
+    const sensor_info_t *si = &ss->info;
+    const onlp_psu_info_t *pi = &si->data.pi;
 
     if (!si->valid) {
         return;
@@ -639,19 +839,19 @@ psu_status_handler__(netsnmp_request_info *req,
 
     }
 
-    snmp_set_var_typed_integer(req->requestvb,
-                               ASN_INTEGER,
-                               value);
+    cell_set_integer__(cell,
+                       ASN_INTEGER,
+                       value);
 }
 
 static void
-psu_current_type_handler__(netsnmp_request_info *req,
+psu_current_type_handler__(sensor_cell_t *cell,
                            uint32_t index,
-                           onlp_snmp_sensor_t *ss )
+                           const sensor_row_t *ss)
 {
     int name_index;
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_psu_info_t *pi = &si->data.pi;
+    const sensor_info_t *si = &ss->info;
+    const onlp_psu_info_t *pi = &si->data.pi;
 
     if (!si->valid) {
         return;
@@ -670,18 +870,18 @@ psu_current_type_handler__(netsnmp_request_info *req,
     }
 
     const char* s = onlp_snmp_psu_type_name(name_index);
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_OCTET_STR,
-                             (u_char *) s, strlen(s));
+    cell_set_value__(cell,
+                     ASN_OCTET_STR,
+                     (u_char *) s, strlen(s));
 }
 
 static void
-psu_model_handler__(netsnmp_request_info *req,
+psu_model_handler__(sensor_cell_t *cell,
                     uint32_t index,
-                    onlp_snmp_sensor_t *ss)
+                    const sensor_row_t *ss)
 {
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_psu_info_t *pi = &si->data.pi;
+    const sensor_info_t *si = &ss->info;
+    const onlp_psu_info_t *pi = &si->data.pi;
 
     if (!si->valid) {
         return;
@@ -689,19 +889,19 @@ psu_model_handler__(netsnmp_request_info *req,
 
     int len = (pi->status & ONLP_PSU_STATUS_PRESENT)? strlen(pi->model): 0;
 
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_OCTET_STR,
-                             (u_char *) pi->model,
-                             len);
+    cell_set_value__(cell,
+                     ASN_OCTET_STR,
+                     (u_char *) pi->model,
+                     len);
 }
 
 static void
-psu_serial_handler__(netsnmp_request_info *req,
+psu_serial_handler__(sensor_cell_t *cell,
                      uint32_t index,
-                     onlp_snmp_sensor_t *ss)
+                     const sensor_row_t *ss)
 {
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_psu_info_t *pi = &si->data.pi;
+    const sensor_info_t *si = &ss->info;
+    const onlp_psu_info_t *pi = &si->data.pi;
 
     if (!si->valid) {
         return;
@@ -709,20 +909,20 @@ psu_serial_handler__(netsnmp_request_info *req,
 
     int len = (pi->status & ONLP_PSU_STATUS_PRESENT)? strlen(pi->serial): 0;
 
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_OCTET_STR,
-                             (u_char *) pi->serial,
-                             len);
+    cell_set_value__(cell,
+                     ASN_OCTET_STR,
+                     (u_char *) pi->serial,
+                     len);
 }
 
 static void
-psu_vin_handler__(netsnmp_request_info *req,
+psu_vin_handler__(sensor_cell_t *cell,
                   uint32_t index,
-                  onlp_snmp_sensor_t *ss )
+                  const sensor_row_t *ss)
 {
     int value;
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_psu_info_t *pi = &si->data.pi;
+    const sensor_info_t *si = &ss->info;
+    const onlp_psu_info_t *pi = &si->data.pi;
 
     if (!si->valid) {
         return;
@@ -730,20 +930,20 @@ psu_vin_handler__(netsnmp_request_info *req,
 
     value = (pi->status & ONLP_PSU_STATUS_PRESENT)? pi->mvin: 0;
 
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_GAUGE,
-                             (u_char *) &value,
-                             sizeof(value));
+    cell_set_value__(cell,
+                     ASN_GAUGE,
+                     (u_char *) &value,
+                     sizeof(value));
 }
 
 static void
-psu_vout_handler__(netsnmp_request_info *req,
+psu_vout_handler__(sensor_cell_t *cell,
                    uint32_t index,
-                   onlp_snmp_sensor_t *ss )
+                   const sensor_row_t *ss)
 {
     int value;
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_psu_info_t *pi = &si->data.pi;
+    const sensor_info_t *si = &ss->info;
+    const onlp_psu_info_t *pi = &si->data.pi;
 
     if (!si->valid) {
         return;
@@ -751,20 +951,20 @@ psu_vout_handler__(netsnmp_request_info *req,
 
     value = (pi->status & ONLP_PSU_STATUS_PRESENT)? pi->mvout: 0;
 
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_GAUGE,
-                             (u_char *) &value,
-                             sizeof(value));
+    cell_set_value__(cell,
+                     ASN_GAUGE,
+                     (u_char *) &value,
+                     sizeof(value));
 }
 
 static void
-psu_iin_handler__(netsnmp_request_info *req,
+psu_iin_handler__(sensor_cell_t *cell,
                   uint32_t index,
-                  onlp_snmp_sensor_t *ss )
+                  const sensor_row_t *ss)
 {
     int value;
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_psu_info_t *pi = &si->data.pi;
+    const sensor_info_t *si = &ss->info;
+    const onlp_psu_info_t *pi = &si->data.pi;
 
     if (!si->valid) {
         return;
@@ -772,20 +972,20 @@ psu_iin_handler__(netsnmp_request_info *req,
 
     value = (pi->status & ONLP_PSU_STATUS_PRESENT)? pi->miin: 0;
 
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_GAUGE,
-                             (u_char *) &value,
-                             sizeof(value));
+    cell_set_value__(cell,
+                     ASN_GAUGE,
+                     (u_char *) &value,
+                     sizeof(value));
 }
 
 static void
-psu_iout_handler__(netsnmp_request_info *req,
+psu_iout_handler__(sensor_cell_t *cell,
                    uint32_t index,
-                   onlp_snmp_sensor_t *ss )
+                   const sensor_row_t *ss)
 {
     int value;
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_psu_info_t *pi = &si->data.pi;
+    const sensor_info_t *si = &ss->info;
+    const onlp_psu_info_t *pi = &si->data.pi;
 
     if (!si->valid) {
         return;
@@ -793,20 +993,20 @@ psu_iout_handler__(netsnmp_request_info *req,
 
     value = (pi->status & ONLP_PSU_STATUS_PRESENT)? pi->miout: 0;
 
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_GAUGE,
-                             (u_char *) &value,
-                             sizeof(value));
+    cell_set_value__(cell,
+                     ASN_GAUGE,
+                     (u_char *) &value,
+                     sizeof(value));
 }
 
 static void
-psu_pin_handler__(netsnmp_request_info *req,
+psu_pin_handler__(sensor_cell_t *cell,
                   uint32_t index,
-                  onlp_snmp_sensor_t *ss )
+                  const sensor_row_t *ss)
 {
     int value;
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_psu_info_t *pi = &si->data.pi;
+    const sensor_info_t *si = &ss->info;
+    const onlp_psu_info_t *pi = &si->data.pi;
 
     if (!si->valid) {
         return;
@@ -814,20 +1014,20 @@ psu_pin_handler__(netsnmp_request_info *req,
 
     value = (pi->status & ONLP_PSU_STATUS_PRESENT)? pi->mpin: 0;
 
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_GAUGE,
-                             (u_char *) &value,
-                             sizeof(value));
+    cell_set_value__(cell,
+                     ASN_GAUGE,
+                     (u_char *) &value,
+                     sizeof(value));
 }
 
 static void
-psu_pout_handler__(netsnmp_request_info *req,
+psu_pout_handler__(sensor_cell_t *cell,
                    uint32_t index,
-                   onlp_snmp_sensor_t *ss )
+                   const sensor_row_t *ss)
 {
     int value;
-    sensor_info_t *si = get_curr_info(ss);
-    onlp_psu_info_t *pi = &si->data.pi;
+    const sensor_info_t *si = &ss->info;
+    const onlp_psu_info_t *pi = &si->data.pi;
 
     if (!si->valid) {
         return;
@@ -835,10 +1035,10 @@ psu_pout_handler__(netsnmp_request_info *req,
 
     value = (pi->status & ONLP_PSU_STATUS_PRESENT)? pi->mpout: 0;
 
-    snmp_set_var_typed_value(req->requestvb,
-                             ASN_GAUGE,
-                             (u_char *) &value,
-                             sizeof(value));
+    cell_set_value__(cell,
+                     ASN_GAUGE,
+                     (u_char *) &value,
+                     sizeof(value));
 }
 
 
@@ -865,7 +1065,7 @@ psu_table_handler__(netsnmp_mib_handler *handler,
                     netsnmp_request_info *requests)
 {
     return table_handler__(handler, reg, agent_req, requests,
-                           psu_handler_fn__);
+                           ONLP_SNMP_SENSOR_TYPE_PSU);
 }
 
 
@@ -879,16 +1079,47 @@ static update_handler_fn all_update_handler_fns__[] = {
     psu_update_handler__,
 };
 
+/*
+ * All column handlers
+ */
+static struct {
+    onlp_snmp_handler_fn *fns;
+    int count;
+} all_handler_fns__[] = {
+    { NULL, 0 },
+    { temp_handler_fn__, AIM_ARRAYSIZE(temp_handler_fn__) },
+    { fan_handler_fn__,  AIM_ARRAYSIZE(fan_handler_fn__) },
+    { psu_handler_fn__,  AIM_ARRAYSIZE(psu_handler_fn__) },
+};
+
 
 /*
- * Add a sensor to the appropriate type-specific control structure.
- * Updates next sensor info, not current sensor info.
+ * Returns true if the sensor info reports the sensor present.
+ */
+static bool
+sensor_present__(int sensor_type, sensor_info_t *si)
+{
+    switch (sensor_type) {
+    case ONLP_SNMP_SENSOR_TYPE_TEMP:
+        return (si->data.ti.status & ONLP_THERMAL_STATUS_PRESENT) != 0;
+    case ONLP_SNMP_SENSOR_TYPE_FAN:
+        return (si->data.fi.status & ONLP_FAN_STATUS_PRESENT) != 0;
+    case ONLP_SNMP_SENSOR_TYPE_PSU:
+        return (si->data.pi.status & ONLP_PSU_STATUS_PRESENT) != 0;
+    default:
+        return false;
+    }
+}
+
+
+/*
+ * Add a sensor to the appropriate type-specific control structure,
+ * or mark an existing sensor as discovered.
  */
 static void
 add_sensor__(int sensor_type, onlp_snmp_sensor_t *new_sensor)
 {
     onlp_snmp_sensor_ctrl_t *ctrl = get_sensor_ctrl__(sensor_type);
-    list_links_t *curr;
     onlp_snmp_sensor_t *ss;
 
     /* We start with Base 1 */
@@ -897,24 +1128,22 @@ add_sensor__(int sensor_type, onlp_snmp_sensor_t *new_sensor)
     AIM_TRUE_OR_DIE(ctrl);
 
     /* check if the sensor already exists */
-    LIST_FOREACH(&ctrl->sensors, curr) {
-        ss = container_of(curr, links, onlp_snmp_sensor_t);
-        if (new_sensor->sensor_id == ss->sensor_id) {
-            /* no need to add sensor */
-            AIM_LOG_TRACE("skipping existing sensor %08x", ss->sensor_id);
-            get_next_info(ss)->valid = true;
-            return;
-        }
+    if ((ss = find_sensor__(ctrl, new_sensor->sensor_id)) != NULL) {
+        /* no need to add sensor */
+        AIM_LOG_TRACE("skipping existing sensor %08x", ss->sensor_id);
+        ss->discovered = true;
+        return;
     }
 
     ss = AIM_MALLOC(sizeof(onlp_snmp_sensor_t));
     AIM_TRUE_OR_DIE(ss);
     AIM_MEMCPY(ss, new_sensor, sizeof(*new_sensor));
     ss->sensor_type = sensor_type;
-    get_next_info(ss)->valid = true;
+    ss->discovered = true;
 
     /* finally add sensor */
     list_push(&ctrl->sensors, &ss->links);
+    index_sensor__(ctrl, ss, ss);
 }
 
 
@@ -972,13 +1201,114 @@ collect_sensors__(onlp_oid_t oid, void* cookie)
 }
 
 
+static int
+row_compare__(const void *a, const void *b)
+{
+    uint32_t ia = ((const sensor_row_t *)a)->index;
+    uint32_t ib = ((const sensor_row_t *)b)->index;
+    return (ia > ib) - (ia < ib);
+}
+
+/*
+ * Build a snapshot of the valid sensors of one type.
+ * Rows added or removed since the previously published snapshot
+ * give the new snapshot a new members_epoch.
+ */
+static sensor_snapshot_t *
+snapshot_build__(int sensor_type, uint64_t epoch)
+{
+    onlp_snmp_sensor_ctrl_t *ctrl = get_sensor_ctrl__(sensor_type);
+    const sensor_snapshot_t *prev = published__[sensor_type];
+    sensor_snapshot_t *snap;
+    list_links_t *curr;
+    onlp_snmp_sensor_t *ss;
+    onlp_snmp_handler_fn *fns;
+    int prev_count = prev? prev->count: 0;
+    int count = 0;
+    int changes = 0;
+    int a, b, c, r;
+
+    LIST_FOREACH(&ctrl->sensors, curr) {
+        ss = container_of(curr, links, onlp_snmp_sensor_t);
+        if (ss->info.valid) {
+            count++;
+        }
+    }
+
+    snap = aim_zmalloc(sizeof(*snap) + count * sizeof(sensor_row_t));
+    LIST_FOREACH(&ctrl->sensors, curr) {
+        ss = container_of(curr, links, onlp_snmp_sensor_t);
+        if (ss->info.valid) {
+            sensor_row_t *row = &snap->rows[snap->count++];
+            row->sensor_id = ss->sensor_id;
+            row->index = ss->index;
+            aim_strlcpy(row->name, ss->name, sizeof(row->name));
+            aim_strlcpy(row->desc, ss->desc, sizeof(row->desc));
+            row->info = ss->info;
+        }
+    }
+    qsort(snap->rows, snap->count, sizeof(sensor_row_t), row_compare__);
+
+    /* map indexes to rows */
+    if (count && snap->rows[count-1].index < ONLP_SNMP_CONFIG_SENSOR_INDEX_SIZE) {
+        snap->positions = snap->rows[count-1].index + 1;
+        snap->position = aim_zmalloc(snap->positions * sizeof(int));
+        for (r = 0; r < count; r++) {
+            snap->position[snap->rows[r].index] = r + 1;
+        }
+    }
+
+    /* encode the cells, column by column */
+    fns = all_handler_fns__[sensor_type].fns;
+    snap->columns = all_handler_fns__[sensor_type].count - 1;
+    snap->cells = aim_zmalloc((snap->columns * count + 1) *
+                              sizeof(sensor_cell_t));
+    for (c = 1; c <= snap->columns; c++) {
+        for (r = 0; r < count; r++) {
+            (*fns[c])(&snap->cells[(c - 1) * count + r], c, &snap->rows[r]);
+        }
+    }
+
+    /* diff against the previous snapshot */
+    a = 0;
+    b = 0;
+    while (a < prev_count || b < snap->count) {
+        if (b == snap->count ||
+            (a < prev_count && prev->rows[a].index < snap->rows[b].index)) {
+            AIM_LOG_INFO("remove %s%s from %s",
+                         prev->rows[a].name, prev->rows[a].desc, ctrl->name);
+            a++;
+            changes++;
+        } else if (a == prev_count ||
+                   snap->rows[b].index < prev->rows[a].index) {
+            AIM_LOG_INFO("add %s%s to %s",
+                         snap->rows[b].name, snap->rows[b].desc, ctrl->name);
+            b++;
+            changes++;
+        } else {
+            a++;
+            b++;
+        }
+    }
+    snap->members_epoch = (prev && !changes)? prev->members_epoch: epoch;
+
+    return snap;
+}
+
+
 /*
  * sensor table is updated in two parts:
  * 1. sensor update, performed in separate thread by calling update_tables__.
- *    once update is complete, front-back buffers will be switched
- *    and flag set to indicate table restructuring can occur
+ *    once update is complete, a snapshot of each table is published.
  * 2. sensor table restructuring, performed in snmp callback
- *    by calling restructure_tables__.
+ *    by calling restructure_tables__, when the published rows change.
+ * the handlers always read the values from the published snapshot,
+ * so updates are never held back by restructuring.
+ *
+ * the OID tree is only walked to discover sensors at startup,
+ * after a sensor's presence changes or its update fails,
+ * and every ONLP_SNMP_CONFIG_DISCOVERY_PERIOD seconds.
+ * other updates only refresh the known sensors.
  */
 
 static void
@@ -987,7 +1317,13 @@ update_tables__(void)
     int i;
     onlp_snmp_sensor_ctrl_t *ctrl;
     list_links_t *curr;
+    list_links_t *next;
     onlp_snmp_sensor_t *ss;
+    sensor_snapshot_t *snaps[ONLP_SNMP_SENSOR_TYPE_MAX+1] = { NULL };
+    bool discover;
+    bool was_valid;
+    bool was_present;
+    uint64_t epoch;
 
     uint64_t now = aim_time_monotonic();
     if (now - last_sensor_update_time <
@@ -995,49 +1331,112 @@ update_tables__(void)
         return;
     }
 
-    if (restructure_trigger) {
-        AIM_LOG_INFO("restructure has not happened, skip sensor update");
-        return;
-    }
-
     last_sensor_update_time = now;
     AIM_LOG_TRACE("update sensor objects");
 
-    /* for each table: mark next_info invalid */
-    for (i = ONLP_SNMP_SENSOR_TYPE_TEMP; i <= ONLP_SNMP_SENSOR_TYPE_MAX; i++) {
-        ctrl = get_sensor_ctrl__(i);
-        LIST_FOREACH(&ctrl->sensors, curr) {
-            ss = container_of(curr, links, onlp_snmp_sensor_t);
-            get_next_info(ss)->valid = false;
+    if (ONLP_SNMP_CONFIG_DISCOVERY_PERIOD &&
+        now - last_sensor_discovery_time >=
+        (ONLP_SNMP_CONFIG_DISCOVERY_PERIOD * 1000 * 1000)) {
+        discovery_trigger = true;
+    }
+    discover = discovery_trigger;
+
+    if (discover) {
+        /* discover sensors for all tables,
+         * marking the sensors which are still present */
+        AIM_LOG_TRACE("discover sensor objects");
+        discovery_trigger = false;
+        last_sensor_discovery_time = now;
+        for (i = ONLP_SNMP_SENSOR_TYPE_TEMP; i <= ONLP_SNMP_SENSOR_TYPE_MAX; i++) {
+            ctrl = get_sensor_ctrl__(i);
+            LIST_FOREACH(&ctrl->sensors, curr) {
+                ss = container_of(curr, links, onlp_snmp_sensor_t);
+                ss->discovered = false;
+            }
         }
+        onlp_oid_iterate(ONLP_OID_SYS, 0, collect_sensors__, NULL);
     }
 
-    /* discover new sensors for all tables,
-     * writing validity into next_info for all sensors */
-    onlp_oid_iterate(ONLP_OID_SYS, 0, collect_sensors__, NULL);
-
-    /* for each table: update all sensor info */
+    /* for each table: drop sensors which are gone, update all others */
     for (i = ONLP_SNMP_SENSOR_TYPE_TEMP; i <= ONLP_SNMP_SENSOR_TYPE_MAX; i++) {
         ctrl = get_sensor_ctrl__(i);
-        LIST_FOREACH(&ctrl->sensors, curr) {
+        LIST_FOREACH_SAFE(&ctrl->sensors, curr, next) {
             ss = container_of(curr, links, onlp_snmp_sensor_t);
-            if (get_next_info(ss)->valid) {
-                AIM_LOG_INFO("update sensor %s%s", ss->name, ss->desc);
-                /* invoke update handler */
-                if ((*all_update_handler_fns__[i])(ss) != ONLP_STATUS_OK) {
-                    AIM_LOG_ERROR("failed to update %s%s", ss->name, ss->desc);
-                    get_next_info(ss)->valid = false;
+            if (!ss->discovered) {
+                AIM_LOG_INFO("sensor %s%s is gone", ss->name, ss->desc);
+                index_sensor__(ctrl, ss, NULL);
+                list_remove(curr);
+                aim_free(ss);
+                continue;
+            }
+
+            was_valid = ss->info.valid;
+            was_present = was_valid && sensor_present__(i, &ss->info);
+
+            AIM_LOG_INFO("update sensor %s%s", ss->name, ss->desc);
+            /* invoke update handler */
+            if ((*all_update_handler_fns__[i])(ss) != ONLP_STATUS_OK) {
+                AIM_LOG_ERROR("failed to update %s%s", ss->name, ss->desc);
+                ss->info.valid = false;
+                discovery_trigger = true;
+            } else {
+                ss->info.valid = true;
+                if (was_valid && was_present != sensor_present__(i, &ss->info)) {
+                    /* sensors may have been added or removed with it */
+                    AIM_LOG_INFO("presence of %s%s changed", ss->name, ss->desc);
+                    discovery_trigger = true;
                 }
             }
         }
     }
 
-    /* swap front and back buffers */
-    swap_curr_next_info();
+    /* publish a snapshot of each registered table */
+    epoch = __atomic_load_n(&publish_epoch__, __ATOMIC_RELAXED) + 1;
+    for (i = ONLP_SNMP_SENSOR_TYPE_TEMP; i <= ONLP_SNMP_SENSOR_TYPE_MAX; i++) {
+        if (sensor_table__[i]) {
+            snaps[i] = snapshot_build__(i, epoch);
+        }
+    }
+    AIM_LOG_TRACE("publish sensor snapshots");
+    snapshot_publish__(snaps);
+}
 
-    /* trigger table restructuring */
-    AIM_LOG_TRACE("trigger restructure");
-    restructure_trigger = true;
+/*
+ * adds or removes rows from one sensor table to match the rows
+ * of a snapshot. both are sorted by index.
+ */
+static void
+restructure_table__(int sensor_type, const sensor_snapshot_t *snap)
+{
+    netsnmp_tdata *table = sensor_table__[sensor_type];
+    onlp_snmp_sensor_ctrl_t *ctrl = get_sensor_ctrl__(sensor_type);
+    netsnmp_tdata_row *row = netsnmp_tdata_row_first(table);
+    netsnmp_tdata_row *next;
+    int i = 0;
+
+    while (row || i < snap->count) {
+        if (row && (i == snap->count ||
+                    row_index__(row) < snap->rows[i].index)) {
+            snmp_log(LOG_INFO, "Deleting %s row %u",
+                     ctrl->name, row_index__(row));
+            AIM_LOG_INFO("delete row %d from %s",
+                         row_index__(row), ctrl->name);
+            next = netsnmp_tdata_row_next(table, row);
+            netsnmp_tdata_remove_and_delete_row(table, row);
+            row = next;
+        } else if (!row || snap->rows[i].index < row_index__(row)) {
+            const sensor_row_t *ss = &snap->rows[i];
+            snmp_log(LOG_INFO, "Adding %s%s, id=%08x",
+                     ss->name, ss->desc, ss->sensor_id);
+            AIM_LOG_INFO("add row %d to %s for %s%s",
+                         ss->index, ctrl->name, ss->name, ss->desc);
+            add_table_row__(table, ss);
+            i++;
+        } else {
+            row = netsnmp_tdata_row_next(table, row);
+            i++;
+        }
+    }
 }
 
 /*
@@ -1049,48 +1448,25 @@ update_tables__(void)
 static void
 restructure_tables__(unsigned int reg, void *clientarg)
 {
+    /* members_epoch of the snapshot each table's rows match */
+    static uint64_t restructured_epoch__[ONLP_SNMP_SENSOR_TYPE_MAX+1];
+    const sensor_snapshot_t *snap;
     int i;
-    onlp_snmp_sensor_ctrl_t *ctrl;
-    list_links_t *curr;
-    list_links_t *next;
-    onlp_snmp_sensor_t *ss;
-    bool previously_valid;
-    bool now_valid;
-
-    if (!restructure_trigger) {
-        return;
-    }
 
-    AIM_LOG_INFO("restructuring tables");
+    snapshot_read_begin__();
 
-    /* for each table: add or delete rows as necessary */
     for (i = ONLP_SNMP_SENSOR_TYPE_TEMP; i <= ONLP_SNMP_SENSOR_TYPE_MAX; i++) {
-        ctrl = get_sensor_ctrl__(i);
-        LIST_FOREACH_SAFE(&ctrl->sensors, curr, next) {
-            ss = container_of(curr, links, onlp_snmp_sensor_t);
-            previously_valid = get_next_info(ss)->valid;
-            now_valid = get_curr_info(ss)->valid;
-            if (!previously_valid && now_valid) {
-                snmp_log(LOG_INFO, "Adding %s%s, id=%08x",
-                         ss->name, ss->desc, ss->sensor_id);
-                AIM_LOG_INFO("add row %d to %s for %s%s",
-                                ss->index, ctrl->name, ss->name, ss->desc);
-                add_table_row__(sensor_table__[i], ss);
-            } else if (previously_valid && !now_valid) {
-                snmp_log(LOG_INFO, "Deleting %s%s, id=%08x",
-                         ss->name, ss->desc, ss->sensor_id);
-                AIM_LOG_INFO("delete row %d from %s for %s%s",
-                                ss->index, ctrl->name, ss->name, ss->desc);
-                delete_table_row__(sensor_table__[i], ss->index);
-                list_remove(curr);
-                aim_free(ss);
-            }
+        snap = snapshot_get__(i);
+        if (snap == NULL || !sensor_table__[i] ||
+            snap->members_epoch == restructured_epoch__[i]) {
+            continue;
         }
+        AIM_LOG_INFO("restructuring %s", get_sensor_ctrl__(i)->name);
+        restructure_table__(i, snap);
+        restructured_epoch__[i] = snap->members_epoch;
     }
 
-    AIM_LOG_INFO("restructuring complete");
-
-    restructure_trigger = false;
+    snapshot_read_end__();
 }
 
 
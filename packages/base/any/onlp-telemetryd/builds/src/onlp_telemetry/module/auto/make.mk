@@ -0,0 +1,9 @@
+###############################################################################
+#
+# onlp_telemetry Autogeneration
+#
+###############################################################################
+onlp_telemetry_AUTO_DEFS := module/auto/onlp_telemetry.yml
+onlp_telemetry_AUTO_DIRS := module/inc/onlp_telemetry module/src
+include $(BUILDER)/auto.mk
+
@@ -0,0 +1,89 @@
+/************************************************************
+ * <bsn.cl fy=2015 v=onl>
+ * 
+ *           Copyright 2015 Big Switch Networks, Inc.          
+ * 
+ * Licensed under the Eclipse Public License, Version 1.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ * 
+ *        http://www.eclipse.org/legal/epl-v10.html
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the
+ * License.
+ * 
+ * </bsn.cl>
+ ************************************************************
+ *
+ * ONLP Telemetry Exporter
+ *
+ * Every sample period the exporter reads all thermal, fan, and
+ * psu OIDs (and the SFP DOM records if configured) through the
+ * ONLP getters. These are served from the telemetry snapshot
+ * published by the platform manager when
+ * ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT is enabled, and read from
+ * the platform otherwise. One sample is shared by all subscribers.
+ *
+ * Stream subscribers connect to the Unix socket or the TCP
+ * stream port and receive a FULL frame with the current state,
+ * followed by one DELTA frame per sample (empty if nothing
+ * changed). A Prometheus text exposition is served over HTTP
+ * on a separate port.
+ *
+ ***********************************************************/
+#ifndef __ONLP_TELEMETRY_H__
+#define __ONLP_TELEMETRY_H__
+
+#include <onlp_telemetry/onlp_telemetry_config.h>
+
+/**
+ * Stream frames.
+ *
+ * Each frame starts with an 8 byte header:
+ *
+ *   uint16_t magic      ONLP_TELEMETRY_FRAME_MAGIC, network order
+ *   uint8_t  version    ONLP_TELEMETRY_FRAME_VERSION
+ *   uint8_t  type       onlp_telemetry_frame_type_t
+ *   uint32_t length     Payload length, network order
+ *
+ * All payload integers are LEB128 varints. Signed values are
+ * zigzag encoded. The payload is:
+ *
+ *   seq                 Sample sequence number
+ *   time                Sample time (wall clock msecs)
+ *   nremoved, { id }    Metrics which no longer exist
+ *   ndefs, { id, exponent (signed), name length, name }
+ *   nvalues, { id, value (signed) }
+ *
+ * Removals are listed first so a metric id may be reused by a
+ * definition in the same frame. The metric name is in the
+ * Prometheus form, e.g. onlp_fan_rpm{id="1",description="Fan 1"}.
+ * A metric's value is value * 10^exponent in the metric's unit.
+ *
+ * In a FULL frame every metric is defined and every value is
+ * absolute. In a DELTA frame only new metrics are defined and
+ * only changed values are listed; each value is the difference
+ * from the metric's previous value, or from zero for a metric
+ * defined in the same frame.
+ */
+#define ONLP_TELEMETRY_FRAME_MAGIC 0x4F54
+#define ONLP_TELEMETRY_FRAME_VERSION 1
+#define ONLP_TELEMETRY_FRAME_HEADER_SIZE 8
+
+typedef enum onlp_telemetry_frame_type_e {
+    ONLP_TELEMETRY_FRAME_TYPE_FULL = 1,
+    ONLP_TELEMETRY_FRAME_TYPE_DELTA = 2,
+} onlp_telemetry_frame_type_t;
+
+/**
+ * @brief The onlp-telemetryd entry point.
+ * @param argc Argument count.
+ * @param argv Arguments.
+ */
+int onlp_telemetry_main(int argc, char* argv[]);
+
+#endif /* __ONLP_TELEMETRY_H__ */
@@ -0,0 +1,237 @@
+/**************************************************************************//**
+ *
+ * @file
+ * @brief onlp_telemetry Configuration Header
+ *
+ * @addtogroup onlp_telemetry-config
+ * @{
+ *
+ *****************************************************************************/
+#ifndef __ONLP_TELEMETRY_CONFIG_H__
+#define __ONLP_TELEMETRY_CONFIG_H__
+
+#include <onlp/onlp_config.h>
+
+#ifdef GLOBAL_INCLUDE_CUSTOM_CONFIG
+#include <global_custom_config.h>
+#endif
+#ifdef ONLP_TELEMETRY_INCLUDE_CUSTOM_CONFIG
+#include <onlp_telemetry_custom_config.h>
+#endif
+
+/* <auto.start.cdefs(ONLP_TELEMETRY_CONFIG_HEADER).header> */
+#include <AIM/aim.h>
+/**
+ * ONLP_TELEMETRY_CONFIG_INCLUDE_LOGGING
+ *
+ * Include or exclude logging. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_INCLUDE_LOGGING
+#define ONLP_TELEMETRY_CONFIG_INCLUDE_LOGGING 1
+#endif
+
+/**
+ * ONLP_TELEMETRY_CONFIG_LOG_OPTIONS_DEFAULT
+ *
+ * Default enabled log options. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_LOG_OPTIONS_DEFAULT
+#define ONLP_TELEMETRY_CONFIG_LOG_OPTIONS_DEFAULT AIM_LOG_OPTIONS_DEFAULT
+#endif
+
+/**
+ * ONLP_TELEMETRY_CONFIG_LOG_BITS_DEFAULT
+ *
+ * Default enabled log bits. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_LOG_BITS_DEFAULT
+#define ONLP_TELEMETRY_CONFIG_LOG_BITS_DEFAULT AIM_LOG_BITS_DEFAULT
+#endif
+
+/**
+ * ONLP_TELEMETRY_CONFIG_LOG_CUSTOM_BITS_DEFAULT
+ *
+ * Default enabled custom log bits. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_LOG_CUSTOM_BITS_DEFAULT
+#define ONLP_TELEMETRY_CONFIG_LOG_CUSTOM_BITS_DEFAULT 0
+#endif
+
+/**
+ * ONLP_TELEMETRY_CONFIG_PORTING_STDLIB
+ *
+ * Default all porting macros to use the C standard libraries. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_PORTING_STDLIB
+#define ONLP_TELEMETRY_CONFIG_PORTING_STDLIB 1
+#endif
+
+/**
+ * ONLP_TELEMETRY_CONFIG_PORTING_INCLUDE_STDLIB_HEADERS
+ *
+ * Include standard library headers for stdlib porting macros. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_PORTING_INCLUDE_STDLIB_HEADERS
+#define ONLP_TELEMETRY_CONFIG_PORTING_INCLUDE_STDLIB_HEADERS ONLP_TELEMETRY_CONFIG_PORTING_STDLIB
+#endif
+
+/**
+ * ONLP_TELEMETRY_CONFIG_INCLUDE_UCLI
+ *
+ * Include generic uCli support. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_INCLUDE_UCLI
+#define ONLP_TELEMETRY_CONFIG_INCLUDE_UCLI 0
+#endif/**
+ * ONLP_TELEMETRY_CONFIG_SAMPLE_PERIOD
+ *
+ * Default sampling period in microseconds. This matches the onlp-snmpd update period. Samples are served from the telemetry snapshot when it is enabled and otherwise read the platform. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_SAMPLE_PERIOD
+#define ONLP_TELEMETRY_CONFIG_SAMPLE_PERIOD 5000000
+#endif
+
+/**
+ * ONLP_TELEMETRY_CONFIG_INCLUDE_SFP_DOM
+ *
+ * Include SFP DOM metrics. The DOM cache is per process so this polls the modules from the exporter in addition to the platform manager. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_INCLUDE_SFP_DOM
+#define ONLP_TELEMETRY_CONFIG_INCLUDE_SFP_DOM 0
+#endif
+
+/**
+ * ONLP_TELEMETRY_CONFIG_UNIX_SOCKET
+ *
+ * Default stream subscriber Unix socket path. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_UNIX_SOCKET
+#define ONLP_TELEMETRY_CONFIG_UNIX_SOCKET "/var/run/onl/telemetry.sock"
+#endif
+
+/**
+ * ONLP_TELEMETRY_CONFIG_LISTEN_ADDRESS
+ *
+ * Default TCP listen address. The listeners are unauthenticated so only local clients are served by default. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_LISTEN_ADDRESS
+#define ONLP_TELEMETRY_CONFIG_LISTEN_ADDRESS "127.0.0.1"
+#endif
+
+/**
+ * ONLP_TELEMETRY_CONFIG_STREAM_PORT
+ *
+ * Default stream subscriber TCP port. Zero disables the listener. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_STREAM_PORT
+#define ONLP_TELEMETRY_CONFIG_STREAM_PORT 9121
+#endif
+
+/**
+ * ONLP_TELEMETRY_CONFIG_PROMETHEUS_PORT
+ *
+ * Default Prometheus exposition HTTP port. Zero disables the listener. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_PROMETHEUS_PORT
+#define ONLP_TELEMETRY_CONFIG_PROMETHEUS_PORT 9120
+#endif
+
+/**
+ * ONLP_TELEMETRY_CONFIG_METRICS_MAX
+ *
+ * Maximum number of exported metrics. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_METRICS_MAX
+#define ONLP_TELEMETRY_CONFIG_METRICS_MAX 4096
+#endif
+
+/**
+ * ONLP_TELEMETRY_CONFIG_CLIENTS_MAX
+ *
+ * Maximum number of simultaneous clients. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_CLIENTS_MAX
+#define ONLP_TELEMETRY_CONFIG_CLIENTS_MAX 32
+#endif
+
+/**
+ * ONLP_TELEMETRY_CONFIG_CLIENT_BUFFER_MAX
+ *
+ * Maximum number of unsent bytes queued for a client before it is disconnected. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_CLIENT_BUFFER_MAX
+#define ONLP_TELEMETRY_CONFIG_CLIENT_BUFFER_MAX 1048576
+#endif
+
+/**
+ * ONLP_TELEMETRY_CONFIG_CLIENTS_UNIX_RESERVED
+ *
+ * Number of client slots reserved for Unix socket subscribers. TCP clients may use the remaining slots. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_CLIENTS_UNIX_RESERVED
+#define ONLP_TELEMETRY_CONFIG_CLIENTS_UNIX_RESERVED 4
+#endif
+
+/**
+ * ONLP_TELEMETRY_CONFIG_HTTP_TIMEOUT
+ *
+ * Time in microseconds an HTTP client may remain idle before it is disconnected. */
+
+
+#ifndef ONLP_TELEMETRY_CONFIG_HTTP_TIMEOUT
+#define ONLP_TELEMETRY_CONFIG_HTTP_TIMEOUT 5000000
+#endif
+
+
+
+/**
+ * All compile time options can be queried or displayed
+ */
+
+/** Configuration settings structure. */
+typedef struct onlp_telemetry_config_settings_s {
+    /** name */
+    const char* name;
+    /** value */
+    const char* value;
+} onlp_telemetry_config_settings_t;
+
+/** Configuration settings table. */
+/** onlp_telemetry_config_settings table. */
+extern onlp_telemetry_config_settings_t onlp_telemetry_config_settings[];
+
+/**
+ * @brief Lookup a configuration setting.
+ * @param setting The name of the configuration option to lookup.
+ */
+const char* onlp_telemetry_config_lookup(const char* setting);
+
+/**
+ * @brief Show the compile-time configuration.
+ * @param pvs The output stream.
+ */
+int onlp_telemetry_config_show(struct aim_pvs_s* pvs);
+
+/* <auto.end.cdefs(ONLP_TELEMETRY_CONFIG_HEADER).header> */
+
+#include "onlp_telemetry_porting.h"
+
+#endif /* __ONLP_TELEMETRY_CONFIG_H__ */
+/* @} */
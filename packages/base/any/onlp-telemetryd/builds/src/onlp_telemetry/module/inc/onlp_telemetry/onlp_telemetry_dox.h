@@ -0,0 +1,27 @@
+/**************************************************************************//**
+ *
+ * onlp_telemetry Doxygen Header
+ *
+ *****************************************************************************/
+#ifndef __ONLP_TELEMETRY_DOX_H__
+#define __ONLP_TELEMETRY_DOX_H__
+
+/**
+ * @defgroup onlp_telemetry onlp_telemetry - ONLP Telemetry Exporter
+ *
+
+Samples ONLP thermal, fan, psu, and SFP DOM telemetry and
+streams changes to subscribers. See onlp_telemetry.h.
+
+ *
+ * @{
+ *
+ * @defgroup onlp_telemetry-onlp_telemetry Public Interface
+ * @defgroup onlp_telemetry-config Compile Time Configuration
+ * @defgroup onlp_telemetry-porting Porting Macros
+ *
+ * @}
+ *
+ */
+
+#endif /* __ONLP_TELEMETRY_DOX_H__ */
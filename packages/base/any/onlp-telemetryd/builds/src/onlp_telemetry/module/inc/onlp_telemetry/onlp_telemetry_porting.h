@@ -0,0 +1,57 @@
+/**************************************************************************//**
+ *
+ * @file
+ * @brief onlp_telemetry Porting Macros.
+ *
+ * @addtogroup onlp_telemetry-porting
+ * @{
+ *
+ *****************************************************************************/
+#ifndef __ONLP_TELEMETRY_PORTING_H__
+#define __ONLP_TELEMETRY_PORTING_H__
+
+
+/* <auto.start.portingmacro(ALL).define> */
+#if ONLP_TELEMETRY_CONFIG_PORTING_INCLUDE_STDLIB_HEADERS == 1
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <memory.h>
+#endif
+
+#ifndef ONLP_TELEMETRY_MEMSET
+    #if defined(GLOBAL_MEMSET)
+        #define ONLP_TELEMETRY_MEMSET GLOBAL_MEMSET
+    #elif ONLP_TELEMETRY_CONFIG_PORTING_STDLIB == 1
+        #define ONLP_TELEMETRY_MEMSET memset
+    #else
+        #error The macro ONLP_TELEMETRY_MEMSET is required but cannot be defined.
+    #endif
+#endif
+
+#ifndef ONLP_TELEMETRY_MEMCPY
+    #if defined(GLOBAL_MEMCPY)
+        #define ONLP_TELEMETRY_MEMCPY GLOBAL_MEMCPY
+    #elif ONLP_TELEMETRY_CONFIG_PORTING_STDLIB == 1
+        #define ONLP_TELEMETRY_MEMCPY memcpy
+    #else
+        #error The macro ONLP_TELEMETRY_MEMCPY is required but cannot be defined.
+    #endif
+#endif
+
+#ifndef ONLP_TELEMETRY_STRNCPY
+    #if defined(GLOBAL_STRNCPY)
+        #define ONLP_TELEMETRY_STRNCPY GLOBAL_STRNCPY
+    #elif ONLP_TELEMETRY_CONFIG_PORTING_STDLIB == 1
+        #define ONLP_TELEMETRY_STRNCPY strncpy
+    #else
+        #error The macro ONLP_TELEMETRY_STRNCPY is required but cannot be defined.
+    #endif
+#endif
+
+/* <auto.end.portingmacro(ALL).define> */
+
+
+#endif /* __ONLP_TELEMETRY_PORTING_H__ */
+/* @} */
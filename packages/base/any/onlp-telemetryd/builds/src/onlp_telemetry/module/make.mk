@@ -0,0 +1,9 @@
+###############################################################################
+#
+#
+#
+###############################################################################
+THIS_DIR := $(dir $(lastword $(MAKEFILE_LIST)))
+onlp_telemetry_INCLUDES := -I $(THIS_DIR)inc
+onlp_telemetry_INTERNAL_INCLUDES := -I $(THIS_DIR)src
+onlp_telemetry_DEPENDMODULE_ENTRIES := init:onlp_telemetry ucli:onlp_telemetry
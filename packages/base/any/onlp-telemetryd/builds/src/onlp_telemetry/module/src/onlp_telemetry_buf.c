@@ -0,0 +1,93 @@
+/**************************************************************************//**
+ *
+ * Output buffers and varint encoding.
+ *
+ *****************************************************************************/
+#include <onlp_telemetry/onlp_telemetry_config.h>
+#include <AIM/aim.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "onlp_telemetry_int.h"
+
+static void
+buf_reserve__(onlp_telemetry_buf_t* b, uint32_t len)
+{
+    if(b->len + len > b->size) {
+        uint32_t size = b->size ? b->size : 256;
+        while(size < b->len + len) {
+            size *= 2;
+        }
+        b->data = aim_realloc(b->data, size);
+        b->size = size;
+    }
+}
+
+void
+onlp_telemetry_buf_free(onlp_telemetry_buf_t* b)
+{
+    aim_free(b->data);
+    b->data = NULL;
+    b->len = b->size = 0;
+}
+
+void
+onlp_telemetry_buf_append(onlp_telemetry_buf_t* b, const void* data, uint32_t len)
+{
+    if(len == 0) {
+        return;
+    }
+    buf_reserve__(b, len);
+    memcpy(b->data + b->len, data, len);
+    b->len += len;
+}
+
+void
+onlp_telemetry_buf_printf(onlp_telemetry_buf_t* b, const char* fmt, ...)
+{
+    va_list vargs;
+    int len;
+
+    va_start(vargs, fmt);
+    len = vsnprintf(NULL, 0, fmt, vargs);
+    va_end(vargs);
+    if(len <= 0) {
+        return;
+    }
+
+    /* vsnprintf() writes a terminator past the formatted text. */
+    buf_reserve__(b, len + 1);
+    va_start(vargs, fmt);
+    vsnprintf((char*)b->data + b->len, len + 1, fmt, vargs);
+    va_end(vargs);
+    b->len += len;
+}
+
+void
+onlp_telemetry_buf_varint(onlp_telemetry_buf_t* b, uint64_t value)
+{
+    buf_reserve__(b, 10);
+    while(value >= 0x80) {
+        b->data[b->len++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    b->data[b->len++] = value;
+}
+
+void
+onlp_telemetry_buf_svarint(onlp_telemetry_buf_t* b, int64_t value)
+{
+    onlp_telemetry_buf_varint(b, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+void
+onlp_telemetry_buf_consume(onlp_telemetry_buf_t* b, uint32_t len)
+{
+    if(len >= b->len) {
+        b->len = 0;
+    }
+    else {
+        memmove(b->data, b->data + len, b->len - len);
+        b->len -= len;
+    }
+}
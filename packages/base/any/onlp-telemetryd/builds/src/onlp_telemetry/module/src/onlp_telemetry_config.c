@@ -0,0 +1,131 @@
+/**************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+#include <onlp_telemetry/onlp_telemetry_config.h>
+
+/* <auto.start.cdefs(ONLP_TELEMETRY_CONFIG_HEADER).source> */
+#define __onlp_telemetry_config_STRINGIFY_NAME(_x) #_x
+#define __onlp_telemetry_config_STRINGIFY_VALUE(_x) __onlp_telemetry_config_STRINGIFY_NAME(_x)
+onlp_telemetry_config_settings_t onlp_telemetry_config_settings[] =
+{
+#ifdef ONLP_TELEMETRY_CONFIG_INCLUDE_LOGGING
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_INCLUDE_LOGGING), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_INCLUDE_LOGGING) },
+#else
+{ ONLP_TELEMETRY_CONFIG_INCLUDE_LOGGING(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_LOG_OPTIONS_DEFAULT
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_LOG_OPTIONS_DEFAULT), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_LOG_OPTIONS_DEFAULT) },
+#else
+{ ONLP_TELEMETRY_CONFIG_LOG_OPTIONS_DEFAULT(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_LOG_BITS_DEFAULT
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_LOG_BITS_DEFAULT), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_LOG_BITS_DEFAULT) },
+#else
+{ ONLP_TELEMETRY_CONFIG_LOG_BITS_DEFAULT(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_LOG_CUSTOM_BITS_DEFAULT
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_LOG_CUSTOM_BITS_DEFAULT), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_LOG_CUSTOM_BITS_DEFAULT) },
+#else
+{ ONLP_TELEMETRY_CONFIG_LOG_CUSTOM_BITS_DEFAULT(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_PORTING_STDLIB
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_PORTING_STDLIB), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_PORTING_STDLIB) },
+#else
+{ ONLP_TELEMETRY_CONFIG_PORTING_STDLIB(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_PORTING_INCLUDE_STDLIB_HEADERS
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_PORTING_INCLUDE_STDLIB_HEADERS), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_PORTING_INCLUDE_STDLIB_HEADERS) },
+#else
+{ ONLP_TELEMETRY_CONFIG_PORTING_INCLUDE_STDLIB_HEADERS(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_INCLUDE_UCLI
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_INCLUDE_UCLI), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_INCLUDE_UCLI) },
+#else
+{ ONLP_TELEMETRY_CONFIG_INCLUDE_UCLI(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_SAMPLE_PERIOD
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_SAMPLE_PERIOD), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_SAMPLE_PERIOD) },
+#else
+{ ONLP_TELEMETRY_CONFIG_SAMPLE_PERIOD(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_INCLUDE_SFP_DOM
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_INCLUDE_SFP_DOM), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_INCLUDE_SFP_DOM) },
+#else
+{ ONLP_TELEMETRY_CONFIG_INCLUDE_SFP_DOM(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_UNIX_SOCKET
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_UNIX_SOCKET), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_UNIX_SOCKET) },
+#else
+{ ONLP_TELEMETRY_CONFIG_UNIX_SOCKET(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_LISTEN_ADDRESS
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_LISTEN_ADDRESS), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_LISTEN_ADDRESS) },
+#else
+{ ONLP_TELEMETRY_CONFIG_LISTEN_ADDRESS(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_STREAM_PORT
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_STREAM_PORT), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_STREAM_PORT) },
+#else
+{ ONLP_TELEMETRY_CONFIG_STREAM_PORT(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_PROMETHEUS_PORT
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_PROMETHEUS_PORT), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_PROMETHEUS_PORT) },
+#else
+{ ONLP_TELEMETRY_CONFIG_PROMETHEUS_PORT(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_METRICS_MAX
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_METRICS_MAX), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_METRICS_MAX) },
+#else
+{ ONLP_TELEMETRY_CONFIG_METRICS_MAX(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_CLIENTS_MAX
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_CLIENTS_MAX), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_CLIENTS_MAX) },
+#else
+{ ONLP_TELEMETRY_CONFIG_CLIENTS_MAX(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_CLIENT_BUFFER_MAX
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_CLIENT_BUFFER_MAX), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_CLIENT_BUFFER_MAX) },
+#else
+{ ONLP_TELEMETRY_CONFIG_CLIENT_BUFFER_MAX(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_CLIENTS_UNIX_RESERVED
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_CLIENTS_UNIX_RESERVED), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_CLIENTS_UNIX_RESERVED) },
+#else
+{ ONLP_TELEMETRY_CONFIG_CLIENTS_UNIX_RESERVED(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_TELEMETRY_CONFIG_HTTP_TIMEOUT
+    { __onlp_telemetry_config_STRINGIFY_NAME(ONLP_TELEMETRY_CONFIG_HTTP_TIMEOUT), __onlp_telemetry_config_STRINGIFY_VALUE(ONLP_TELEMETRY_CONFIG_HTTP_TIMEOUT) },
+#else
+{ ONLP_TELEMETRY_CONFIG_HTTP_TIMEOUT(__onlp_telemetry_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+    { NULL, NULL }
+};
+#undef __onlp_telemetry_config_STRINGIFY_VALUE
+#undef __onlp_telemetry_config_STRINGIFY_NAME
+
+const char*
+onlp_telemetry_config_lookup(const char* setting)
+{
+    int i;
+    for(i = 0; onlp_telemetry_config_settings[i].name; i++) {
+        if(!strcmp(onlp_telemetry_config_settings[i].name, setting)) {
+            return onlp_telemetry_config_settings[i].value;
+        }
+    }
+    return NULL;
+}
+
+int
+onlp_telemetry_config_show(struct aim_pvs_s* pvs)
+{
+    int i;
+    for(i = 0; onlp_telemetry_config_settings[i].name; i++) {
+        aim_printf(pvs, "%s = %s\n", onlp_telemetry_config_settings[i].name, onlp_telemetry_config_settings[i].value);
+    }
+    return i;
+}
+
+/* <auto.end.cdefs(ONLP_TELEMETRY_CONFIG_HEADER).source> */
+
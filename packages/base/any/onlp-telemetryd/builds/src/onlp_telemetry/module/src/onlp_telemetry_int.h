@@ -0,0 +1,79 @@
+/**************************************************************************//**
+ *
+ * onlp_telemetry Internal Header
+ *
+ *****************************************************************************/
+#ifndef __ONLP_TELEMETRY_INT_H__
+#define __ONLP_TELEMETRY_INT_H__
+
+#include <onlp_telemetry/onlp_telemetry_config.h>
+#include <stdint.h>
+
+/**
+ * Growable output buffer.
+ */
+typedef struct onlp_telemetry_buf_s {
+    uint8_t* data;
+    uint32_t len;
+    uint32_t size;
+} onlp_telemetry_buf_t;
+
+void onlp_telemetry_buf_free(onlp_telemetry_buf_t* b);
+void onlp_telemetry_buf_append(onlp_telemetry_buf_t* b,
+                               const void* data, uint32_t len);
+void onlp_telemetry_buf_printf(onlp_telemetry_buf_t* b, const char* fmt, ...);
+void onlp_telemetry_buf_varint(onlp_telemetry_buf_t* b, uint64_t value);
+void onlp_telemetry_buf_svarint(onlp_telemetry_buf_t* b, int64_t value);
+/** Discard len bytes from the front of the buffer. */
+void onlp_telemetry_buf_consume(onlp_telemetry_buf_t* b, uint32_t len);
+
+int onlp_telemetry_metrics_init(void);
+void onlp_telemetry_metrics_denit(void);
+
+/**
+ * @brief Sample all telemetry.
+ * @param [out] delta Receives the DELTA frame for this sample.
+ */
+int onlp_telemetry_metrics_sample(onlp_telemetry_buf_t* delta);
+
+/**
+ * @brief Append a FULL frame describing the last sample.
+ */
+void onlp_telemetry_metrics_full(onlp_telemetry_buf_t* dst);
+
+/**
+ * @brief Append the Prometheus text exposition of the last sample.
+ */
+void onlp_telemetry_metrics_prometheus(onlp_telemetry_buf_t* dst);
+
+typedef struct onlp_telemetry_server_config_s {
+    /** Stream Unix socket path. NULL disables. */
+    const char* unix_path;
+    /** TCP listen address. */
+    const char* address;
+    /** Stream TCP port. Zero disables. */
+    int stream_port;
+    /** Prometheus HTTP port. Zero disables. */
+    int prometheus_port;
+    /** Sample period (usecs). */
+    uint32_t period;
+} onlp_telemetry_server_config_t;
+
+int onlp_telemetry_server_start(const onlp_telemetry_server_config_t* config);
+
+/**
+ * @brief Sample and serve clients until onlp_telemetry_server_stop() is called.
+ */
+int onlp_telemetry_server_run(void);
+
+/**
+ * @brief Stop the server loop. Safe to call from a signal handler.
+ */
+void onlp_telemetry_server_stop(void);
+
+/**
+ * @brief Close all clients and listeners.
+ */
+void onlp_telemetry_server_close(void);
+
+#endif /* __ONLP_TELEMETRY_INT_H__ */
@@ -0,0 +1,18 @@
+/**************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+#include <onlp_telemetry/onlp_telemetry_config.h>
+
+#include "onlp_telemetry_log.h"
+/*
+ * onlp_telemetry log struct.
+ */
+AIM_LOG_STRUCT_DEFINE(
+                      ONLP_TELEMETRY_CONFIG_LOG_OPTIONS_DEFAULT,
+                      ONLP_TELEMETRY_CONFIG_LOG_BITS_DEFAULT,
+                      NULL, /* Custom log map */
+                      ONLP_TELEMETRY_CONFIG_LOG_CUSTOM_BITS_DEFAULT
+                     );
+
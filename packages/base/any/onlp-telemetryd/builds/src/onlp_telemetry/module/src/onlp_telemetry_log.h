@@ -0,0 +1,12 @@
+/**************************************************************************//**
+ *
+ * 
+ *
+ *****************************************************************************/
+#ifndef __ONLP_TELEMETRY_LOG_H__
+#define __ONLP_TELEMETRY_LOG_H__
+
+#define AIM_LOG_MODULE_NAME onlp_telemetry
+#include <AIM/aim_log.h>
+
+#endif /* __ONLP_TELEMETRY_LOG_H__ */
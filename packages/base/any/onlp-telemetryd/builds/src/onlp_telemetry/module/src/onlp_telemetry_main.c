@@ -0,0 +1,146 @@
+/**************************************************************************//**
+ *
+ * onlp-telemetryd
+ *
+ *****************************************************************************/
+#include <onlp_telemetry/onlp_telemetry_config.h>
+#include <onlp_telemetry/onlp_telemetry.h>
+#include <AIM/aim.h>
+#include <AIM/aim_log_handler.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "onlp_telemetry_int.h"
+#include "onlp_telemetry_log.h"
+
+static void
+sighandler__(int signal)
+{
+    onlp_telemetry_server_stop();
+}
+
+#if AIM_CONFIG_INCLUDE_DAEMONIZE == 1
+
+#include <AIM/aim_daemon.h>
+
+static void
+daemonize__(char** argv)
+{
+    aim_daemon_restart_config_t rconfig;
+    aim_daemon_config_t config;
+
+    memset(&config, 0, sizeof(config));
+    aim_daemon_restart_config_init(&rconfig, 1, 1, argv);
+    AIM_BITMAP_CLR(&rconfig.signal_restarts, SIGTERM);
+    AIM_BITMAP_CLR(&rconfig.exit_restarts, 0);
+    rconfig.maximum_restarts=50;
+    rconfig.pvs = NULL;
+    config.wd = "/";
+
+    aim_daemonize(&config, &rconfig);
+    aim_log_handler_basic_init_all("onlp-telemetryd",
+                                   "/var/log/onlp-telemetryd.log",
+                                   1024*1024,
+                                   99);
+}
+
+#else
+static void
+daemonize__(char** argv)
+{
+    fprintf(stderr, "Daemon mode not supported in this build.\n");
+    exit(1);
+}
+#endif
+
+int
+onlp_telemetry_main(int argc, char* argv[])
+{
+    onlp_telemetry_server_config_t config;
+    const char* pidfile = NULL;
+    int daemon = 0;
+    int help = 0;
+    int rv = 0;
+    int c;
+
+    memset(&config, 0, sizeof(config));
+    config.unix_path = ONLP_TELEMETRY_CONFIG_UNIX_SOCKET;
+    config.address = ONLP_TELEMETRY_CONFIG_LISTEN_ADDRESS;
+    config.stream_port = ONLP_TELEMETRY_CONFIG_STREAM_PORT;
+    config.prometheus_port = ONLP_TELEMETRY_CONFIG_PROMETHEUS_PORT;
+    config.period = ONLP_TELEMETRY_CONFIG_SAMPLE_PERIOD;
+
+    while( (c = getopt(argc, argv, "u:a:s:m:i:DP:h")) != -1) {
+        switch(c)
+            {
+            case 'u': config.unix_path = *optarg ? optarg : NULL; break;
+            case 'a': config.address = optarg; break;
+            case 's': config.stream_port = atoi(optarg); break;
+            case 'm': config.prometheus_port = atoi(optarg); break;
+            case 'i': config.period = strtoul(optarg, NULL, 0); break;
+            case 'D': daemon = 1; break;
+            case 'P': pidfile = optarg; break;
+            case 'h': help=1; rv = 0; break;
+            default: help=1; rv = 1; break;
+            }
+    }
+
+    if(config.period == 0) {
+        help = 1;
+        rv = 1;
+    }
+
+    if(help) {
+        printf("Usage: %s [OPTIONS]\n", argv[0]);
+        printf("  -u   <path>  Stream Unix socket path. An empty path disables it. Default %s\n",
+               ONLP_TELEMETRY_CONFIG_UNIX_SOCKET);
+        printf("  -a   <addr>  TCP listen address. Default %s\n",
+               ONLP_TELEMETRY_CONFIG_LISTEN_ADDRESS);
+        printf("  -s   <port>  Stream TCP port. Zero disables it. Default %d\n",
+               ONLP_TELEMETRY_CONFIG_STREAM_PORT);
+        printf("  -m   <port>  Prometheus HTTP port. Zero disables it. Default %d\n",
+               ONLP_TELEMETRY_CONFIG_PROMETHEUS_PORT);
+        printf("  -i   <usecs> Sample period. Default %d\n",
+               ONLP_TELEMETRY_CONFIG_SAMPLE_PERIOD);
+        printf("  -D   Run as a daemon.\n");
+        printf("  -P   <file>  Write the process id to this file.\n");
+        return rv;
+    }
+
+    if(daemon) {
+        daemonize__(argv);
+    }
+
+    if(pidfile) {
+        FILE* fp = fopen(pidfile, "w");
+        if(fp == NULL) {
+            AIM_LOG_ERROR("fatal: open(%s): %s", pidfile, strerror(errno));
+            /* Don't attempt restart */
+            raise(SIGTERM);
+            return 1;
+        }
+        fprintf(fp, "%d\n", getpid());
+        fclose(fp);
+    }
+
+    signal(SIGTERM, sighandler__);
+    signal(SIGINT, sighandler__);
+
+    onlp_telemetry_metrics_init();
+    if(onlp_telemetry_server_start(&config) < 0) {
+        rv = 1;
+    }
+    else if(onlp_telemetry_server_run() < 0) {
+        rv = 1;
+    }
+    onlp_telemetry_server_close();
+    onlp_telemetry_metrics_denit();
+
+    if(daemon) {
+        aim_log_handler_basic_denit_all();
+    }
+    return rv;
+}
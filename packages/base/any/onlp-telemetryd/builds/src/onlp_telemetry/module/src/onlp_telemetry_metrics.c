@@ -0,0 +1,602 @@
+/**************************************************************************//**
+ *
+ * Telemetry sampling and encoding.
+ *
+ * Each sample reads every OID (and optionally SFP DOM record)
+ * once and updates a table of metrics keyed by (family, lane, id). The
+ * DELTA frame for the sample, the FULL frame sent to new
+ * subscribers, and the Prometheus exposition are all encoded
+ * from this table.
+ *
+ *****************************************************************************/
+#include <onlp_telemetry/onlp_telemetry_config.h>
+#include <onlp/onlp.h>
+#include <onlp/oids.h>
+#include <onlp/thermal.h>
+#include <onlp/fan.h>
+#include <onlp/psu.h>
+#if ONLP_TELEMETRY_CONFIG_INCLUDE_SFP_DOM == 1
+#include <onlp/sfp.h>
+#include <onlp/sfp_dom.h>
+#endif
+#include <onlp_telemetry/onlp_telemetry.h>
+#include <AIM/aim.h>
+#include <arpa/inet.h>
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+#include "onlp_telemetry_int.h"
+#include "onlp_telemetry_log.h"
+
+typedef enum family_e {
+    FAMILY_THERMAL_CELSIUS,
+    FAMILY_THERMAL_STATUS,
+    FAMILY_FAN_RPM,
+    FAMILY_FAN_PERCENTAGE,
+    FAMILY_FAN_STATUS,
+    FAMILY_PSU_INPUT_VOLTS,
+    FAMILY_PSU_OUTPUT_VOLTS,
+    FAMILY_PSU_INPUT_AMPS,
+    FAMILY_PSU_OUTPUT_AMPS,
+    FAMILY_PSU_INPUT_WATTS,
+    FAMILY_PSU_OUTPUT_WATTS,
+    FAMILY_PSU_STATUS,
+    FAMILY_SFP_DOM_TEMPERATURE,
+    FAMILY_SFP_DOM_VCC,
+    FAMILY_SFP_DOM_BIAS,
+    FAMILY_SFP_DOM_TX_POWER,
+    FAMILY_SFP_DOM_RX_POWER,
+    FAMILY_SFP_DOM_FLAGS,
+    FAMILY_COUNT,
+} family_t;
+
+/**
+ * Metric values are integers in units of 10^exponent, which
+ * keeps the native ONLP units on the wire.
+ */
+typedef struct family_info_s {
+    const char* name;
+    const char* help;
+    int exponent;
+} family_info_t;
+
+static const family_info_t families__[FAMILY_COUNT] = {
+    [FAMILY_THERMAL_CELSIUS] = { "onlp_thermal_celsius", "Thermal sensor temperature.", -3 },
+    [FAMILY_THERMAL_STATUS] = { "onlp_thermal_status", "Thermal sensor status flags (1 present, 2 failed).", 0 },
+    [FAMILY_FAN_RPM] = { "onlp_fan_rpm", "Fan speed in RPM.", 0 },
+    [FAMILY_FAN_PERCENTAGE] = { "onlp_fan_percentage", "Fan speed as a percentage of maximum.", 0 },
+    [FAMILY_FAN_STATUS] = { "onlp_fan_status", "Fan status flags (1 present, 2 failed).", 0 },
+    [FAMILY_PSU_INPUT_VOLTS] = { "onlp_psu_input_volts", "PSU input voltage.", -3 },
+    [FAMILY_PSU_OUTPUT_VOLTS] = { "onlp_psu_output_volts", "PSU output voltage.", -3 },
+    [FAMILY_PSU_INPUT_AMPS] = { "onlp_psu_input_amps", "PSU input current.", -3 },
+    [FAMILY_PSU_OUTPUT_AMPS] = { "onlp_psu_output_amps", "PSU output current.", -3 },
+    [FAMILY_PSU_INPUT_WATTS] = { "onlp_psu_input_watts", "PSU input power.", -3 },
+    [FAMILY_PSU_OUTPUT_WATTS] = { "onlp_psu_output_watts", "PSU output power.", -3 },
+    [FAMILY_PSU_STATUS] = { "onlp_psu_status", "PSU status flags (1 present, 2 failed, 4 unplugged).", 0 },
+    [FAMILY_SFP_DOM_TEMPERATURE] = { "onlp_sfp_dom_temperature_celsius", "SFP module temperature.", -3 },
+    [FAMILY_SFP_DOM_VCC] = { "onlp_sfp_dom_vcc_volts", "SFP module supply voltage.", -6 },
+    [FAMILY_SFP_DOM_BIAS] = { "onlp_sfp_dom_bias_amps", "SFP lane laser bias current.", -6 },
+    [FAMILY_SFP_DOM_TX_POWER] = { "onlp_sfp_dom_tx_power_watts", "SFP lane transmit power.", -7 },
+    [FAMILY_SFP_DOM_RX_POWER] = { "onlp_sfp_dom_rx_power_watts", "SFP lane receive power.", -7 },
+    [FAMILY_SFP_DOM_FLAGS] = { "onlp_sfp_dom_threshold_flags", "SFP DOM threshold flags currently crossed.", 0 },
+};
+
+#define METRIC_KEY__(_family, _lane, _id)                               \
+    ( ((uint64_t)(_family) << 40) | ((uint64_t)(_lane) << 32) | (uint32_t)(_id) )
+
+#define LABELS_MAX (2*ONLP_OID_DESC_SIZE + 32)
+
+typedef struct metric_s {
+    uint64_t key;
+    char* labels;
+    int64_t value;
+    /** The value last sent to subscribers. */
+    int64_t sent;
+    /** The sample sequence in which this metric was last updated. */
+    uint32_t seen;
+    uint16_t family;
+    uint8_t used;
+    /** Subscribers have received the definition. */
+    uint8_t defined;
+} metric_t;
+
+static struct {
+    /** Indexed by metric id - 1. */
+    metric_t* metrics;
+    /** The highest metric id allocated. */
+    uint32_t count;
+
+    /** Open addressed hash of keys to metric ids. */
+    uint32_t* index;
+    uint32_t index_mask;
+
+    /** Released metric ids. */
+    uint32_t* free;
+    uint32_t nfree;
+
+    /** Metric ids collected while encoding a frame. */
+    uint32_t* scratch;
+
+    uint32_t seq;
+    uint64_t time;
+    int overflow;
+} metrics__;
+
+int
+onlp_telemetry_metrics_init(void)
+{
+    uint32_t size = 1;
+
+    while(size < 2*ONLP_TELEMETRY_CONFIG_METRICS_MAX) {
+        size <<= 1;
+    }
+
+    metrics__.metrics = aim_zmalloc(sizeof(metric_t)*ONLP_TELEMETRY_CONFIG_METRICS_MAX);
+    metrics__.index = aim_zmalloc(sizeof(uint32_t)*size);
+    metrics__.index_mask = size - 1;
+    metrics__.free = aim_zmalloc(sizeof(uint32_t)*ONLP_TELEMETRY_CONFIG_METRICS_MAX);
+    metrics__.scratch = aim_zmalloc(sizeof(uint32_t)*ONLP_TELEMETRY_CONFIG_METRICS_MAX);
+
+#if ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT == 0
+    AIM_LOG_WARN("The ONLP telemetry snapshot is not included in this build. "
+                 "Every sample reads the platform directly.");
+#endif
+    return 0;
+}
+
+void
+onlp_telemetry_metrics_denit(void)
+{
+    uint32_t i;
+    for(i = 0; i < metrics__.count; i++) {
+        aim_free(metrics__.metrics[i].labels);
+    }
+    aim_free(metrics__.metrics);
+    aim_free(metrics__.index);
+    aim_free(metrics__.free);
+    aim_free(metrics__.scratch);
+    memset(&metrics__, 0, sizeof(metrics__));
+}
+
+static uint32_t
+index_slot__(uint64_t key)
+{
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & metrics__.index_mask;
+}
+
+static void
+index_insert__(uint64_t key, uint32_t id)
+{
+    uint32_t slot = index_slot__(key);
+    while(metrics__.index[slot]) {
+        slot = (slot + 1) & metrics__.index_mask;
+    }
+    metrics__.index[slot] = id;
+}
+
+static void
+index_rebuild__(void)
+{
+    uint32_t i;
+    memset(metrics__.index, 0, sizeof(uint32_t)*(metrics__.index_mask + 1));
+    for(i = 0; i < metrics__.count; i++) {
+        if(metrics__.metrics[i].used) {
+            index_insert__(metrics__.metrics[i].key, i + 1);
+        }
+    }
+}
+
+static void
+metric_set__(family_t family, int lane, uint32_t id,
+              const char* labels, int64_t value)
+{
+    uint64_t key = METRIC_KEY__(family, lane, id);
+    uint32_t slot = index_slot__(key);
+    uint32_t mid;
+    metric_t* m;
+
+    while((mid = metrics__.index[slot])) {
+        m = metrics__.metrics + mid - 1;
+        if(m->key == key) {
+            m->value = value;
+            m->seen = metrics__.seq;
+            return;
+        }
+        slot = (slot + 1) & metrics__.index_mask;
+    }
+
+    if(metrics__.nfree) {
+        mid = metrics__.free[--metrics__.nfree];
+    }
+    else if(metrics__.count < ONLP_TELEMETRY_CONFIG_METRICS_MAX) {
+        mid = ++metrics__.count;
+    }
+    else {
+        if(!metrics__.overflow) {
+            AIM_LOG_ERROR("More than %d metrics. Increase ONLP_TELEMETRY_CONFIG_METRICS_MAX.",
+                          ONLP_TELEMETRY_CONFIG_METRICS_MAX);
+            metrics__.overflow = 1;
+        }
+        return;
+    }
+
+    m = metrics__.metrics + mid - 1;
+    memset(m, 0, sizeof(*m));
+    m->key = key;
+    m->family = family;
+    m->labels = aim_strdup(labels);
+    m->value = value;
+    m->seen = metrics__.seq;
+    m->used = 1;
+    metrics__.index[slot] = mid;
+}
+
+/**
+ * Label values are quoted Prometheus strings.
+ */
+static void
+label_escape__(char* dst, int size, const char* src)
+{
+    int i = 0;
+    for(; *src && i < size - 2; src++) {
+        if(*src == '\\' || *src == '"') {
+            dst[i++] = '\\';
+            dst[i++] = *src;
+        }
+        else if(*src == '\n') {
+            dst[i++] = '\\';
+            dst[i++] = 'n';
+        }
+        else {
+            dst[i++] = *src;
+        }
+    }
+    dst[i] = 0;
+}
+
+static void
+oid_labels__(char* labels, int size, uint32_t id, const char* description)
+{
+    char desc[2*ONLP_OID_DESC_SIZE];
+    label_escape__(desc, sizeof(desc), description);
+    snprintf(labels, size, "id=\"%u\",description=\"%s\"", id, desc);
+}
+
+static void
+thermal_sample__(onlp_oid_t oid)
+{
+    onlp_thermal_info_t ti;
+    char labels[LABELS_MAX];
+    uint32_t id = ONLP_OID_ID_GET(oid);
+
+    if(onlp_thermal_info_get(oid, &ti) < 0) {
+        return;
+    }
+    oid_labels__(labels, sizeof(labels), id, ti.hdr.description);
+
+    metric_set__(FAMILY_THERMAL_STATUS, 0, id, labels, ti.status);
+    if(!(ti.status & ONLP_THERMAL_STATUS_PRESENT)) {
+        return;
+    }
+    if(ti.caps & ONLP_THERMAL_CAPS_GET_TEMPERATURE) {
+        metric_set__(FAMILY_THERMAL_CELSIUS, 0, id, labels, ti.mcelsius);
+    }
+}
+
+static void
+fan_sample__(onlp_oid_t oid)
+{
+    onlp_fan_info_t fi;
+    char labels[LABELS_MAX];
+    uint32_t id = ONLP_OID_ID_GET(oid);
+
+    if(onlp_fan_info_get(oid, &fi) < 0) {
+        return;
+    }
+    oid_labels__(labels, sizeof(labels), id, fi.hdr.description);
+
+    metric_set__(FAMILY_FAN_STATUS, 0, id, labels, fi.status);
+    if(!(fi.status & ONLP_FAN_STATUS_PRESENT)) {
+        return;
+    }
+    if(fi.caps & ONLP_FAN_CAPS_GET_RPM) {
+        metric_set__(FAMILY_FAN_RPM, 0, id, labels, fi.rpm);
+    }
+    if(fi.caps & ONLP_FAN_CAPS_GET_PERCENTAGE) {
+        metric_set__(FAMILY_FAN_PERCENTAGE, 0, id, labels, fi.percentage);
+    }
+}
+
+static void
+psu_sample__(onlp_oid_t oid)
+{
+    onlp_psu_info_t pi;
+    char labels[LABELS_MAX];
+    uint32_t id = ONLP_OID_ID_GET(oid);
+
+    if(onlp_psu_info_get(oid, &pi) < 0) {
+        return;
+    }
+    oid_labels__(labels, sizeof(labels), id, pi.hdr.description);
+
+    metric_set__(FAMILY_PSU_STATUS, 0, id, labels, pi.status);
+    if(!(pi.status & ONLP_PSU_STATUS_PRESENT)) {
+        return;
+    }
+    if(pi.caps & ONLP_PSU_CAPS_VIN) {
+        metric_set__(FAMILY_PSU_INPUT_VOLTS, 0, id, labels, pi.mvin);
+    }
+    if(pi.caps & ONLP_PSU_CAPS_VOUT) {
+        metric_set__(FAMILY_PSU_OUTPUT_VOLTS, 0, id, labels, pi.mvout);
+    }
+    if(pi.caps & ONLP_PSU_CAPS_IIN) {
+        metric_set__(FAMILY_PSU_INPUT_AMPS, 0, id, labels, pi.miin);
+    }
+    if(pi.caps & ONLP_PSU_CAPS_IOUT) {
+        metric_set__(FAMILY_PSU_OUTPUT_AMPS, 0, id, labels, pi.miout);
+    }
+    if(pi.caps & ONLP_PSU_CAPS_PIN) {
+        metric_set__(FAMILY_PSU_INPUT_WATTS, 0, id, labels, pi.mpin);
+    }
+    if(pi.caps & ONLP_PSU_CAPS_POUT) {
+        metric_set__(FAMILY_PSU_OUTPUT_WATTS, 0, id, labels, pi.mpout);
+    }
+}
+
+static int
+oid_sample__(onlp_oid_t oid, void* cookie)
+{
+    switch(ONLP_OID_TYPE_GET(oid))
+        {
+        case ONLP_OID_TYPE_THERMAL:
+            thermal_sample__(oid);
+            break;
+        case ONLP_OID_TYPE_FAN:
+            fan_sample__(oid);
+            break;
+        case ONLP_OID_TYPE_PSU:
+            psu_sample__(oid);
+            break;
+        default:
+            break;
+        }
+    return ONLP_STATUS_OK;
+}
+
+#if ONLP_TELEMETRY_CONFIG_INCLUDE_SFP_DOM == 1
+
+static void
+sfp_dom_sample__(void)
+{
+    onlp_sfp_bitmap_t bmap;
+    onlp_sfp_dom_t dom;
+    char labels[LABELS_MAX];
+    int port, lane;
+
+    /*
+     * The DOM cache is per process. Refresh it here at the sample
+     * rate rather than running a second polling timer.
+     */
+    onlp_sfp_dom_monitor_poll();
+
+    onlp_sfp_bitmap_t_init(&bmap);
+    if(onlp_sfp_bitmap_get(&bmap) < 0) {
+        return;
+    }
+
+    AIM_BITMAP_ITER(&bmap, port) {
+        if(onlp_sfp_dom_get(port, &dom) < 0 ||
+           dom.type == ONLP_SFP_DOM_TYPE_NONE) {
+            continue;
+        }
+
+        snprintf(labels, sizeof(labels), "port=\"%d\"", port);
+        metric_set__(FAMILY_SFP_DOM_TEMPERATURE, 0, port, labels, dom.temp);
+        metric_set__(FAMILY_SFP_DOM_VCC, 0, port, labels, dom.vcc);
+        metric_set__(FAMILY_SFP_DOM_FLAGS, 0, port, labels, dom.flags);
+
+        for(lane = 0; lane < dom.lanes && lane < ONLP_SFP_DOM_LANES_MAX; lane++) {
+            snprintf(labels, sizeof(labels), "port=\"%d\",lane=\"%d\"", port, lane);
+            metric_set__(FAMILY_SFP_DOM_BIAS, lane, port, labels, dom.bias[lane]);
+            metric_set__(FAMILY_SFP_DOM_TX_POWER, lane, port, labels, dom.tx_power[lane]);
+            metric_set__(FAMILY_SFP_DOM_RX_POWER, lane, port, labels, dom.rx_power[lane]);
+        }
+    }
+}
+
+#endif /* ONLP_TELEMETRY_CONFIG_INCLUDE_SFP_DOM */
+
+static uint32_t
+frame_begin__(onlp_telemetry_buf_t* b, onlp_telemetry_frame_type_t type)
+{
+    uint8_t hdr[ONLP_TELEMETRY_FRAME_HEADER_SIZE] = { 0 };
+    uint32_t offset = b->len;
+
+    hdr[0] = ONLP_TELEMETRY_FRAME_MAGIC >> 8;
+    hdr[1] = ONLP_TELEMETRY_FRAME_MAGIC & 0xFF;
+    hdr[2] = ONLP_TELEMETRY_FRAME_VERSION;
+    hdr[3] = type;
+    onlp_telemetry_buf_append(b, hdr, sizeof(hdr));
+
+    onlp_telemetry_buf_varint(b, metrics__.seq);
+    onlp_telemetry_buf_varint(b, metrics__.time);
+    return offset;
+}
+
+static void
+frame_end__(onlp_telemetry_buf_t* b, uint32_t offset)
+{
+    uint32_t length = htonl(b->len - offset - ONLP_TELEMETRY_FRAME_HEADER_SIZE);
+    memcpy(b->data + offset + 4, &length, sizeof(length));
+}
+
+static void
+frame_defs__(onlp_telemetry_buf_t* b, const uint32_t* ids, uint32_t count)
+{
+    char name[256 + LABELS_MAX];
+    uint32_t i;
+    int len;
+
+    onlp_telemetry_buf_varint(b, count);
+    for(i = 0; i < count; i++) {
+        metric_t* m = metrics__.metrics + ids[i] - 1;
+        const family_info_t* f = families__ + m->family;
+        len = snprintf(name, sizeof(name), "%s{%s}", f->name, m->labels);
+        if(len >= sizeof(name)) {
+            len = sizeof(name) - 1;
+        }
+        onlp_telemetry_buf_varint(b, ids[i]);
+        onlp_telemetry_buf_svarint(b, f->exponent);
+        onlp_telemetry_buf_varint(b, len);
+        onlp_telemetry_buf_append(b, name, len);
+    }
+}
+
+int
+onlp_telemetry_metrics_sample(onlp_telemetry_buf_t* delta)
+{
+    struct timespec ts;
+    uint32_t i, n, offset;
+    metric_t* m;
+
+    metrics__.seq++;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    metrics__.time = (uint64_t)ts.tv_sec*1000 + ts.tv_nsec/1000000;
+
+    onlp_oid_iterate(ONLP_OID_SYS, 0, oid_sample__, NULL);
+#if ONLP_TELEMETRY_CONFIG_INCLUDE_SFP_DOM == 1
+    sfp_dom_sample__();
+#endif
+
+    offset = frame_begin__(delta, ONLP_TELEMETRY_FRAME_TYPE_DELTA);
+
+    /* Metrics which were not updated by this sample are gone. */
+    for(i = 0, n = 0; i < metrics__.count; i++) {
+        m = metrics__.metrics + i;
+        if(m->used && m->seen != metrics__.seq) {
+            metrics__.scratch[n++] = i + 1;
+        }
+    }
+    onlp_telemetry_buf_varint(delta, n);
+    for(i = 0; i < n; i++) {
+        onlp_telemetry_buf_varint(delta, metrics__.scratch[i]);
+        m = metrics__.metrics + metrics__.scratch[i] - 1;
+        aim_free(m->labels);
+        memset(m, 0, sizeof(*m));
+        metrics__.free[metrics__.nfree++] = metrics__.scratch[i];
+    }
+    if(n) {
+        index_rebuild__();
+    }
+
+    for(i = 0, n = 0; i < metrics__.count; i++) {
+        m = metrics__.metrics + i;
+        if(m->used && !m->defined) {
+            metrics__.scratch[n++] = i + 1;
+        }
+    }
+    frame_defs__(delta, metrics__.scratch, n);
+
+    for(i = 0, n = 0; i < metrics__.count; i++) {
+        m = metrics__.metrics + i;
+        if(m->used && (!m->defined || m->value != m->sent)) {
+            metrics__.scratch[n++] = i + 1;
+        }
+    }
+    onlp_telemetry_buf_varint(delta, n);
+    for(i = 0; i < n; i++) {
+        m = metrics__.metrics + metrics__.scratch[i] - 1;
+        onlp_telemetry_buf_varint(delta, metrics__.scratch[i]);
+        onlp_telemetry_buf_svarint(delta, m->defined ? m->value - m->sent : m->value);
+        m->sent = m->value;
+        m->defined = 1;
+    }
+
+    frame_end__(delta, offset);
+    return 0;
+}
+
+void
+onlp_telemetry_metrics_full(onlp_telemetry_buf_t* dst)
+{
+    uint32_t i, n, offset;
+    metric_t* m;
+
+    offset = frame_begin__(dst, ONLP_TELEMETRY_FRAME_TYPE_FULL);
+
+    /* No removals. */
+    onlp_telemetry_buf_varint(dst, 0);
+
+    for(i = 0, n = 0; i < metrics__.count; i++) {
+        if(metrics__.metrics[i].defined) {
+            metrics__.scratch[n++] = i + 1;
+        }
+    }
+    frame_defs__(dst, metrics__.scratch, n);
+
+    onlp_telemetry_buf_varint(dst, n);
+    for(i = 0; i < n; i++) {
+        m = metrics__.metrics + metrics__.scratch[i] - 1;
+        onlp_telemetry_buf_varint(dst, metrics__.scratch[i]);
+        onlp_telemetry_buf_svarint(dst, m->sent);
+    }
+
+    frame_end__(dst, offset);
+}
+
+static void
+decimal_printf__(onlp_telemetry_buf_t* b, int64_t value, int exponent)
+{
+    uint64_t magnitude = value < 0 ? -(uint64_t)value : (uint64_t)value;
+    uint64_t scale = 1;
+    int digits;
+
+    if(exponent >= 0) {
+        onlp_telemetry_buf_printf(b, "%" PRId64, value);
+        for(; exponent > 0; exponent--) {
+            onlp_telemetry_buf_append(b, "0", 1);
+        }
+        return;
+    }
+
+    for(digits = -exponent; digits > 0; digits--) {
+        scale *= 10;
+    }
+    onlp_telemetry_buf_printf(b, "%s%" PRIu64, value < 0 ? "-" : "",
+                              magnitude / scale);
+    magnitude %= scale;
+    if(magnitude) {
+        digits = -exponent;
+        while(magnitude % 10 == 0) {
+            magnitude /= 10;
+            digits--;
+        }
+        onlp_telemetry_buf_printf(b, ".%0*" PRIu64, digits, magnitude);
+    }
+}
+
+void
+onlp_telemetry_metrics_prometheus(onlp_telemetry_buf_t* dst)
+{
+    int f;
+    uint32_t i;
+
+    for(f = 0; f < FAMILY_COUNT; f++) {
+        int first = 1;
+        for(i = 0; i < metrics__.count; i++) {
+            metric_t* m = metrics__.metrics + i;
+            if(!m->defined || m->family != f) {
+                continue;
+            }
+            if(first) {
+                onlp_telemetry_buf_printf(dst, "# HELP %s %s\n# TYPE %s gauge\n",
+                                          families__[f].name, families__[f].help,
+                                          families__[f].name);
+                first = 0;
+            }
+            onlp_telemetry_buf_printf(dst, "%s{%s} ", families__[f].name, m->labels);
+            decimal_printf__(dst, m->sent, families__[f].exponent);
+            onlp_telemetry_buf_append(dst, "\n", 1);
+        }
+    }
+}
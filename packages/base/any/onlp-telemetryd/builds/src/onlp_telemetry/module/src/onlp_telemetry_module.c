@@ -0,0 +1,15 @@
+/**************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+#include <onlp_telemetry/onlp_telemetry_config.h>
+#include <onlp/onlp.h>
+#include "onlp_telemetry_log.h"
+#include "onlp_telemetry_int.h"
+
+void __onlp_telemetry_module_init__(void)
+{
+    AIM_LOG_STRUCT_REGISTER();
+    onlp_init();
+}
@@ -0,0 +1,453 @@
+/**************************************************************************//**
+ *
+ * Subscriber and HTTP listeners.
+ *
+ * A single thread polls the listeners and clients and takes a
+ * sample every period. Stream clients receive a FULL frame on
+ * connect and the DELTA frame of every sample after that. A
+ * client which does not keep up is disconnected once its
+ * pending output exceeds ONLP_TELEMETRY_CONFIG_CLIENT_BUFFER_MAX.
+ * HTTP clients are disconnected once idle for
+ * ONLP_TELEMETRY_CONFIG_HTTP_TIMEOUT, and TCP clients cannot take
+ * the slots reserved for Unix socket subscribers.
+ *
+ *****************************************************************************/
+#include <onlp_telemetry/onlp_telemetry_config.h>
+#include <AIM/aim.h>
+#include <onlp/onlp.h>
+#include <OS/os_time.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "onlp_telemetry_int.h"
+#include "onlp_telemetry_log.h"
+
+/** Largest HTTP request header accepted. */
+#define HTTP_REQUEST_MAX 4096
+
+typedef enum listener_type_e {
+    LISTENER_TYPE_UNIX,
+    LISTENER_TYPE_STREAM,
+    LISTENER_TYPE_PROMETHEUS,
+    LISTENER_TYPE_COUNT,
+} listener_type_t;
+
+typedef struct client_s {
+    int fd;
+    /** The listener the client connected to. */
+    listener_type_t type;
+    /** Prometheus HTTP client. */
+    int http;
+    /** The last read or write progress (monotonic usecs). */
+    uint64_t active;
+    /** Close once the output has been sent. */
+    int closing;
+    onlp_telemetry_buf_t in;
+    onlp_telemetry_buf_t out;
+} client_t;
+
+static struct {
+    onlp_telemetry_server_config_t config;
+    int listeners[LISTENER_TYPE_COUNT];
+    client_t clients[ONLP_TELEMETRY_CONFIG_CLIENTS_MAX];
+    onlp_telemetry_buf_t frame;
+    volatile sig_atomic_t stop;
+} server__;
+
+static int
+nonblocking__(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    if(flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        return ONLP_STATUS_E_INTERNAL;
+    }
+    return 0;
+}
+
+static int
+listen_unix__(const char* path)
+{
+    struct sockaddr_un addr;
+    char dir[sizeof(addr.sun_path)];
+    int fd;
+
+    if(strlen(path) >= sizeof(addr.sun_path)) {
+        AIM_LOG_ERROR("Socket path '%s' is too long.", path);
+        return -1;
+    }
+
+    strcpy(dir, path);
+    mkdir(dirname(dir), 0755);
+    unlink(path);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    if((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+        AIM_LOG_ERROR("socket(): %s", strerror(errno));
+        return -1;
+    }
+    if(bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+       listen(fd, 8) < 0) {
+        AIM_LOG_ERROR("Could not listen on '%s': %s", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    nonblocking__(fd);
+    return fd;
+}
+
+static int
+listen_tcp__(const char* address, int port)
+{
+    struct sockaddr_in addr;
+    int fd;
+    int on = 1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if(inet_pton(AF_INET, address, &addr.sin_addr) != 1) {
+        AIM_LOG_ERROR("Invalid listen address '%s'.", address);
+        return -1;
+    }
+
+    if((fd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
+        AIM_LOG_ERROR("socket(): %s", strerror(errno));
+        return -1;
+    }
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if(bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+       listen(fd, 8) < 0) {
+        AIM_LOG_ERROR("Could not listen on %s:%d: %s", address, port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    nonblocking__(fd);
+    return fd;
+}
+
+int
+onlp_telemetry_server_start(const onlp_telemetry_server_config_t* config)
+{
+    int i;
+
+    server__.config = *config;
+    for(i = 0; i < LISTENER_TYPE_COUNT; i++) {
+        server__.listeners[i] = -1;
+    }
+    for(i = 0; i < ONLP_TELEMETRY_CONFIG_CLIENTS_MAX; i++) {
+        server__.clients[i].fd = -1;
+    }
+
+    if(config->unix_path &&
+       (server__.listeners[LISTENER_TYPE_UNIX] = listen_unix__(config->unix_path)) < 0) {
+        return ONLP_STATUS_E_INTERNAL;
+    }
+    if(config->stream_port &&
+       (server__.listeners[LISTENER_TYPE_STREAM] = listen_tcp__(config->address, config->stream_port)) < 0) {
+        return ONLP_STATUS_E_INTERNAL;
+    }
+    if(config->prometheus_port &&
+       (server__.listeners[LISTENER_TYPE_PROMETHEUS] = listen_tcp__(config->address, config->prometheus_port)) < 0) {
+        return ONLP_STATUS_E_INTERNAL;
+    }
+    return 0;
+}
+
+static void
+client_close__(client_t* c)
+{
+    close(c->fd);
+    c->fd = -1;
+    onlp_telemetry_buf_free(&c->in);
+    onlp_telemetry_buf_free(&c->out);
+}
+
+static void
+client_flush__(client_t* c)
+{
+    while(c->out.len) {
+        ssize_t rv = send(c->fd, c->out.data, c->out.len, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if(rv < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            if(errno != EAGAIN && errno != EWOULDBLOCK) {
+                client_close__(c);
+            }
+            return;
+        }
+        onlp_telemetry_buf_consume(&c->out, rv);
+        c->active = os_time_monotonic();
+    }
+
+    if(c->closing) {
+        client_close__(c);
+    }
+}
+
+static void
+client_send__(client_t* c, const void* data, uint32_t len)
+{
+    onlp_telemetry_buf_append(&c->out, data, len);
+    client_flush__(c);
+    if(c->fd >= 0 && c->out.len > ONLP_TELEMETRY_CONFIG_CLIENT_BUFFER_MAX) {
+        AIM_LOG_WARN("Disconnecting slow subscriber (%u bytes pending).", c->out.len);
+        client_close__(c);
+    }
+}
+
+static void
+accept__(listener_type_t type)
+{
+    client_t* c = NULL;
+    int fd, i;
+
+    int tcp = 0;
+
+    if((fd = accept(server__.listeners[type], NULL, NULL)) < 0) {
+        return;
+    }
+
+    for(i = 0; i < ONLP_TELEMETRY_CONFIG_CLIENTS_MAX; i++) {
+        client_t* s = server__.clients + i;
+        if(s->fd < 0) {
+            if(c == NULL) {
+                c = s;
+            }
+        }
+        else if(s->type != LISTENER_TYPE_UNIX) {
+            tcp++;
+        }
+    }
+    if(c && type != LISTENER_TYPE_UNIX &&
+       tcp >= ONLP_TELEMETRY_CONFIG_CLIENTS_MAX - ONLP_TELEMETRY_CONFIG_CLIENTS_UNIX_RESERVED) {
+        c = NULL;
+    }
+    if(c == NULL) {
+        AIM_LOG_WARN("Too many clients. Connection refused.");
+        close(fd);
+        return;
+    }
+
+    nonblocking__(fd);
+    memset(c, 0, sizeof(*c));
+    c->fd = fd;
+    c->type = type;
+    c->http = (type == LISTENER_TYPE_PROMETHEUS);
+    c->active = os_time_monotonic();
+
+    if(!c->http) {
+        onlp_telemetry_buf_t full = { 0 };
+        onlp_telemetry_metrics_full(&full);
+        client_send__(c, full.data, full.len);
+        onlp_telemetry_buf_free(&full);
+    }
+}
+
+static void
+http_respond__(client_t* c)
+{
+    onlp_telemetry_buf_t body = { 0 };
+
+    if(strncmp((char*)c->in.data, "GET ", 4)) {
+        onlp_telemetry_buf_printf(&c->out,
+                                  "HTTP/1.0 405 Method Not Allowed\r\n"
+                                  "Content-Length: 0\r\n\r\n");
+    }
+    else {
+        onlp_telemetry_metrics_prometheus(&body);
+        onlp_telemetry_buf_printf(&c->out,
+                                  "HTTP/1.0 200 OK\r\n"
+                                  "Content-Type: text/plain; version=0.0.4\r\n"
+                                  "Content-Length: %u\r\n\r\n", body.len);
+        onlp_telemetry_buf_append(&c->out, body.data, body.len);
+        onlp_telemetry_buf_free(&body);
+    }
+
+    c->closing = 1;
+    client_flush__(c);
+}
+
+static void
+client_read__(client_t* c)
+{
+    char data[1024];
+    ssize_t rv = recv(c->fd, data, sizeof(data), 0);
+
+    if(rv == 0 || (rv < 0 && errno != EAGAIN && errno != EINTR)) {
+        client_close__(c);
+        return;
+    }
+    if(rv < 0 || !c->http || c->closing) {
+        /* Stream subscribers have nothing to say. */
+        return;
+    }
+    c->active = os_time_monotonic();
+
+    onlp_telemetry_buf_append(&c->in, data, rv);
+    onlp_telemetry_buf_append(&c->in, "", 1);
+    c->in.len--;
+    if(strstr((char*)c->in.data, "\r\n\r\n") || strstr((char*)c->in.data, "\n\n")) {
+        http_respond__(c);
+    }
+    else if(c->in.len > HTTP_REQUEST_MAX) {
+        client_close__(c);
+    }
+}
+
+/*
+ * Close idle HTTP clients and return the time the next one expires.
+ */
+static uint64_t
+http_expire__(uint64_t now, uint64_t next)
+{
+    int i;
+
+    for(i = 0; i < ONLP_TELEMETRY_CONFIG_CLIENTS_MAX; i++) {
+        client_t* c = server__.clients + i;
+        uint64_t expires;
+        if(c->fd < 0 || !c->http) {
+            continue;
+        }
+        expires = c->active + ONLP_TELEMETRY_CONFIG_HTTP_TIMEOUT;
+        if(now >= expires) {
+            client_close__(c);
+        }
+        else if(expires < next) {
+            next = expires;
+        }
+    }
+    return next;
+}
+
+static void
+sample__(void)
+{
+    int i;
+
+    server__.frame.len = 0;
+    onlp_telemetry_metrics_sample(&server__.frame);
+
+    for(i = 0; i < ONLP_TELEMETRY_CONFIG_CLIENTS_MAX; i++) {
+        client_t* c = server__.clients + i;
+        if(c->fd >= 0 && !c->http) {
+            client_send__(c, server__.frame.data, server__.frame.len);
+        }
+    }
+}
+
+int
+onlp_telemetry_server_run(void)
+{
+    struct pollfd fds[LISTENER_TYPE_COUNT + ONLP_TELEMETRY_CONFIG_CLIENTS_MAX];
+    client_t* clients[ONLP_TELEMETRY_CONFIG_CLIENTS_MAX];
+    uint64_t next = os_time_monotonic();
+    uint64_t wake;
+    int nfds, nclients, i, timeout;
+
+    while(!server__.stop) {
+        uint64_t now = os_time_monotonic();
+        if(now >= next) {
+            sample__();
+            next += server__.config.period;
+            if(next <= now) {
+                /* Sampling overran the period. Don't try to catch up. */
+                next = now + server__.config.period;
+            }
+        }
+        wake = http_expire__(os_time_monotonic(), next);
+
+        nfds = 0;
+        for(i = 0; i < LISTENER_TYPE_COUNT; i++) {
+            if(server__.listeners[i] >= 0) {
+                fds[nfds].fd = server__.listeners[i];
+                fds[nfds].events = POLLIN;
+                nfds++;
+            }
+        }
+        nclients = 0;
+        for(i = 0; i < ONLP_TELEMETRY_CONFIG_CLIENTS_MAX; i++) {
+            client_t* c = server__.clients + i;
+            if(c->fd >= 0) {
+                fds[nfds].fd = c->fd;
+                fds[nfds].events = POLLIN | (c->out.len ? POLLOUT : 0);
+                clients[nclients++] = c;
+                nfds++;
+            }
+        }
+
+        now = os_time_monotonic();
+        timeout = wake > now ? (wake - now + 999) / 1000 : 0;
+        if(poll(fds, nfds, timeout) < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            AIM_LOG_ERROR("poll(): %s", strerror(errno));
+            return ONLP_STATUS_E_INTERNAL;
+        }
+
+        nfds = 0;
+        for(i = 0; i < LISTENER_TYPE_COUNT; i++) {
+            if(server__.listeners[i] >= 0) {
+                if(fds[nfds].revents & POLLIN) {
+                    accept__(i);
+                }
+                nfds++;
+            }
+        }
+        for(i = 0; i < nclients; i++, nfds++) {
+            client_t* c = clients[i];
+            if(c->fd < 0) {
+                continue;
+            }
+            if(fds[nfds].revents & (POLLIN | POLLHUP | POLLERR)) {
+                client_read__(c);
+            }
+            if(c->fd >= 0 && (fds[nfds].revents & POLLOUT)) {
+                client_flush__(c);
+            }
+        }
+    }
+
+    return 0;
+}
+
+void
+onlp_telemetry_server_stop(void)
+{
+    server__.stop = 1;
+}
+
+void
+onlp_telemetry_server_close(void)
+{
+    int i;
+
+    for(i = 0; i < ONLP_TELEMETRY_CONFIG_CLIENTS_MAX; i++) {
+        if(server__.clients[i].fd >= 0) {
+            client_close__(server__.clients + i);
+        }
+    }
+    for(i = 0; i < LISTENER_TYPE_COUNT; i++) {
+        if(server__.listeners[i] >= 0) {
+            close(server__.listeners[i]);
+            server__.listeners[i] = -1;
+        }
+    }
+    if(server__.config.unix_path) {
+        unlink(server__.config.unix_path);
+    }
+    onlp_telemetry_buf_free(&server__.frame);
+}
@@ -193,6 +193,26 @@ int onlp_oid_iterate(onlp_oid_t oid, onlp_oid_type_t type,
  */
 int onlp_oid_hdr_get(onlp_oid_t oid, onlp_oid_hdr_t* hdr);
 
+/**
+ * @brief Bypass the OID info caches for the calling thread.
+ * @param bypass If true, info getters called from this thread
+ * always read from the platform.
+ * @returns The previous setting.
+ */
+int onlp_oid_cache_bypass(int bypass);
+
+/**
+ * @brief Discard cached OID info.
+ * @param oid The OID to discard, or 0 for all OIDs.
+ */
+void onlp_oid_cache_flush(onlp_oid_t oid);
+
+/**
+ * @brief Show the OID info cache hit and miss counters.
+ * @param pvs The output pvs.
+ */
+void onlp_oid_cache_stats_show(aim_pvs_t* pvs);
+
 
 
 
@@ -254,6 +254,266 @@
 #define ONLP_CONFIG_INCLUDE_API_PROFILING 0
 #endif
 
+/**
+ * ONLP_CONFIG_API_LOCK_DOMAINS
+ *
+ * If 1, API calls take a shared/exclusive lock for their subsystem (sys, thermal, fan, psu, led, sfp) instead of the single global lock. Read-only calls take their subsystem lock shared. Requires ONLP_CONFIG_API_LOCK_GLOBAL_SHARED. */
+
+
+#ifndef ONLP_CONFIG_API_LOCK_DOMAINS
+#define ONLP_CONFIG_API_LOCK_DOMAINS 0
+#endif
+
+/**
+ * ONLP_CONFIG_API_LOCK_SFP_GROUP_SIZE
+ *
+ * The number of consecutive SFP ports which share a port lock when ONLP_CONFIG_API_LOCK_DOMAINS is enabled. */
+
+
+#ifndef ONLP_CONFIG_API_LOCK_SFP_GROUP_SIZE
+#define ONLP_CONFIG_API_LOCK_SFP_GROUP_SIZE 8
+#endif
+
+/**
+ * ONLP_CONFIG_INCLUDE_API_STATS
+ *
+ * Include per-API call, lock wait and hold time statistics in shared memory. */
+
+
+#ifndef ONLP_CONFIG_INCLUDE_API_STATS
+#define ONLP_CONFIG_INCLUDE_API_STATS 1
+#endif
+
+/**
+ * ONLP_CONFIG_API_STATS_MAX
+ *
+ * The maximum number of distinct APIs tracked by the API statistics table. */
+
+
+#ifndef ONLP_CONFIG_API_STATS_MAX
+#define ONLP_CONFIG_API_STATS_MAX 128
+#endif
+
+/**
+ * ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT
+ *
+ * Include the shared telemetry snapshot. The platform manager publishes thermal, fan, and psu info into shared memory and the info getters are served from it while it is fresh. */
+
+
+#ifndef ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT
+#define ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT 0
+#endif
+
+/**
+ * ONLP_CONFIG_TELEMETRY_SNAPSHOT_RATE
+ *
+ * The telemetry snapshot publication period (in usecs). */
+
+
+#ifndef ONLP_CONFIG_TELEMETRY_SNAPSHOT_RATE
+#define ONLP_CONFIG_TELEMETRY_SNAPSHOT_RATE 1000000
+#endif
+
+/**
+ * ONLP_CONFIG_TELEMETRY_SNAPSHOT_MAX_AGE
+ *
+ * The maximum age (in usecs) of a telemetry snapshot entry which will be returned to callers. Older entries are read from the platform. */
+
+
+#ifndef ONLP_CONFIG_TELEMETRY_SNAPSHOT_MAX_AGE
+#define ONLP_CONFIG_TELEMETRY_SNAPSHOT_MAX_AGE 3000000
+#endif
+
+/**
+ * ONLP_CONFIG_TELEMETRY_SNAPSHOT_ID_MAX
+ *
+ * The largest thermal, fan, or psu id held in the telemetry snapshot. */
+
+
+#ifndef ONLP_CONFIG_TELEMETRY_SNAPSHOT_ID_MAX
+#define ONLP_CONFIG_TELEMETRY_SNAPSHOT_ID_MAX 64
+#endif
+
+/**
+ * ONLP_CONFIG_INCLUDE_OID_CACHE
+ *
+ * Include the per-process OID info cache for the thermal, fan, psu, and led info getters. */
+
+
+#ifndef ONLP_CONFIG_INCLUDE_OID_CACHE
+#define ONLP_CONFIG_INCLUDE_OID_CACHE 1
+#endif
+
+/**
+ * ONLP_CONFIG_THERMAL_CACHE_TTL
+ *
+ * The lifetime (in usecs) of cached thermal info. Zero disables caching for thermals. */
+
+
+#ifndef ONLP_CONFIG_THERMAL_CACHE_TTL
+#define ONLP_CONFIG_THERMAL_CACHE_TTL 500000
+#endif
+
+/**
+ * ONLP_CONFIG_FAN_CACHE_TTL
+ *
+ * The lifetime (in usecs) of cached fan info. Zero disables caching for fans. */
+
+
+#ifndef ONLP_CONFIG_FAN_CACHE_TTL
+#define ONLP_CONFIG_FAN_CACHE_TTL 500000
+#endif
+
+/**
+ * ONLP_CONFIG_PSU_CACHE_TTL
+ *
+ * The lifetime (in usecs) of cached psu info. Zero disables caching for psus. */
+
+
+#ifndef ONLP_CONFIG_PSU_CACHE_TTL
+#define ONLP_CONFIG_PSU_CACHE_TTL 500000
+#endif
+
+/**
+ * ONLP_CONFIG_LED_CACHE_TTL
+ *
+ * The lifetime (in usecs) of cached led info. Zero disables caching for leds. */
+
+
+#ifndef ONLP_CONFIG_LED_CACHE_TTL
+#define ONLP_CONFIG_LED_CACHE_TTL 500000
+#endif
+
+/**
+ * ONLP_CONFIG_OID_CACHE_ID_MAX
+ *
+ * The largest OID id held in the OID info cache. */
+
+
+#ifndef ONLP_CONFIG_OID_CACHE_ID_MAX
+#define ONLP_CONFIG_OID_CACHE_ID_MAX 64
+#endif
+
+/**
+ * ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_IDLE_CYCLES
+ *
+ * The number of consecutive unchanged polls after which the PSU and fan notification callbacks double their polling period. Zero disables back off. */
+
+
+#ifndef ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_IDLE_CYCLES
+#define ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_IDLE_CYCLES 10
+#endif
+
+/**
+ * ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_RATE_MAX
+ *
+ * The longest polling period (in usecs) for the PSU and fan notification callbacks. */
+
+
+#ifndef ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_RATE_MAX
+#define ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_RATE_MAX 4000000
+#endif
+
+/**
+ * ONLP_CONFIG_PLATFORM_MANAGE_WORKERS
+ *
+ * The number of worker threads which run platform management callbacks. Zero runs all callbacks serially on the platform management thread. */
+
+
+#ifndef ONLP_CONFIG_PLATFORM_MANAGE_WORKERS
+#define ONLP_CONFIG_PLATFORM_MANAGE_WORKERS 0
+#endif
+
+/**
+ * ONLP_CONFIG_PLATFORM_MANAGE_INTERRUPT_SAFETY_RATE
+ *
+ * The minimum period in microseconds of platform management callbacks which are also triggered by interrupts. */
+
+
+#ifndef ONLP_CONFIG_PLATFORM_MANAGE_INTERRUPT_SAFETY_RATE
+#define ONLP_CONFIG_PLATFORM_MANAGE_INTERRUPT_SAFETY_RATE 30000000
+#endif
+
+/**
+ * ONLP_CONFIG_INCLUDE_SFP_DOM_MONITOR
+ *
+ * Include the SFP DOM monitor. */
+
+
+#ifndef ONLP_CONFIG_INCLUDE_SFP_DOM_MONITOR
+#define ONLP_CONFIG_INCLUDE_SFP_DOM_MONITOR 1
+#endif
+
+/**
+ * ONLP_CONFIG_SFP_DOM_MONITOR_RATE
+ *
+ * The DOM monitor polling period in microseconds. */
+
+
+#ifndef ONLP_CONFIG_SFP_DOM_MONITOR_RATE
+#define ONLP_CONFIG_SFP_DOM_MONITOR_RATE 100000
+#endif
+
+/**
+ * ONLP_CONFIG_SFP_DOM_MONITOR_INTERVAL
+ *
+ * The minimum time in microseconds between DOM refreshes of the same port. */
+
+
+#ifndef ONLP_CONFIG_SFP_DOM_MONITOR_INTERVAL
+#define ONLP_CONFIG_SFP_DOM_MONITOR_INTERVAL 2000000
+#endif
+
+/**
+ * ONLP_CONFIG_SFP_DOM_MONITOR_BUDGET
+ *
+ * The maximum number of EEPROM bytes the DOM monitor reads per polling period. */
+
+
+#ifndef ONLP_CONFIG_SFP_DOM_MONITOR_BUDGET
+#define ONLP_CONFIG_SFP_DOM_MONITOR_BUDGET 256
+#endif
+
+/**
+ * ONLP_CONFIG_SFP_DOM_MONITOR_SUBSCRIBERS_MAX
+ *
+ * The maximum number of DOM monitor event subscribers. */
+
+
+#ifndef ONLP_CONFIG_SFP_DOM_MONITOR_SUBSCRIBERS_MAX
+#define ONLP_CONFIG_SFP_DOM_MONITOR_SUBSCRIBERS_MAX 8
+#endif
+
+/**
+ * ONLP_CONFIG_INCLUDE_SFP_INVENTORY
+ *
+ * Include the shared SFP inventory cache. */
+
+
+#ifndef ONLP_CONFIG_INCLUDE_SFP_INVENTORY
+#define ONLP_CONFIG_INCLUDE_SFP_INVENTORY 1
+#endif
+
+/**
+ * ONLP_CONFIG_SFP_INVENTORY_VERIFY_INTERVAL
+ *
+ * The interval in microseconds at which cached SFP inventory entries are verified against the module checksums and serial number. */
+
+
+#ifndef ONLP_CONFIG_SFP_INVENTORY_VERIFY_INTERVAL
+#define ONLP_CONFIG_SFP_INVENTORY_VERIFY_INTERVAL 10000000
+#endif
+
+/**
+ * ONLP_CONFIG_SFP_SWEEP_WORKERS_MAX
+ *
+ * The maximum number of threads used to sweep SFP ports on independent buses. */
+
+
+#ifndef ONLP_CONFIG_SFP_SWEEP_WORKERS_MAX
+#define ONLP_CONFIG_SFP_SWEEP_WORKERS_MAX 16
+#endif
+
 
 
 /**
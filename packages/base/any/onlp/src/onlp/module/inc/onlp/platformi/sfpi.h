@@ -43,6 +43,19 @@ int onlp_sfpi_init(void);
  */
 int onlp_sfpi_bitmap_get(onlp_sfp_bitmap_t* bmap);
 
+/**
+ * @brief Get the bus a port's module is attached to.
+ * @param port The port number.
+ * @param [out] bus Receives a platform-defined bus number.
+ * @note This is optional. Ports on different buses may be accessed
+ * concurrently. Ports on the same bus are always accessed serially.
+ * Report the physical segment, not the mux channel: ports behind
+ * muxes on the same i2c adapter should report that adapter
+ * (see onlp_i2c_bus_root()).
+ * The topology is read once when the SFP subsystem is initialized.
+ */
+int onlp_sfpi_port_bus_get(int port, int* bus);
+
 /**
  * @brief Determine if an SFP is present.
  * @param port The port number.
@@ -119,6 +132,20 @@ int onlp_sfpi_dev_write(int port, uint8_t devaddr, uint8_t addr, uint8_t* data,
  */
 int onlp_sfpi_dom_read(int port, uint8_t data[256]);
 
+/**
+ * @brief Read part of a page of the module's EEPROM.
+ * @param port The port number.
+ * @param devaddr The device address.
+ * @param page The page number.
+ * @param offset The offset of the first byte.
+ * @param len The number of bytes to read.
+ * @param dst Receives the data.
+ * @note This is optional. If it is not implemented the page is
+ * selected and read using onlp_sfpi_dev_writeb() and onlp_sfpi_dev_read().
+ */
+int onlp_sfpi_eeprom_readv(int port, uint8_t devaddr, int page,
+                           int offset, int len, uint8_t* dst);
+
 /**
  * @brief Perform any actions required after an SFP is inserted.
  * @param port The port number.
@@ -154,6 +181,16 @@ int onlp_sfpi_control_set(int port, onlp_sfp_control_t control, int value);
  */
 int onlp_sfpi_control_get(int port, onlp_sfp_control_t control, int* value);
 
+/**
+ * @brief Get an SFP control for all SFP ports.
+ * @param control The control.
+ * @param [out] dst Receives the bitmap of ports on which the control is set.
+ * @note This is optional. Implement it if the platform can read the
+ * control for all ports at once, for example from a single CPLD
+ * register. Otherwise onlp_sfpi_control_get() is called for each port.
+ */
+int onlp_sfpi_control_bitmap_get(onlp_sfp_control_t control, onlp_sfp_bitmap_t* dst);
+
 /**
  * @brief Remap SFP user SFP port numbers before calling the SFPI interface.
  * @param port The user SFP port number.
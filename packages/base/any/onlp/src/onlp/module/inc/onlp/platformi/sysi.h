@@ -132,6 +132,8 @@ int onlp_sysi_ioctl(int code, va_list vargs);
 
 /**
  * @brief Platform management initialization.
+ * @note Platforms may register additional management callbacks
+ * or change callback rates here. See onlp_sys_platform_manage_register().
  */
 int onlp_sysi_platform_manage_init(void);
 
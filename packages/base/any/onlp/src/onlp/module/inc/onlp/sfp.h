@@ -72,6 +72,11 @@ int onlp_sfp_init(void);
  */
 typedef aim_bitmap256_t onlp_sfp_bitmap_t;
 
+/**
+ * The number of ports an SFP bitmap can hold.
+ */
+#define ONLP_SFP_PORT_COUNT_MAX 256
+
 /**
  * Convenience function for initializing SFP bitmaps.
  * @param bmap The address of the bitmap to initialize.
@@ -131,6 +136,25 @@ int onlp_sfp_eeprom_read(int port, uint8_t** rv);
  */
 int onlp_sfp_dom_read(int port, uint8_t** rv);
 
+/**
+ * @brief Read part of a page of the module's EEPROM.
+ * @param port The SFP Port
+ * @param devaddr The device address (0x50 or 0x51).
+ * @param page The page number. Only used when the read covers the
+ * upper half (offset 128 and above) of the device address space.
+ * @param offset The offset of the first byte (0 - 255).
+ * @param len The number of bytes to read.
+ * @param dst Receives the data.
+ * @returns 0 on success.
+ * @returns ONLP_STATUS_E_UNSUPPORTED if the module does not support
+ * the requested page.
+ * @note Pages are selected through byte 127 as defined by SFF-8472,
+ * SFF-8636, and CMIS. Page 0 is restored after the read. CMIS banks
+ * other than 0 are not supported.
+ */
+int onlp_sfp_eeprom_readv(int port, uint8_t devaddr, int page,
+                          int offset, int len, uint8_t* dst);
+
 /**
  * @brief Deinitialize the SFP subsystem.
  */
@@ -224,6 +248,77 @@ int onlp_sfp_control_get(int port, onlp_sfp_control_t control, int* value);
  */
 int onlp_sfp_control_flags_get(int port, uint32_t* flags);
 
+/**
+ * @brief Get the value of an SFP control for all ports.
+ * @param control The control.
+ * @param dst Receives the bitmap of ports on which the control is set.
+ * @note If the SFPI driver does not support batch collection of the
+ * control it is generated from onlp_sfp_control_get() on the present
+ * ports. Absent ports are left clear.
+ * @returns The first port error, or ONLP_STATUS_E_UNSUPPORTED if no
+ * port supports the control.
+ */
+int onlp_sfp_control_bitmap_get(onlp_sfp_control_t control, onlp_sfp_bitmap_t* dst);
+
+/**
+ * @brief SFP inventory iteration callback.
+ * @param cookie The iteration cookie.
+ * @param port The port.
+ * @param status 0 if a module is present and its EEPROM is available,
+ * ONLP_STATUS_E_MISSING if the port is empty, or the EEPROM read error.
+ * @param sff The parsed EEPROM. NULL unless status is 0.
+ */
+typedef void (*onlp_sfp_inventory_f)(void* cookie, int port, int status,
+                                     const sff_eeprom_t* sff);
+
+/**
+ * @brief Refresh the SFP inventory cache.
+ * @note The inventory is shared by all ONLP clients. A port's EEPROM
+ * is only read when the presence bitmap shows an insertion, or when
+ * the periodic verification of the checksums and serial number shows
+ * the module was replaced.
+ * onlp_sfp_post_insert() is called once for each insertion.
+ */
+int onlp_sfp_inventory_refresh(void);
+
+/**
+ * @brief Get a port's cached inventory entry.
+ * @param port The port.
+ * @param [out] sff Receives the parsed EEPROM.
+ * @returns ONLP_STATUS_E_MISSING if the port is empty or not yet inventoried.
+ */
+int onlp_sfp_inventory_get(int port, sff_eeprom_t* sff);
+
+/**
+ * @brief Refresh the SFP inventory and iterate over all ports.
+ * @param cb The callback, called once for each SFP port.
+ * @param cookie The callback cookie.
+ * @note The callback is called without the inventory locks held.
+ */
+int onlp_sfp_inventory_iterate(onlp_sfp_inventory_f cb, void* cookie);
+
+/**
+ * @brief SFP sweep function.
+ * @param port The port.
+ * @param cookie The sweep cookie.
+ * @returns The port's result.
+ */
+typedef int (*onlp_sfp_sweep_f)(int port, void* cookie);
+
+/**
+ * @brief Call a function for a set of ports.
+ * @param ports The ports.
+ * @param fn The function.
+ * @param cookie The function cookie.
+ * @param [out] results Optional. Receives each port's result, indexed
+ * by port. Must have room for ONLP_SFP_PORT_COUNT_MAX entries.
+ * @note Ports are grouped by the bus reported by onlp_sfpi_port_bus_get().
+ * Each group is serviced by its own thread, so the function must be
+ * thread safe. Ports within a group are serviced in order.
+ */
+int onlp_sfp_sweep(onlp_sfp_bitmap_t* ports, onlp_sfp_sweep_f fn, void* cookie,
+                   int* results);
+
 /******************************************************************************
  *
  * Enumeration Support Definitions.
@@ -0,0 +1,178 @@
+/************************************************************
+ * <bsn.cl fy=2014 v=onl>
+ *
+ *        Copyright 2014, 2015 Big Switch Networks, Inc.
+ *
+ * Licensed under the Eclipse Public License, Version 1.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ *        http://www.eclipse.org/legal/epl-v10.html
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the
+ * License.
+ *
+ * </bsn.cl>
+ ************************************************************
+ *
+ * SFP DOM Monitor.
+ *
+ * The DOM monitor keeps a parsed copy of the digital diagnostics
+ * of every present module. Ports are refreshed round-robin within
+ * a per-period bus budget. Only the live value ranges are re-read;
+ * thresholds are read once when a module is inserted.
+ *
+ ***********************************************************/
+#ifndef __ONLP_SFP_DOM_H__
+#define __ONLP_SFP_DOM_H__
+
+#include <onlp/onlp_config.h>
+#include <onlp/onlp.h>
+#include <AIM/aim_pvs.h>
+
+#define ONLP_SFP_DOM_LANES_MAX 8
+
+typedef enum onlp_sfp_dom_type_e {
+    /** The module does not implement diagnostics. */
+    ONLP_SFP_DOM_TYPE_NONE,
+    /** SFP (SFF-8472) */
+    ONLP_SFP_DOM_TYPE_SFF8472,
+    /** QSFP (SFF-8636) */
+    ONLP_SFP_DOM_TYPE_SFF8636,
+    /** QSFP-DD, OSFP (CMIS) */
+    ONLP_SFP_DOM_TYPE_CMIS,
+} onlp_sfp_dom_type_t;
+
+typedef enum onlp_sfp_dom_value_e {
+    ONLP_SFP_DOM_VALUE_TEMP,
+    ONLP_SFP_DOM_VALUE_VCC,
+    ONLP_SFP_DOM_VALUE_BIAS,
+    ONLP_SFP_DOM_VALUE_TX_POWER,
+    ONLP_SFP_DOM_VALUE_RX_POWER,
+    ONLP_SFP_DOM_VALUE_COUNT,
+} onlp_sfp_dom_value_t;
+
+typedef enum onlp_sfp_dom_level_e {
+    ONLP_SFP_DOM_LEVEL_HIGH_ALARM,
+    ONLP_SFP_DOM_LEVEL_LOW_ALARM,
+    ONLP_SFP_DOM_LEVEL_HIGH_WARNING,
+    ONLP_SFP_DOM_LEVEL_LOW_WARNING,
+    ONLP_SFP_DOM_LEVEL_COUNT,
+} onlp_sfp_dom_level_t;
+
+/**
+ * The threshold flag for the given value and level.
+ */
+#define ONLP_SFP_DOM_FLAG(_value, _level) \
+    (1U << ((_value) * ONLP_SFP_DOM_LEVEL_COUNT + (_level)))
+
+/**
+ * Parsed DOM record.
+ *
+ * Temperatures are in milli-degrees C, voltages in microvolts,
+ * bias currents in microamps, and optical powers in tenths of
+ * a microwatt.
+ */
+typedef struct onlp_sfp_dom_s {
+    onlp_sfp_dom_type_t type;
+
+    /** The number of valid lanes in the per-lane values. */
+    int lanes;
+
+    /** Incremented on every refresh. */
+    uint32_t seq;
+
+    /** The time of the last refresh (monotonic usecs). */
+    uint64_t updated;
+
+    int32_t temp;
+    int32_t vcc;
+    int32_t bias[ONLP_SFP_DOM_LANES_MAX];
+    int32_t tx_power[ONLP_SFP_DOM_LANES_MAX];
+    int32_t rx_power[ONLP_SFP_DOM_LANES_MAX];
+
+    /** Thresholds, indexed by value and level. Zero if unavailable. */
+    int32_t thresholds[ONLP_SFP_DOM_VALUE_COUNT][ONLP_SFP_DOM_LEVEL_COUNT];
+
+    /** The threshold flags currently crossed. See ONLP_SFP_DOM_FLAG(). */
+    uint32_t flags;
+
+} onlp_sfp_dom_t;
+
+typedef enum onlp_sfp_dom_event_e {
+    /** A module was inserted and its first record is available. */
+    ONLP_SFP_DOM_EVENT_INSERT = (1 << 0),
+    /** A module was removed. */
+    ONLP_SFP_DOM_EVENT_REMOVE = (1 << 1),
+    /** The live values changed. */
+    ONLP_SFP_DOM_EVENT_CHANGE = (1 << 2),
+    /** The threshold flags changed. */
+    ONLP_SFP_DOM_EVENT_THRESHOLD = (1 << 3),
+} onlp_sfp_dom_event_t;
+
+/**
+ * @brief DOM event handler.
+ * @param cookie The subscription cookie.
+ * @param port The port.
+ * @param events The events which occurred (onlp_sfp_dom_event_t flags).
+ * @param dom The port's new record.
+ * @param flags The previous threshold flags.
+ * @note Handlers are called on the thread polling the monitor.
+ */
+typedef void (*onlp_sfp_dom_handler_f)(void* cookie, int port, uint32_t events,
+                                       const onlp_sfp_dom_t* dom, uint32_t flags);
+
+/**
+ * @brief Start the DOM monitor.
+ * @note This registers the "sfp-dom" platform management callback.
+ * Processes which do not run the platform manager may call
+ * onlp_sfp_dom_monitor_poll() periodically instead.
+ */
+int onlp_sfp_dom_monitor_start(void);
+
+/**
+ * @brief Stop the DOM monitor.
+ */
+int onlp_sfp_dom_monitor_stop(void);
+
+/**
+ * @brief Perform one DOM monitor polling period.
+ * @returns > 0 if any port changed, 0 if not, negative on error.
+ */
+int onlp_sfp_dom_monitor_poll(void);
+
+/**
+ * @brief Get the cached DOM record for a port.
+ * @param port The port.
+ * @param [out] dom Receives the record.
+ * @returns ONLP_STATUS_E_MISSING if the port has no record.
+ */
+int onlp_sfp_dom_get(int port, onlp_sfp_dom_t* dom);
+
+/**
+ * @brief Subscribe to DOM events.
+ * @param events The events of interest (onlp_sfp_dom_event_t flags).
+ * @param handler The handler.
+ * @param cookie The handler cookie.
+ */
+int onlp_sfp_dom_subscribe(uint32_t events, onlp_sfp_dom_handler_f handler,
+                           void* cookie);
+
+/**
+ * @brief Cancel a DOM event subscription.
+ * @param handler The handler.
+ * @param cookie The handler cookie.
+ */
+int onlp_sfp_dom_unsubscribe(onlp_sfp_dom_handler_f handler, void* cookie);
+
+/**
+ * @brief Show the cached DOM records.
+ * @param pvs The output pvs.
+ */
+void onlp_sfp_dom_show(aim_pvs_t* pvs);
+
+#endif /* __ONLP_SFP_DOM_H__ */
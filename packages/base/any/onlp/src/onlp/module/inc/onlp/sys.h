@@ -30,6 +30,7 @@
 #include <onlp/onlp.h>
 #include <onlplib/onie.h>
 #include <onlplib/pi.h>
+#include <onlplib/gpio.h>
 #include <onlp/oids.h>
 
 
@@ -122,6 +123,89 @@ int onlp_sys_platform_manage_join(void);
 
 void onlp_sys_platform_manage_now(void);
 
+/**
+ * @brief Register a platform management callback.
+ * @param name The callback name. This is used to look up rate overrides
+ * in the "platform-manager" section of the configuration file.
+ * @param manage The callback. It should return > 0 if it observed a
+ * change in platform state, 0 if nothing changed, and < 0 on error.
+ * @param rate The callback period in microseconds.
+ * @note This may be called from onlp_sysi_platform_manage_init() or
+ * from a management callback.
+ */
+int onlp_sys_platform_manage_register(const char* name, int (*manage)(void),
+                                      uint64_t rate);
+
+/**
+ * @brief Unregister a platform management callback.
+ * @param name The callback name.
+ */
+int onlp_sys_platform_manage_unregister(const char* name);
+
+/**
+ * @brief Change the period of a platform management callback.
+ * @param name The callback name.
+ * @param rate The new period in microseconds.
+ * @note A callback may use this to poll faster while a value
+ * is near a threshold and slower when it is stable.
+ * This also becomes the base rate which idle backoff starts from.
+ */
+int onlp_sys_platform_manage_rate_set(const char* name, uint64_t rate);
+
+/**
+ * @brief Get the current period of a platform management callback.
+ * @param name The callback name.
+ * @param rate [out] Receives the period in microseconds.
+ */
+int onlp_sys_platform_manage_rate_get(const char* name, uint64_t* rate);
+
+/**
+ * @brief Configure adaptive back off for a platform management callback.
+ * @param name The callback name.
+ * @param rate_max The longest period in microseconds.
+ * @param idle_cycles After this many consecutive calls that report no change
+ * the period is doubled, up to rate_max. A call reporting a change
+ * restores the registered period. Zero disables back off.
+ */
+int onlp_sys_platform_manage_backoff_set(const char* name, uint64_t rate_max,
+                                         int idle_cycles);
+
+/**
+ * @brief Show the platform management callback statistics.
+ * @param pvs The output pvs.
+ * @note Calls which run longer than their period are counted as overruns.
+ */
+void onlp_sys_platform_manage_stats_show(aim_pvs_t* pvs);
+
+/**
+ * @brief Trigger platform management callbacks from a GPIO interrupt.
+ * @param gpio The gpio number.
+ * @param edge The interrupt edge.
+ * @param callbacks Comma separated list of callback names to run
+ * immediately when the interrupt fires.
+ * @param oids The OIDs whose cached state is discarded when the
+ * interrupt fires. May be NULL.
+ * @param count The number of OIDs.
+ * @note The named callbacks continue to run as a safety scan at no
+ * less than ONLP_CONFIG_PLATFORM_MANAGE_INTERRUPT_SAFETY_RATE.
+ * @note This may be called from onlp_sysi_platform_manage_init().
+ */
+int onlp_sys_platform_manage_interrupt_gpio(int gpio, onlp_gpio_edge_t edge,
+                                            const char* callbacks,
+                                            const onlp_oid_t* oids, int count);
+
+/**
+ * @brief Trigger platform management callbacks from a sysfs attribute.
+ * @param path The attribute path. Its driver must call sysfs_notify().
+ * @param callbacks Comma separated list of callback names.
+ * @param oids The OIDs whose cached state is discarded. May be NULL.
+ * @param count The number of OIDs.
+ * @note See onlp_sys_platform_manage_interrupt_gpio().
+ */
+int onlp_sys_platform_manage_interrupt_file(const char* path,
+                                            const char* callbacks,
+                                            const onlp_oid_t* oids, int count);
+
 int onlp_sys_debug(aim_pvs_t* pvs, int argc, char** argv);
 
 #endif /* __ONLP_SYS_H_ */
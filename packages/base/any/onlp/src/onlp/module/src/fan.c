@@ -27,6 +27,8 @@
 #include <onlp/oids.h>
 #include "onlp_int.h"
 #include "onlp_locks.h"
+#include "onlp_oid_cache.h"
+#include "onlp_snapshot.h"
 #include "onlp_log.h"
 #include "onlp_json.h"
 
@@ -85,7 +87,7 @@ onlp_fani_info_from_json__(cJSON* data, onlp_fan_info_t* fip, int errorcheck)
 #endif
 
 static int
-onlp_fan_info_get_locked__(onlp_oid_t oid, onlp_fan_info_t* fip)
+onlp_fan_info_read_locked__(onlp_oid_t oid, onlp_fan_info_t* fip)
 {
     int rv;
 
@@ -117,7 +119,29 @@ onlp_fan_info_get_locked__(onlp_oid_t oid, onlp_fan_info_t* fip)
 
     return rv;
 }
-ONLP_LOCKED_API2(onlp_fan_info_get, onlp_oid_t, oid, onlp_fan_info_t*, fip);
+ONLP_LOCKED_API2(onlp_fan_info_read, onlp_oid_t, oid, onlp_fan_info_t*, fip);
+
+int
+onlp_fan_info_get(onlp_oid_t oid, onlp_fan_info_t* fip)
+{
+    int rv;
+    uint32_t gen;
+
+    if(onlp_oid_cache_get(oid, fip, sizeof(*fip), &gen) == ONLP_STATUS_OK) {
+        return ONLP_STATUS_OK;
+    }
+#if ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT == 1
+    if(!onlp_oid_cache_bypassed() &&
+       onlp_snapshot_get(oid, fip, sizeof(*fip)) == ONLP_STATUS_OK) {
+        return ONLP_STATUS_OK;
+    }
+#endif
+    rv = onlp_fan_info_read(oid, fip);
+    if(rv >= 0) {
+        onlp_oid_cache_put(oid, fip, sizeof(*fip), gen);
+    }
+    return rv;
+}
 
 static int
 onlp_fan_status_get_locked__(onlp_oid_t oid, uint32_t* status)
@@ -177,13 +201,26 @@ onlp_fan_present__(onlp_oid_t id, onlp_fan_info_t* info)
     } while(0)
 
 
+/*
+ * Cached info is stale once the platform has been asked to change state.
+ */
+static int
+onlp_fan_set_done__(onlp_oid_t id, int rv)
+{
+    onlp_oid_cache_flush(id);
+#if ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT == 1
+    onlp_snapshot_invalidate(id);
+#endif
+    return rv;
+}
+
 static int
 onlp_fan_rpm_set_locked__(onlp_oid_t id, int rpm)
 {
     onlp_fan_info_t info;
     ONLP_FAN_PRESENT_OR_RETURN(id, &info);
     if(info.caps & ONLP_FAN_CAPS_SET_RPM) {
-        return onlp_fani_rpm_set(id, rpm);
+        return onlp_fan_set_done__(id, onlp_fani_rpm_set(id, rpm));
     }
     else {
         return ONLP_STATUS_E_UNSUPPORTED;
@@ -197,7 +234,7 @@ onlp_fan_percentage_set_locked__(onlp_oid_t id, int p)
     onlp_fan_info_t info;
     ONLP_FAN_PRESENT_OR_RETURN(id, &info);
     if(info.caps & ONLP_FAN_CAPS_SET_PERCENTAGE) {
-        return onlp_fani_percentage_set(id, p);
+        return onlp_fan_set_done__(id, onlp_fani_percentage_set(id, p));
     }
     else {
         return ONLP_STATUS_E_UNSUPPORTED;
@@ -210,7 +247,7 @@ onlp_fan_mode_set_locked__(onlp_oid_t id, onlp_fan_mode_t mode)
 {
     onlp_fan_info_t info;
     ONLP_FAN_PRESENT_OR_RETURN(id, &info);
-    return onlp_fani_mode_set(id, mode);
+    return onlp_fan_set_done__(id, onlp_fani_mode_set(id, mode));
 }
 ONLP_LOCKED_API2(onlp_fan_mode_set, onlp_oid_t, id, onlp_fan_mode_t, mode);
 
@@ -221,7 +258,7 @@ onlp_fan_dir_set_locked__(onlp_oid_t id, onlp_fan_dir_t dir)
     ONLP_FAN_PRESENT_OR_RETURN(id, &info);
     if( (info.caps & ONLP_FAN_CAPS_B2F) &&
         (info.caps & ONLP_FAN_CAPS_F2B) ) {
-        return onlp_fani_dir_set(id, dir);
+        return onlp_fan_set_done__(id, onlp_fani_dir_set(id, dir));
     }
     else {
         return ONLP_STATUS_E_UNSUPPORTED;
@@ -28,6 +28,7 @@
 #include <onlp/platformi/ledi.h>
 #include "onlp_int.h"
 #include "onlp_locks.h"
+#include "onlp_oid_cache.h"
 
 #define VALIDATE(_id)                           \
     do {                                        \
@@ -77,12 +78,28 @@ onlp_led_init_locked__(void)
 ONLP_LOCKED_API0(onlp_led_init);
 
 static int
-onlp_led_info_get_locked__(onlp_oid_t id, onlp_led_info_t* info)
+onlp_led_info_read_locked__(onlp_oid_t id, onlp_led_info_t* info)
 {
     VALIDATE(id);
     return onlp_ledi_info_get(id, info);
 }
-ONLP_LOCKED_API2(onlp_led_info_get, onlp_oid_t, id, onlp_led_info_t*, info);
+ONLP_LOCKED_API2(onlp_led_info_read, onlp_oid_t, id, onlp_led_info_t*, info);
+
+int
+onlp_led_info_get(onlp_oid_t id, onlp_led_info_t* info)
+{
+    int rv;
+    uint32_t gen;
+
+    if(onlp_oid_cache_get(id, info, sizeof(*info), &gen) == ONLP_STATUS_OK) {
+        return ONLP_STATUS_OK;
+    }
+    rv = onlp_led_info_read(id, info);
+    if(rv >= 0) {
+        onlp_oid_cache_put(id, info, sizeof(*info), gen);
+    }
+    return rv;
+}
 
 static int
 onlp_led_status_get_locked__(onlp_oid_t id, uint32_t* status)
@@ -116,13 +133,23 @@ onlp_led_hdr_get_locked__(onlp_oid_t id, onlp_oid_hdr_t* hdr)
 }
 ONLP_LOCKED_API2(onlp_led_hdr_get, onlp_oid_t, id, onlp_oid_hdr_t*, hdr);
 
+/*
+ * Cached info is stale once the platform has been asked to change state.
+ */
+static int
+onlp_led_set_done__(onlp_oid_t id, int rv)
+{
+    onlp_oid_cache_flush(id);
+    return rv;
+}
+
 static int
 onlp_led_set_locked__(onlp_oid_t id, int on_or_off)
 {
     onlp_led_info_t info;
     ONLP_LED_PRESENT_OR_RETURN(id, &info);
     if(info.caps & ONLP_LED_CAPS_ON_OFF) {
-        return onlp_ledi_set(id, on_or_off);
+        return onlp_led_set_done__(id, onlp_ledi_set(id, on_or_off));
     }
     else {
         return ONLP_STATUS_E_UNSUPPORTED;
@@ -141,7 +168,7 @@ onlp_led_mode_set_locked__(onlp_oid_t id, onlp_led_mode_t mode)
      * the capability bit positions.
      */
     if(info.caps & (1 << mode)) {
-        return onlp_ledi_mode_set(id, mode);
+        return onlp_led_set_done__(id, onlp_ledi_mode_set(id, mode));
     }
     else {
         return ONLP_STATUS_E_UNSUPPORTED;
@@ -160,7 +187,7 @@ onlp_led_char_set_locked__(onlp_oid_t id, char c)
      * the capability bit positions.
      */
     if(info.caps & ONLP_LED_CAPS_CHAR) {
-        return onlp_ledi_char_set(id, c);
+        return onlp_led_set_done__(id, onlp_ledi_char_set(id, c));
     }
     else {
         return ONLP_STATUS_E_UNSUPPORTED;
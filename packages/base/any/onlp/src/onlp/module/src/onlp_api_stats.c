@@ -0,0 +1,243 @@
+/************************************************************
+ * <bsn.cl fy=2014 v=onl>
+ *
+ *        Copyright 2014, 2015 Big Switch Networks, Inc.
+ *
+ * Licensed under the Eclipse Public License, Version 1.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ *        http://www.eclipse.org/legal/epl-v10.html
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the
+ * License.
+ *
+ * </bsn.cl>
+ ************************************************************
+ *
+ * Per-API call statistics.
+ *
+ * The statistics table lives in shared memory so the counters
+ * reflect all ONLP clients on the system. Entries are allocated
+ * by API name on first use. Counters are updated with atomic
+ * operations and never take the allocation lock.
+ *
+ ***********************************************************/
+#include <onlp/onlp_config.h>
+#include <onlp/onlp.h>
+#include "onlp_locks.h"
+
+#if ONLP_CONFIG_INCLUDE_API_STATS == 1
+
+#include <onlplib/shlocks.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ONLP_API_STATS_KEY       0xF00DF300
+#define ONLP_API_STATS_LOCK_KEY  0xF00DF301
+#define ONLP_API_STATS_MAGIC     0xABCD0001
+
+/* Call latency histogram buckets. Bucket N counts calls of [2^(N-1), 2^N) usecs. */
+#define ONLP_API_STATS_HIST_BUCKETS 28
+
+typedef struct onlp_api_stats_entry_s {
+    char name[48];
+
+    uint64_t calls;
+
+    uint64_t wait_total;
+    uint64_t wait_max;
+    pid_t wait_max_pid;
+
+    uint64_t hold_total;
+    uint64_t hold_max;
+    pid_t hold_max_pid;
+
+    uint64_t hist[ONLP_API_STATS_HIST_BUCKETS];
+} onlp_api_stats_entry_t;
+
+typedef struct onlp_api_stats_table_s {
+    uint32_t magic;
+    /* Number of allocated entries. Entries are never freed. */
+    uint32_t count;
+    /* Time of the last clear (monotonic usecs). */
+    uint64_t cleared;
+    onlp_api_stats_entry_t entries[ONLP_CONFIG_API_STATS_MAX];
+} onlp_api_stats_table_t;
+
+static onlp_api_stats_table_t* table__ = NULL;
+static onlp_shlock_t* table_lock__ = NULL;
+static pthread_once_t table_once__ = PTHREAD_ONCE_INIT;
+
+static void
+table_init__(void)
+{
+    onlp_api_stats_table_t* t = NULL;
+
+    if(onlp_shlock_create(ONLP_API_STATS_LOCK_KEY, &table_lock__,
+                          "onlp-api-stats-lock") < 0) {
+        return;
+    }
+    if(onlp_shmem_create(ONLP_API_STATS_KEY, sizeof(*t), (void**)&t) < 0) {
+        AIM_LOG_ERROR("Could not create the API statistics table.");
+        return;
+    }
+
+    onlp_shlock_take(table_lock__);
+    if(t->magic != ONLP_API_STATS_MAGIC) {
+        memset(t, 0, sizeof(*t));
+        t->cleared = aim_time_monotonic();
+        t->magic = ONLP_API_STATS_MAGIC;
+    }
+    onlp_shlock_give(table_lock__);
+    table__ = t;
+}
+
+static onlp_api_stats_table_t*
+table_get__(void)
+{
+    pthread_once(&table_once__, table_init__);
+    return table__;
+}
+
+static int
+entry_find__(onlp_api_stats_table_t* t, const char* api)
+{
+    int i;
+    int count = __atomic_load_n(&t->count, __ATOMIC_ACQUIRE);
+    for(i = 0; i < count; i++) {
+        if(!strcmp(t->entries[i].name, api)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int
+entry_alloc__(onlp_api_stats_table_t* t, const char* api)
+{
+    int id;
+
+    onlp_shlock_take(table_lock__);
+    id = entry_find__(t, api);
+    if(id < 0 && t->count < ONLP_CONFIG_API_STATS_MAX) {
+        id = t->count;
+        aim_strlcpy(t->entries[id].name, api, sizeof(t->entries[id].name));
+        __atomic_store_n(&t->count, t->count + 1, __ATOMIC_RELEASE);
+    }
+    onlp_shlock_give(table_lock__);
+    return id;
+}
+
+static void
+max_update__(uint64_t* maxp, pid_t* pidp, uint64_t value)
+{
+    uint64_t current = __atomic_load_n(maxp, __ATOMIC_RELAXED);
+    while(value > current) {
+        if(__atomic_compare_exchange_n(maxp, &current, value, 0,
+                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            *pidp = getpid();
+            break;
+        }
+    }
+}
+
+static int
+hist_bucket__(uint64_t usecs)
+{
+    int b = usecs ? 64 - __builtin_clzll(usecs) : 0;
+    return (b < ONLP_API_STATS_HIST_BUCKETS) ? b : ONLP_API_STATS_HIST_BUCKETS - 1;
+}
+
+void
+onlp_api_stats_update(int* id, const char* api, uint64_t wait, uint64_t hold)
+{
+    onlp_api_stats_entry_t* e;
+    onlp_api_stats_table_t* t = table_get__();
+
+    if(t == NULL) {
+        return;
+    }
+
+    if(*id < 0) {
+        /* First call from this call site in this process. */
+        if((*id = entry_alloc__(t, api)) < 0) {
+            return;
+        }
+    }
+
+    e = t->entries + *id;
+    __atomic_add_fetch(&e->calls, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&e->wait_total, wait, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&e->hold_total, hold, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&e->hist[hist_bucket__(wait + hold)], 1, __ATOMIC_RELAXED);
+    max_update__(&e->wait_max, &e->wait_max_pid, wait);
+    max_update__(&e->hold_max, &e->hold_max_pid, hold);
+}
+
+void
+onlp_api_stats_show(aim_pvs_t* pvs)
+{
+    int i, b;
+    onlp_api_stats_table_t* t = table_get__();
+
+    if(t == NULL) {
+        aim_printf(pvs, "API statistics are not available.\n");
+        return;
+    }
+
+    aim_printf(pvs, "API statistics for the last %"PRIu64" seconds:\n",
+               (aim_time_monotonic() - t->cleared) / 1000000);
+    aim_printf(pvs, "%-36s %10s %10s %10s %8s %10s %10s %8s\n",
+               "api", "calls", "wait-avg", "wait-max", "pid",
+               "hold-avg", "hold-max", "pid");
+
+    for(i = 0; i < __atomic_load_n(&t->count, __ATOMIC_ACQUIRE); i++) {
+        onlp_api_stats_entry_t* e = t->entries + i;
+        uint64_t calls = e->calls;
+        if(calls == 0) {
+            continue;
+        }
+        aim_printf(pvs, "%-36s %10"PRIu64" %10"PRIu64" %10"PRIu64" %8d %10"PRIu64" %10"PRIu64" %8d\n",
+                   e->name, calls,
+                   e->wait_total / calls, e->wait_max, e->wait_max_pid,
+                   e->hold_total / calls, e->hold_max, e->hold_max_pid);
+        aim_printf(pvs, "    usecs:");
+        for(b = 0; b < ONLP_API_STATS_HIST_BUCKETS; b++) {
+            if(e->hist[b]) {
+                aim_printf(pvs, " <%"PRIu64":%"PRIu64, (uint64_t)1 << b, e->hist[b]);
+            }
+        }
+        aim_printf(pvs, "\n");
+    }
+}
+
+void
+onlp_api_stats_clear(void)
+{
+    int i;
+    onlp_api_stats_table_t* t = table_get__();
+
+    if(t == NULL) {
+        return;
+    }
+
+    /*
+     * The names and allocation are preserved because call
+     * sites cache their entry index.
+     */
+    onlp_shlock_take(table_lock__);
+    for(i = 0; i < t->count; i++) {
+        onlp_api_stats_entry_t* e = t->entries + i;
+        memset(&e->calls, 0, sizeof(*e) - offsetof(onlp_api_stats_entry_t, calls));
+    }
+    t->cleared = aim_time_monotonic();
+    onlp_shlock_give(table_lock__);
+}
+
+#endif /* ONLP_CONFIG_INCLUDE_API_STATS */
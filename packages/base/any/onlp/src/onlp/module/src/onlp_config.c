@@ -134,6 +134,136 @@ onlp_config_settings_t onlp_config_settings[] =
     { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_INCLUDE_API_PROFILING), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_INCLUDE_API_PROFILING) },
 #else
 { ONLP_CONFIG_INCLUDE_API_PROFILING(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_API_LOCK_DOMAINS
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_API_LOCK_DOMAINS), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_API_LOCK_DOMAINS) },
+#else
+{ ONLP_CONFIG_API_LOCK_DOMAINS(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_API_LOCK_SFP_GROUP_SIZE
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_API_LOCK_SFP_GROUP_SIZE), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_API_LOCK_SFP_GROUP_SIZE) },
+#else
+{ ONLP_CONFIG_API_LOCK_SFP_GROUP_SIZE(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_INCLUDE_API_STATS
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_INCLUDE_API_STATS), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_INCLUDE_API_STATS) },
+#else
+{ ONLP_CONFIG_INCLUDE_API_STATS(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_API_STATS_MAX
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_API_STATS_MAX), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_API_STATS_MAX) },
+#else
+{ ONLP_CONFIG_API_STATS_MAX(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT) },
+#else
+{ ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_TELEMETRY_SNAPSHOT_RATE
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_TELEMETRY_SNAPSHOT_RATE), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_TELEMETRY_SNAPSHOT_RATE) },
+#else
+{ ONLP_CONFIG_TELEMETRY_SNAPSHOT_RATE(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_TELEMETRY_SNAPSHOT_MAX_AGE
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_TELEMETRY_SNAPSHOT_MAX_AGE), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_TELEMETRY_SNAPSHOT_MAX_AGE) },
+#else
+{ ONLP_CONFIG_TELEMETRY_SNAPSHOT_MAX_AGE(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_TELEMETRY_SNAPSHOT_ID_MAX
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_TELEMETRY_SNAPSHOT_ID_MAX), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_TELEMETRY_SNAPSHOT_ID_MAX) },
+#else
+{ ONLP_CONFIG_TELEMETRY_SNAPSHOT_ID_MAX(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_INCLUDE_OID_CACHE
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_INCLUDE_OID_CACHE), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_INCLUDE_OID_CACHE) },
+#else
+{ ONLP_CONFIG_INCLUDE_OID_CACHE(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_THERMAL_CACHE_TTL
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_THERMAL_CACHE_TTL), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_THERMAL_CACHE_TTL) },
+#else
+{ ONLP_CONFIG_THERMAL_CACHE_TTL(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_FAN_CACHE_TTL
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_FAN_CACHE_TTL), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_FAN_CACHE_TTL) },
+#else
+{ ONLP_CONFIG_FAN_CACHE_TTL(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_PSU_CACHE_TTL
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_PSU_CACHE_TTL), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_PSU_CACHE_TTL) },
+#else
+{ ONLP_CONFIG_PSU_CACHE_TTL(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_LED_CACHE_TTL
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_LED_CACHE_TTL), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_LED_CACHE_TTL) },
+#else
+{ ONLP_CONFIG_LED_CACHE_TTL(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_OID_CACHE_ID_MAX
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_OID_CACHE_ID_MAX), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_OID_CACHE_ID_MAX) },
+#else
+{ ONLP_CONFIG_OID_CACHE_ID_MAX(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_IDLE_CYCLES
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_IDLE_CYCLES), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_IDLE_CYCLES) },
+#else
+{ ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_IDLE_CYCLES(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_RATE_MAX
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_RATE_MAX), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_RATE_MAX) },
+#else
+{ ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_RATE_MAX(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_PLATFORM_MANAGE_WORKERS
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_PLATFORM_MANAGE_WORKERS), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_PLATFORM_MANAGE_WORKERS) },
+#else
+{ ONLP_CONFIG_PLATFORM_MANAGE_WORKERS(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_PLATFORM_MANAGE_INTERRUPT_SAFETY_RATE
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_PLATFORM_MANAGE_INTERRUPT_SAFETY_RATE), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_PLATFORM_MANAGE_INTERRUPT_SAFETY_RATE) },
+#else
+{ ONLP_CONFIG_PLATFORM_MANAGE_INTERRUPT_SAFETY_RATE(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_INCLUDE_SFP_DOM_MONITOR
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_INCLUDE_SFP_DOM_MONITOR), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_INCLUDE_SFP_DOM_MONITOR) },
+#else
+{ ONLP_CONFIG_INCLUDE_SFP_DOM_MONITOR(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_SFP_DOM_MONITOR_RATE
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_SFP_DOM_MONITOR_RATE), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_SFP_DOM_MONITOR_RATE) },
+#else
+{ ONLP_CONFIG_SFP_DOM_MONITOR_RATE(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_SFP_DOM_MONITOR_INTERVAL
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_SFP_DOM_MONITOR_INTERVAL), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_SFP_DOM_MONITOR_INTERVAL) },
+#else
+{ ONLP_CONFIG_SFP_DOM_MONITOR_INTERVAL(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_SFP_DOM_MONITOR_BUDGET
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_SFP_DOM_MONITOR_BUDGET), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_SFP_DOM_MONITOR_BUDGET) },
+#else
+{ ONLP_CONFIG_SFP_DOM_MONITOR_BUDGET(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_SFP_DOM_MONITOR_SUBSCRIBERS_MAX
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_SFP_DOM_MONITOR_SUBSCRIBERS_MAX), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_SFP_DOM_MONITOR_SUBSCRIBERS_MAX) },
+#else
+{ ONLP_CONFIG_SFP_DOM_MONITOR_SUBSCRIBERS_MAX(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_INCLUDE_SFP_INVENTORY
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_INCLUDE_SFP_INVENTORY), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_INCLUDE_SFP_INVENTORY) },
+#else
+{ ONLP_CONFIG_INCLUDE_SFP_INVENTORY(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_SFP_INVENTORY_VERIFY_INTERVAL
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_SFP_INVENTORY_VERIFY_INTERVAL), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_SFP_INVENTORY_VERIFY_INTERVAL) },
+#else
+{ ONLP_CONFIG_SFP_INVENTORY_VERIFY_INTERVAL(__onlp_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLP_CONFIG_SFP_SWEEP_WORKERS_MAX
+    { __onlp_config_STRINGIFY_NAME(ONLP_CONFIG_SFP_SWEEP_WORKERS_MAX), __onlp_config_STRINGIFY_VALUE(ONLP_CONFIG_SFP_SWEEP_WORKERS_MAX) },
+#else
+{ ONLP_CONFIG_SFP_SWEEP_WORKERS_MAX(__onlp_config_STRINGIFY_NAME), "__undefined__" },
 #endif
     { NULL, NULL }
 };
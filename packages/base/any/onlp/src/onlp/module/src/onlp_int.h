@@ -29,6 +29,10 @@
 #include <onlp/onlp.h>
 #include <IOF/iof.h>
 #include <onlp/oids.h>
+#include <onlp/thermal.h>
+#include <onlp/fan.h>
+#include <onlp/psu.h>
+#include <onlp/led.h>
 #include <cjson/cJSON.h>
 #include "onlp_json.h"
 
@@ -44,4 +48,19 @@ void onlp_oid_show_description(iof_t* iof, onlp_oid_hdr_t* hdr);
 /** Standard message when an OID is missing. */
 void onlp_oid_show_state_missing(iof_t* iof);
 
+/*
+ * These read the info struct directly from the platform,
+ * bypassing the OID cache and telemetry snapshot.
+ */
+int onlp_thermal_info_read(onlp_oid_t oid, onlp_thermal_info_t* info);
+int onlp_fan_info_read(onlp_oid_t oid, onlp_fan_info_t* info);
+int onlp_psu_info_read(onlp_oid_t oid, onlp_psu_info_t* info);
+int onlp_led_info_read(onlp_oid_t oid, onlp_led_info_t* info);
+
+/*
+ * The bus reported for the given SFP port by onlp_sfpi_port_bus_get(),
+ * or -1 if unknown.
+ */
+int onlp_sfp_port_bus(int port);
+
 #endif /* __ONLP_INT_H__ */
@@ -28,6 +28,10 @@
 
 #if ONLP_CONFIG_INCLUDE_API_LOCK == 1
 
+#if ONLP_CONFIG_API_LOCK_DOMAINS == 1 && ONLP_CONFIG_API_LOCK_GLOBAL_SHARED == 0
+#error "ONLP_CONFIG_API_LOCK_DOMAINS requires ONLP_CONFIG_API_LOCK_GLOBAL_SHARED"
+#endif
+
 #if ONLP_CONFIG_API_LOCK_GLOBAL_SHARED == 0
 
 #include <OS/os_sem.h>
@@ -51,23 +55,26 @@ onlp_api_lock_denit(void)
     os_sem_destroy(api_sem__);
 }
 
-void
-onlp_api_lock(const char* api)
+onlp_api_lock_t
+onlp_api_lock(const char* api, int port)
 {
+    onlp_api_lock_t lock = { -1, 1, -1 };
+
     if(os_sem_take_timeout(api_sem__, ONLP_CONFIG_API_LOCK_TIMEOUT) != 0) {
         AIM_DIE("The ONLP API lock in %s could not be acquired after %d microseconds. It appears to be currently owned by call to %s. This is considered fatal.",
                 api, ONLP_CONFIG_API_LOCK_TIMEOUT, owner__ ? owner__ : "(none)");
     }
     owner__ = api;
+    return lock;
 }
 
 void
-onlp_api_unlock(void)
+onlp_api_unlock(onlp_api_lock_t* lock)
 {
     os_sem_give(api_sem__);
 }
 
-#else
+#elif ONLP_CONFIG_API_LOCK_DOMAINS == 0
 
 #include <onlplib/shlocks.h>
 
@@ -80,20 +87,220 @@ onlp_api_lock_init(void)
 void
 onlp_api_lock_denit(void)
 {
-    /* TODO */
+    /* The global lock belongs to onlplib and is shared with other processes. */
 }
 
-void
-onlp_api_lock(const char* api)
+onlp_api_lock_t
+onlp_api_lock(const char* api, int port)
 {
+    onlp_api_lock_t lock = { -1, 1, -1 };
     onlp_shlock_global_take();
+    return lock;
 }
+
 void
-onlp_api_unlock(void)
+onlp_api_unlock(onlp_api_lock_t* lock)
 {
     onlp_shlock_global_give();
 }
 
+#else
+
+/**
+ * Each subsystem has its own shared/exclusive lock. Read-only
+ * calls take their subsystem lock shared so they may run
+ * concurrently with each other.
+ *
+ * Per-port SFP calls take the SFP lock shared and then
+ * their port group lock exclusively. Ports are grouped by bus
+ * if the platform reports its SFP topology. Calls which operate on all
+ * ports (init, bitmaps) take the SFP lock exclusively, as the platform
+ * may implement them with (or fall back to) per-port accesses which
+ * would otherwise race the port group holders.
+ */
+#include <onlplib/shlocks.h>
+#include <string.h>
+#include "onlp_int.h"
+
+typedef enum onlp_api_lock_domain_e {
+    ONLP_API_LOCK_DOMAIN_SYS,
+    ONLP_API_LOCK_DOMAIN_THERMAL,
+    ONLP_API_LOCK_DOMAIN_FAN,
+    ONLP_API_LOCK_DOMAIN_PSU,
+    ONLP_API_LOCK_DOMAIN_LED,
+    ONLP_API_LOCK_DOMAIN_SFP,
+    ONLP_API_LOCK_DOMAIN_COUNT,
+} onlp_api_lock_domain_t;
+
+static const char* domain_prefixes__[ONLP_API_LOCK_DOMAIN_COUNT] = {
+    "onlp_sys_",
+    "onlp_thermal_",
+    "onlp_fan_",
+    "onlp_psu_",
+    "onlp_led_",
+    "onlp_sfp_",
+};
+
+/* API name suffixes which identify read-only calls. */
+static const char* shared_suffixes__[] = {
+    "_get",
+    "_is_present",
+    "_read",
+    "_readb",
+    "_readw",
+    NULL
+};
+
+#define ONLP_API_LOCK_DOMAIN_KEY 0xF00DF100
+#define ONLP_API_LOCK_GROUP_KEY  0xF00DF200
+#define ONLP_API_LOCK_GROUP_COUNT 64
+
+static onlp_shrwlock_t* domain_locks__[ONLP_API_LOCK_DOMAIN_COUNT];
+static onlp_shrwlock_t* group_locks__[ONLP_API_LOCK_GROUP_COUNT];
+static pthread_mutex_t locks_init_lock__ = PTHREAD_MUTEX_INITIALIZER;
+static volatile int domain_locks_ready__ = 0;
+
+void
+onlp_api_lock_init(void)
+{
+    int i;
+    if(domain_locks_ready__) {
+        return;
+    }
+    pthread_mutex_lock(&locks_init_lock__);
+    if(!domain_locks_ready__) {
+        for(i = 0; i < ONLP_API_LOCK_DOMAIN_COUNT; i++) {
+            onlp_shrwlock_create(ONLP_API_LOCK_DOMAIN_KEY + i, domain_locks__ + i,
+                                 "onlp-api-%.*s", (int)(strlen(domain_prefixes__[i]) - 6),
+                                 domain_prefixes__[i] + 5);
+        }
+        __sync_synchronize();
+        domain_locks_ready__ = 1;
+    }
+    pthread_mutex_unlock(&locks_init_lock__);
+}
+
+/*
+ * Detach from the domain and group locks. The segments themselves
+ * are shared with other ONLP processes and are left in place.
+ * No API calls may be in progress.
+ */
+void
+onlp_api_lock_denit(void)
+{
+    int i;
+    pthread_mutex_lock(&locks_init_lock__);
+    for(i = 0; i < ONLP_API_LOCK_GROUP_COUNT; i++) {
+        if(group_locks__[i]) {
+            onlp_shrwlock_destroy(group_locks__[i]);
+            group_locks__[i] = NULL;
+        }
+    }
+    if(domain_locks_ready__) {
+        domain_locks_ready__ = 0;
+        for(i = 0; i < ONLP_API_LOCK_DOMAIN_COUNT; i++) {
+            onlp_shrwlock_destroy(domain_locks__[i]);
+            domain_locks__[i] = NULL;
+        }
+    }
+    pthread_mutex_unlock(&locks_init_lock__);
+}
+
+static int
+api_shared__(const char* api)
+{
+    int len = strlen(api);
+    const char** sp;
+    for(sp = shared_suffixes__; *sp; sp++) {
+        int slen = strlen(*sp);
+        if(len > slen && !strcmp(api + len - slen, *sp)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int
+api_domain__(const char* api)
+{
+    int i;
+    for(i = 0; i < ONLP_API_LOCK_DOMAIN_COUNT; i++) {
+        if(!strncmp(api, domain_prefixes__[i], strlen(domain_prefixes__[i]))) {
+            return i;
+        }
+    }
+    /* Anything unclassified is serialized against the system domain. */
+    return ONLP_API_LOCK_DOMAIN_SYS;
+}
+
+static onlp_shrwlock_t*
+group_lock__(int group)
+{
+    if(group_locks__[group] == NULL) {
+        pthread_mutex_lock(&locks_init_lock__);
+        if(group_locks__[group] == NULL) {
+            onlp_shrwlock_create(ONLP_API_LOCK_GROUP_KEY + group, group_locks__ + group,
+                                 "onlp-api-sfp-group-%d", group);
+        }
+        pthread_mutex_unlock(&locks_init_lock__);
+    }
+    return group_locks__[group];
+}
+
+static void
+api_take__(const char* api, onlp_shrwlock_t* l, int exclusive)
+{
+    int64_t timeout = ONLP_CONFIG_API_LOCK_TIMEOUT ? ONLP_CONFIG_API_LOCK_TIMEOUT : -1;
+    if(onlp_shrwlock_take(l, exclusive, timeout) < 0) {
+        AIM_DIE("The ONLP API lock %s in %s could not be acquired after %d microseconds. This is considered fatal.",
+                onlp_shrwlock_name(l), api, ONLP_CONFIG_API_LOCK_TIMEOUT);
+    }
+}
+
+onlp_api_lock_t
+onlp_api_lock(const char* api, int port)
+{
+    onlp_api_lock_t lock;
+
+    onlp_api_lock_init();
+
+    lock.domain = api_domain__(api);
+    lock.group = -1;
+    if(lock.domain == ONLP_API_LOCK_DOMAIN_SFP && port >= 0) {
+        int bus = onlp_sfp_port_bus(port);
+        lock.exclusive = 0;
+        if(bus >= 0) {
+            /* Ports on different buses may be accessed concurrently. */
+            lock.group = bus % ONLP_API_LOCK_GROUP_COUNT;
+        }
+        else {
+            lock.group = (port / ONLP_CONFIG_API_LOCK_SFP_GROUP_SIZE) % ONLP_API_LOCK_GROUP_COUNT;
+        }
+    }
+    else if(lock.domain == ONLP_API_LOCK_DOMAIN_SFP) {
+        /* Only the port bitmap itself is known not to touch the ports. */
+        lock.exclusive = strcmp(api, "onlp_sfp_bitmap_get") != 0;
+    }
+    else {
+        lock.exclusive = !api_shared__(api);
+    }
+
+    api_take__(api, domain_locks__[lock.domain], lock.exclusive);
+    if(lock.group >= 0) {
+        api_take__(api, group_lock__(lock.group), 1);
+    }
+    return lock;
+}
+
+void
+onlp_api_unlock(onlp_api_lock_t* lock)
+{
+    if(lock->group >= 0) {
+        onlp_shrwlock_give(group_locks__[lock->group], 1);
+    }
+    onlp_shrwlock_give(domain_locks__[lock->domain], lock->exclusive);
+}
+
 #endif
 
 
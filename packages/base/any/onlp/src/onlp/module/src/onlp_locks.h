@@ -35,25 +35,45 @@
 void onlp_api_lock_init();
 void onlp_api_lock_denit();
 
+/**
+ * The locks held by a single API call.
+ */
+typedef struct onlp_api_lock_s {
+    /** The subsystem lock domain, or -1 */
+    int domain;
+    /** Whether the domain lock is held exclusively */
+    int exclusive;
+    /** The SFP port group lock, or -1 */
+    int group;
+} onlp_api_lock_t;
+
 /**
  * @brief Take the ONLP API lock.
+ * @param api The API name.
+ * @param port The port number for per-port SFP calls, -1 otherwise.
+ * @returns The lock state which must be passed to onlp_api_unlock().
+ * @note When ONLP_CONFIG_API_LOCK_DOMAINS is enabled the lock domain
+ * and mode are derived from the API name.
  */
-void onlp_api_lock(const char* api);
+onlp_api_lock_t onlp_api_lock(const char* api, int port);
 
 /**
  * @brief Give the ONLP API lock.
+ * @param lock The lock state returned by onlp_api_lock().
  */
-void onlp_api_unlock(void);
+void onlp_api_unlock(onlp_api_lock_t* lock);
 
 
 #define ONLP_API_LOCK_INIT() onlp_api_lock_init()
-#define ONLP_API_LOCK(_api)      onlp_api_lock(_api)
-#define ONLP_API_UNLOCK()    onlp_api_unlock()
+#define ONLP_API_LOCK(_api)      onlp_api_lock_t _api_lock = onlp_api_lock(_api, -1)
+#define ONLP_API_PORT_LOCK(_api, _port) onlp_api_lock_t _api_lock = onlp_api_lock(_api, _port)
+#define ONLP_API_UNLOCK()    onlp_api_unlock(&_api_lock)
 
 #else
 
 #define ONLP_API_LOCK_INIT()
 #define ONLP_API_LOCK(_api)
+#define ONLP_API_PORT_LOCK(_api, _port)
 #define ONLP_API_UNLOCK()
 
 #endif /** ONLP_CONFIG_INCLUDE_API_LOCK */
@@ -71,9 +91,55 @@ void onlp_api_unlock(void);
 
 #define ONLP_LOCKED_API_NAME(_name) _name##_locked__
 
+#if ONLP_CONFIG_INCLUDE_API_STATS == 1
+
+/**
+ * @brief Record the timing of a single API call.
+ * @param id [in,out] The call site's cached statistics slot.
+ * @param api The API name.
+ * @param wait Time spent acquiring the API lock (usecs).
+ * @param hold Time spent holding the API lock (usecs).
+ */
+void onlp_api_stats_update(int* id, const char* api, uint64_t wait, uint64_t hold);
+
+/**
+ * @brief Show the API statistics table.
+ */
+void onlp_api_stats_show(aim_pvs_t* pvs);
+
+/**
+ * @brief Clear the API statistics table.
+ */
+void onlp_api_stats_clear(void);
+
+#define ONLP_API_STATS_DECL()                   \
+    static int _api_stats_id = -1
+
+#define ONLP_API_STATS_UPDATE(_name)                                    \
+    onlp_api_stats_update(&_api_stats_id, #_name, t1-t0, t2-t1)
+
+#else
+
+#define ONLP_API_STATS_DECL()
+#define ONLP_API_STATS_UPDATE(_name)
+
+#endif
+
 #if ONLP_CONFIG_INCLUDE_API_PROFILING == 1
 
+#define ONLP_API_PROFILE_LOG(_name)                                     \
+    AIM_LOG_MSG("API '%s' : (total=%"PRId64", ltime=%"PRId64" ftime=%"PRId64")", #_name, t2-t0, t1-t0, t2-t1)
+
+#else
+
+#define ONLP_API_PROFILE_LOG(_name)
+
+#endif
+
+#if ONLP_CONFIG_INCLUDE_API_PROFILING == 1 || ONLP_CONFIG_INCLUDE_API_STATS == 1
+
 #define ONLP_API_T0(_name)                              \
+    ONLP_API_STATS_DECL();                              \
     uint64_t t0, t1, t2; t0 = aim_time_monotonic()
 
 #define ONLP_API_T1(_name)                      \
@@ -82,7 +148,8 @@ void onlp_api_unlock(void);
 #define ONLP_API_T2(_name)                                              \
     do {                                                                \
         t2 = aim_time_monotonic();                                      \
-        AIM_LOG_MSG("API '%s' : (total=%"PRId64", ltime=%"PRId64" ftime=%"PRId64")", #_name, t2-t0, t1-t0, t2-t1); \
+        ONLP_API_STATS_UPDATE(_name);                                   \
+        ONLP_API_PROFILE_LOG(_name);                                    \
     } while(0)
 
 #else
@@ -165,6 +232,83 @@ void onlp_api_unlock(void);
         return _rv;                                                     \
     }
 
+/*
+ * Per-port SFP entry points. The first argument must be the port number.
+ * These only serialize against calls to the same port group when
+ * ONLP_CONFIG_API_LOCK_DOMAINS is enabled.
+ */
+#define ONLP_LOCKED_PORT_API1(_name, _t, _v)                    \
+    int _name (_t _v)                                           \
+    {                                                           \
+        ONLP_API_T0(_name);                                     \
+        ONLP_API_PORT_LOCK(#_name, _v);                         \
+        ONLP_API_T1(_name);                                     \
+        int _rv = ONLP_LOCKED_API_NAME(_name)(_v);              \
+        ONLP_API_UNLOCK();                                      \
+        ONLP_API_T2(_name);                                     \
+        return _rv;                                             \
+    }
+
+#define ONLP_LOCKED_PORT_API2(_name, _t1, _v1, _t2, _v2)                \
+    int _name (_t1 _v1, _t2 _v2)                                        \
+    {                                                                   \
+        ONLP_API_T0(_name);                                             \
+        ONLP_API_PORT_LOCK(#_name, _v1);                                \
+        ONLP_API_T1(_name);                                             \
+        int _rv = ONLP_LOCKED_API_NAME(_name) (_v1, _v2);               \
+        ONLP_API_UNLOCK();                                              \
+        ONLP_API_T2(_name);                                             \
+        return _rv;                                                     \
+    }
+
+#define ONLP_LOCKED_PORT_API3(_name, _t1, _v1, _t2, _v2, _t3, _v3)      \
+    int _name (_t1 _v1, _t2 _v2, _t3 _v3)                               \
+    {                                                                   \
+        ONLP_API_T0(_name);                                             \
+        ONLP_API_PORT_LOCK(#_name, _v1);                                \
+        ONLP_API_T1(_name);                                             \
+        int _rv = ONLP_LOCKED_API_NAME(_name) (_v1, _v2, _v3);          \
+        ONLP_API_UNLOCK();                                              \
+        ONLP_API_T2(_name);                                             \
+        return _rv;                                                     \
+    }
+
+#define ONLP_LOCKED_PORT_API4(_name, _t1, _v1, _t2, _v2, _t3, _v3, _t4, _v4) \
+    int _name (_t1 _v1, _t2 _v2, _t3 _v3, _t4 _v4)                      \
+    {                                                                   \
+        ONLP_API_T0(_name);                                             \
+        ONLP_API_PORT_LOCK(#_name, _v1);                                \
+        ONLP_API_T1(_name);                                             \
+        int _rv = ONLP_LOCKED_API_NAME(_name) (_v1, _v2, _v3, _v4);     \
+        ONLP_API_UNLOCK();                                              \
+        ONLP_API_T2(_name);                                             \
+        return _rv;                                                     \
+    }
+
+#define ONLP_LOCKED_PORT_API5(_name, _t1, _v1, _t2, _v2, _t3, _v3, _t4, _v4, _t5, _v5) \
+    int _name (_t1 _v1, _t2 _v2, _t3 _v3, _t4 _v4, _t5 _v5)             \
+    {                                                                   \
+        ONLP_API_T0(_name);                                             \
+        ONLP_API_PORT_LOCK(#_name, _v1);                                \
+        ONLP_API_T1(_name);                                             \
+        int _rv = ONLP_LOCKED_API_NAME(_name) (_v1, _v2, _v3, _v4, _v5); \
+        ONLP_API_UNLOCK();                                              \
+        ONLP_API_T2(_name);                                             \
+        return _rv;                                                     \
+    }
+
+#define ONLP_LOCKED_PORT_API6(_name, _t1, _v1, _t2, _v2, _t3, _v3, _t4, _v4, _t5, _v5, _t6, _v6) \
+    int _name (_t1 _v1, _t2 _v2, _t3 _v3, _t4 _v4, _t5 _v5, _t6 _v6)    \
+    {                                                                   \
+        ONLP_API_T0(_name);                                             \
+        ONLP_API_PORT_LOCK(#_name, _v1);                                \
+        ONLP_API_T1(_name);                                             \
+        int _rv = ONLP_LOCKED_API_NAME(_name) (_v1, _v2, _v3, _v4, _v5, _v6); \
+        ONLP_API_UNLOCK();                                              \
+        ONLP_API_T2(_name);                                             \
+        return _rv;                                                     \
+    }
+
 #define ONLP_LOCKED_VAPI0(_name)                                 \
     void _name (void)                                            \
     {                                                            \
@@ -206,7 +350,7 @@ void onlp_api_unlock(void);
         ONLP_API_T1(_name);                                             \
         ONLP_LOCKED_API_NAME(_name) (_v1, _v2, _v3);                    \
         ONLP_API_UNLOCK();                                              \
-        ONLP_API_T2(name);                                              \
+        ONLP_API_T2(_name);                                             \
     }
 
 #define ONLP_LOCKED_VAPI4(_name, _t1, _v1, _t2, _v2, _t3, _v3, _t4, _v4) \
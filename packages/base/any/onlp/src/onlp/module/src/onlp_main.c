@@ -32,9 +32,78 @@
 #include <AIM/aim_log_handler.h>
 #include <syslog.h>
 #include <onlp/platformi/sysi.h>
+#include <onlplib/file.h>
+#include "onlp_locks.h"
 
 static void platform_manager_daemon__(const char* pidfile, char** argv);
 
+/**
+ * Status characters for the human-readable SFP inventory.
+ */
+static const struct {
+    onlp_sfp_control_t control;
+    char c;
+} inventory_status__[] = {
+    { ONLP_SFP_CONTROL_RX_LOS, 'R' },
+    { ONLP_SFP_CONTROL_TX_FAULT, 'T' },
+    { ONLP_SFP_CONTROL_TX_DISABLE, 'X' },
+    { ONLP_SFP_CONTROL_LP_MODE, 'L' },
+};
+
+typedef struct inventory_show_s {
+    aim_pvs_t* pvs;
+    int database;
+    onlp_sfp_bitmap_t status[AIM_ARRAYSIZE(inventory_status__)];
+} inventory_show_t;
+
+static void
+show_inventory_port__(void* cookie, int port, int rv, const sff_eeprom_t* sff)
+{
+    int i;
+    inventory_show_t* is = (inventory_show_t*)cookie;
+    aim_pvs_t* pvs = is->pvs;
+    char status_str[32] = {0};
+    char* cp = status_str;
+
+    if(rv == ONLP_STATUS_E_MISSING) {
+        if(!is->database) {
+            aim_printf(pvs, "%4d  NONE\n", port);
+        }
+        return;
+    }
+
+    if(rv < 0) {
+        aim_printf(pvs, "%4d  Error %{onlp_status}\n", port, rv);
+        return;
+    }
+
+    if(!sff->identified) {
+        /* Present but unidentified. */
+        aim_printf(pvs, "%13d  UNK\n", port);
+        return;
+    }
+
+    if(is->database) {
+        sff_db_entry_struct((sff_eeprom_t*)sff, &aim_pvs_stdout);
+        return;
+    }
+
+    for(i = 0; i < AIM_ARRAYSIZE(inventory_status__); i++) {
+        if(AIM_BITMAP_GET(is->status + i, port)) {
+            *cp++ = inventory_status__[i].c;
+        }
+    }
+    aim_printf(pvs, "%4d  %-14s  %-6s  %-6.6s  %-5.5s  %-16.16s  %-16.16s  %16.16s\n",
+               port,
+               sff->info.module_type_name,
+               sff->info.media_type_name,
+               status_str,
+               sff->info.length_desc,
+               sff->info.vendor,
+               sff->info.model,
+               sff->info.serial);
+}
+
 /**
  * Human-readable SFP inventory.
  * This should be moved to common.
@@ -42,8 +111,10 @@ static void platform_manager_daemon__(const char* pidfile, char** argv);
 static void
 show_inventory__(aim_pvs_t* pvs, int database)
 {
+    int i;
     int port;
     onlp_sfp_bitmap_t bitmap;
+    inventory_show_t is;
 
     onlp_sfp_bitmap_t_init(&bitmap);
     onlp_sfp_bitmap_get(&bitmap);
@@ -52,76 +123,43 @@ show_inventory__(aim_pvs_t* pvs, int database)
         aim_printf(pvs, "No SFPs on this platform.\n");
     }
     else {
+        is.pvs = pvs;
+        is.database = database;
+
         if(!database) {
             aim_printf(pvs, "Port  Type            Media   Status  Len    Vendor            Model             S/N             \n");
             aim_printf(pvs, "----  --------------  ------  ------  -----  ----------------  ----------------  ----------------\n");
-        }
-
-        AIM_BITMAP_ITER(&bitmap, port) {
-            int rv;
-            uint8_t* data;
-
-            rv = onlp_sfp_is_present(port);
-
-            if(rv == 0) {
-                if(!database) {
-                    aim_printf(pvs, "%4d  NONE\n", port);
-                }
-                continue;
-            }
-
-            if(rv < 0) {
-                aim_printf(pvs, "%4d  Error %{onlp_status}\n", port, rv);
-                continue;
-            }
-
-            rv = onlp_sfp_eeprom_read(port, &data);
-
-            if(rv < 0) {
-                aim_printf(pvs, "%4d  Error %{onlp_status}\n", port, rv);
-                continue;
-            }
 
-            sff_eeprom_t sff;
-            char status_str[32] = {0};
-
-            sff_eeprom_parse(&sff, data);
-
-            if(!sff.identified) {
-                /* Present but unidentified. */
-                aim_printf(pvs, "%13d  UNK\n", port);
-                continue;
-            }
-
-            if(database) {
-                sff_db_entry_struct(&sff, &aim_pvs_stdout);
-                continue;
+            /* One bulk read per status control rather than per port. */
+            for(i = 0; i < AIM_ARRAYSIZE(inventory_status__); i++) {
+                onlp_sfp_bitmap_t_init(is.status + i);
+                onlp_sfp_control_bitmap_get(inventory_status__[i].control, is.status + i);
             }
+        }
 
-            uint32_t status = 0;
-            char* cp = status_str;
-            onlp_sfp_control_flags_get(port, &status);
-            if(status & ONLP_SFP_CONTROL_FLAG_RX_LOS) {
-                *cp++ = 'R';
-            }
-            if(status & ONLP_SFP_CONTROL_FLAG_TX_FAULT) {
-                *cp++ = 'T';
-            }
-            if(status & ONLP_SFP_CONTROL_FLAG_TX_DISABLE) {
-                *cp++ = 'X';
-            }
-            if(status & ONLP_SFP_CONTROL_FLAG_LP_MODE) {
-                *cp++ = 'L';
+        if(onlp_sfp_inventory_iterate(show_inventory_port__, &is) < 0) {
+            /* Read each module directly. */
+            AIM_BITMAP_ITER(&bitmap, port) {
+                int rv;
+                uint8_t* data;
+                sff_eeprom_t sff;
+
+                rv = onlp_sfp_is_present(port);
+                if(rv == 0) {
+                    show_inventory_port__(&is, port, ONLP_STATUS_E_MISSING, NULL);
+                    continue;
+                }
+                if(rv > 0) {
+                    rv = onlp_sfp_eeprom_read(port, &data);
+                }
+                if(rv < 0) {
+                    show_inventory_port__(&is, port, rv, NULL);
+                    continue;
+                }
+                sff_eeprom_parse(&sff, data);
+                aim_free(data);
+                show_inventory_port__(&is, port, 0, &sff);
             }
-            aim_printf(pvs, "%4d  %-14s  %-6s  %-6.6s  %-5.5s  %-16.16s  %-16.16s  %16.16s\n",
-                       port,
-                       sff.info.module_type_name,
-                       sff.info.media_type_name,
-                       status_str,
-                       sff.info.length_desc,
-                       sff.info.vendor,
-                       sff.info.model,
-                       sff.info.serial);
         }
     }
 }
@@ -181,6 +219,8 @@ onlpdump_main(int argc, char* argv[])
     int l = 0;
     int M = 0;
     int b = 0;
+    int L = 0;
+    int R = 0;
     char* pidfile = NULL;
     const char* O = NULL;
     const char* t = NULL;
@@ -199,7 +239,7 @@ onlpdump_main(int argc, char* argv[])
         }
     }
 
-    while( (c = getopt(argc, argv, "srehdojmyM:ipxlSt:O:bJ:")) != -1) {
+    while( (c = getopt(argc, argv, "srehdojmyM:ipxlSt:O:bJ:LR")) != -1) {
         switch(c)
             {
             case 's': show=1; break;
@@ -220,6 +260,8 @@ onlpdump_main(int argc, char* argv[])
             case 'l': l=1; break;
             case 'b': b=1; break;
             case 'J': J = optarg; break;
+            case 'L': L=1; break;
+            case 'R': R=1; break;
             case 'y': show=1; showflags |= ONLP_OID_SHOW_YAML; break;
             default: help=1; rv = 1; break;
             }
@@ -245,6 +287,8 @@ onlpdump_main(int argc, char* argv[])
         printf("  -b   Decode SFP Inventory into SFF database entries.\n");
         printf("  -l   API Lock test.\n");
         printf("  -J   Decode ONIE JSON data.\n");
+        printf("  -L   Show API lock statistics.\n");
+        printf("  -R   Clear API lock statistics.\n");
         return rv;
     }
 
@@ -278,6 +322,21 @@ onlpdump_main(int argc, char* argv[])
         }
     }
 
+    if(L || R) {
+#if ONLP_CONFIG_INCLUDE_API_STATS == 1
+        if(L) {
+            onlp_api_stats_show(&aim_pvs_stdout);
+        }
+        if(R) {
+            onlp_api_stats_clear();
+        }
+        return 0;
+#else
+        fprintf(stderr, "API statistics support not available in this build.\n");
+        return 1;
+#endif
+    }
+
     onlp_init();
 
     if(M) {
@@ -364,6 +423,9 @@ onlpdump_main(int argc, char* argv[])
         sleep(600);
         printf("Stopping the platform manager.\n");
         onlp_sys_platform_manage_stop(1);
+        onlp_sys_platform_manage_stats_show(&aim_pvs_stdout);
+        onlp_oid_cache_stats_show(&aim_pvs_stdout);
+        onlp_file_find_stats_show(&aim_pvs_stdout);
     }
 
     if(p) {
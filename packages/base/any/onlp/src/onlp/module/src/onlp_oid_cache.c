@@ -0,0 +1,243 @@
+/************************************************************
+ * <bsn.cl fy=2014 v=onl>
+ *
+ *        Copyright 2014, 2015 Big Switch Networks, Inc.
+ *
+ * Licensed under the Eclipse Public License, Version 1.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ *        http://www.eclipse.org/legal/epl-v10.html
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the
+ * License.
+ *
+ * </bsn.cl>
+ ************************************************************
+ *
+ * Per-process OID info cache.
+ *
+ * Each OID type has its own cache and TTL. Entries are
+ * indexed directly by OID id. Setters invalidate their OID's
+ * entry by bumping its generation, which also discards any
+ * read which was in flight at the time.
+ *
+ ***********************************************************/
+#include <onlp/onlp_config.h>
+#include <onlp/onlp.h>
+#include <onlp/oids.h>
+#include <onlp/thermal.h>
+#include <onlp/fan.h>
+#include <onlp/psu.h>
+#include <onlp/led.h>
+#include "onlp_oid_cache.h"
+#include "onlp_log.h"
+
+#if ONLP_CONFIG_INCLUDE_OID_CACHE == 1
+
+#include <AIM/aim_time.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <string.h>
+
+typedef struct oid_cache_entry_s {
+    uint64_t updated;
+    uint32_t gen;
+    void* data;
+} oid_cache_entry_t;
+
+typedef struct oid_cache_s {
+    const char* name;
+    onlp_oid_type_t type;
+    uint64_t ttl;
+    int size;
+
+    pthread_mutex_t lock;
+    uint64_t hits;
+    uint64_t misses;
+
+    oid_cache_entry_t entries[ONLP_CONFIG_OID_CACHE_ID_MAX+1];
+} oid_cache_t;
+
+static oid_cache_t caches__[] = {
+    { "thermal", ONLP_OID_TYPE_THERMAL, ONLP_CONFIG_THERMAL_CACHE_TTL,
+      sizeof(onlp_thermal_info_t), PTHREAD_MUTEX_INITIALIZER },
+    { "fan", ONLP_OID_TYPE_FAN, ONLP_CONFIG_FAN_CACHE_TTL,
+      sizeof(onlp_fan_info_t), PTHREAD_MUTEX_INITIALIZER },
+    { "psu", ONLP_OID_TYPE_PSU, ONLP_CONFIG_PSU_CACHE_TTL,
+      sizeof(onlp_psu_info_t), PTHREAD_MUTEX_INITIALIZER },
+    { "led", ONLP_OID_TYPE_LED, ONLP_CONFIG_LED_CACHE_TTL,
+      sizeof(onlp_led_info_t), PTHREAD_MUTEX_INITIALIZER },
+};
+
+static __thread int bypass__ = 0;
+
+static oid_cache_t*
+cache__(onlp_oid_t oid)
+{
+    int i;
+    for(i = 0; i < AIM_ARRAYSIZE(caches__); i++) {
+        if(ONLP_OID_TYPE_GET(oid) == caches__[i].type) {
+            return caches__[i].ttl ? caches__ + i : NULL;
+        }
+    }
+    return NULL;
+}
+
+static oid_cache_entry_t*
+entry__(oid_cache_t* c, onlp_oid_t oid)
+{
+    int id = ONLP_OID_ID_GET(oid);
+    return (id <= ONLP_CONFIG_OID_CACHE_ID_MAX) ? c->entries + id : NULL;
+}
+
+int
+onlp_oid_cache_get(onlp_oid_t oid, void* info, int size, uint32_t* gen)
+{
+    int rv = ONLP_STATUS_E_MISSING;
+    oid_cache_entry_t* e;
+    oid_cache_t* c = cache__(oid);
+
+    if(c == NULL || (e = entry__(c, oid)) == NULL || size != c->size) {
+        return ONLP_STATUS_E_MISSING;
+    }
+
+    pthread_mutex_lock(&c->lock);
+    if(!bypass__ && e->updated &&
+       aim_time_monotonic() - e->updated <= c->ttl) {
+        memcpy(info, e->data, size);
+        c->hits++;
+        rv = ONLP_STATUS_OK;
+    }
+    else {
+        c->misses++;
+    }
+    *gen = e->gen;
+    pthread_mutex_unlock(&c->lock);
+    return rv;
+}
+
+void
+onlp_oid_cache_put(onlp_oid_t oid, const void* info, int size, uint32_t gen)
+{
+    oid_cache_entry_t* e;
+    oid_cache_t* c = cache__(oid);
+
+    if(c == NULL || (e = entry__(c, oid)) == NULL || size != c->size) {
+        return;
+    }
+
+    pthread_mutex_lock(&c->lock);
+    if(e->gen == gen) {
+        if(e->data == NULL) {
+            e->data = aim_zmalloc(size);
+        }
+        memcpy(e->data, info, size);
+        e->updated = aim_time_monotonic();
+    }
+    pthread_mutex_unlock(&c->lock);
+}
+
+int
+onlp_oid_cache_bypassed(void)
+{
+    return bypass__;
+}
+
+int
+onlp_oid_cache_bypass(int bypass)
+{
+    int rv = bypass__;
+    bypass__ = bypass;
+    return rv;
+}
+
+static void
+cache_flush__(oid_cache_t* c, oid_cache_entry_t* e)
+{
+    e->updated = 0;
+    e->gen++;
+}
+
+void
+onlp_oid_cache_flush(onlp_oid_t oid)
+{
+    int i, id;
+
+    for(i = 0; i < AIM_ARRAYSIZE(caches__); i++) {
+        oid_cache_t* c = caches__ + i;
+        if(oid && ONLP_OID_TYPE_GET(oid) != c->type) {
+            continue;
+        }
+        pthread_mutex_lock(&c->lock);
+        if(oid) {
+            oid_cache_entry_t* e = entry__(c, oid);
+            if(e) {
+                cache_flush__(c, e);
+            }
+        }
+        else {
+            for(id = 0; id <= ONLP_CONFIG_OID_CACHE_ID_MAX; id++) {
+                cache_flush__(c, c->entries + id);
+            }
+        }
+        pthread_mutex_unlock(&c->lock);
+    }
+}
+
+void
+onlp_oid_cache_stats_show(aim_pvs_t* pvs)
+{
+    int i;
+
+    aim_printf(pvs, "%-8s %10s %12s %12s\n", "cache", "ttl", "hits", "misses");
+    for(i = 0; i < AIM_ARRAYSIZE(caches__); i++) {
+        oid_cache_t* c = caches__ + i;
+        pthread_mutex_lock(&c->lock);
+        aim_printf(pvs, "%-8s %10"PRIu64" %12"PRIu64" %12"PRIu64"\n",
+                   c->name, c->ttl, c->hits, c->misses);
+        pthread_mutex_unlock(&c->lock);
+    }
+}
+
+#else
+
+int
+onlp_oid_cache_get(onlp_oid_t oid, void* info, int size, uint32_t* gen)
+{
+    return ONLP_STATUS_E_MISSING;
+}
+
+void
+onlp_oid_cache_put(onlp_oid_t oid, const void* info, int size, uint32_t gen)
+{
+}
+
+int
+onlp_oid_cache_bypassed(void)
+{
+    return 0;
+}
+
+int
+onlp_oid_cache_bypass(int bypass)
+{
+    return 0;
+}
+
+void
+onlp_oid_cache_flush(onlp_oid_t oid)
+{
+}
+
+void
+onlp_oid_cache_stats_show(aim_pvs_t* pvs)
+{
+    aim_printf(pvs, "OID caching is not available in this build.\n");
+}
+
+#endif /* ONLP_CONFIG_INCLUDE_OID_CACHE */
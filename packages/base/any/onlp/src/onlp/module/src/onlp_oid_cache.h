@@ -0,0 +1,58 @@
+/************************************************************
+ * <bsn.cl fy=2014 v=onl>
+ *
+ *        Copyright 2014, 2015 Big Switch Networks, Inc.
+ *
+ * Licensed under the Eclipse Public License, Version 1.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ *        http://www.eclipse.org/legal/epl-v10.html
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the
+ * License.
+ *
+ * </bsn.cl>
+ ************************************************************
+ *
+ * Per-process OID info cache.
+ *
+ ***********************************************************/
+#ifndef __ONLP_OID_CACHE_H__
+#define __ONLP_OID_CACHE_H__
+
+#include <onlp/onlp_config.h>
+#include <onlp/oids.h>
+
+/**
+ * @brief Get an OID's info struct from the cache.
+ * @param oid The OID.
+ * @param info Receives the info struct.
+ * @param size The size of the info struct.
+ * @param gen [out] On a miss, receives the entry generation
+ * which must be passed to onlp_oid_cache_put().
+ * @returns ONLP_STATUS_OK on a hit, ONLP_STATUS_E_MISSING otherwise.
+ */
+int onlp_oid_cache_get(onlp_oid_t oid, void* info, int size, uint32_t* gen);
+
+/**
+ * @brief Store an OID's info struct in the cache.
+ * @param oid The OID.
+ * @param info The info struct.
+ * @param size The size of the info struct.
+ * @param gen The generation returned by the preceding onlp_oid_cache_get().
+ * @note The info is discarded if the entry was invalidated since
+ * the generation was retrieved.
+ */
+void onlp_oid_cache_put(onlp_oid_t oid, const void* info, int size, uint32_t gen);
+
+/**
+ * @brief Returns true if the calling thread bypasses the caches.
+ */
+int onlp_oid_cache_bypassed(void);
+
+#endif /* __ONLP_OID_CACHE_H__ */
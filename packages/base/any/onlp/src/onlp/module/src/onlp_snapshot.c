@@ -0,0 +1,311 @@
+/************************************************************
+ * <bsn.cl fy=2014 v=onl>
+ *
+ *        Copyright 2014, 2015 Big Switch Networks, Inc.
+ *
+ * Licensed under the Eclipse Public License, Version 1.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ *        http://www.eclipse.org/legal/epl-v10.html
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the
+ * License.
+ *
+ * </bsn.cl>
+ ************************************************************
+ *
+ * Shared telemetry snapshot.
+ *
+ * The platform manager periodically reads every thermal, fan,
+ * and psu OID and publishes the results into a shared memory
+ * segment. Each entry is protected by a sequence counter so
+ * readers never block: a reader copies the entry and retries
+ * if the counter was odd or changed during the copy.
+ *
+ ***********************************************************/
+#include <onlp/onlp_config.h>
+#include <onlp/onlp.h>
+#include "onlp_snapshot.h"
+#include "onlp_int.h"
+#include "onlp_log.h"
+
+#if ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT == 1
+
+#include <onlplib/shlocks.h>
+#include <AIM/aim_time.h>
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ONLP_SNAPSHOT_KEY   0xF00DF400
+#define ONLP_SNAPSHOT_MAGIC 0x534E4150
+
+/* Reader retries before falling back to the platform. */
+#define ONLP_SNAPSHOT_READ_RETRIES 8
+
+typedef struct onlp_snapshot_entry_s {
+    /* Odd while an update is in progress. */
+    uint32_t seq;
+    /* The publisher currently updating this entry. */
+    pid_t writer;
+    /* Time of publication (monotonic usecs). Zero if invalid. */
+    uint64_t updated;
+    union {
+        onlp_thermal_info_t thermal;
+        onlp_fan_info_t fan;
+        onlp_psu_info_t psu;
+    } info;
+} onlp_snapshot_entry_t;
+
+typedef struct onlp_snapshot_s {
+    uint32_t magic;
+    uint32_t size;
+    onlp_snapshot_entry_t thermals[ONLP_CONFIG_TELEMETRY_SNAPSHOT_ID_MAX+1];
+    onlp_snapshot_entry_t fans[ONLP_CONFIG_TELEMETRY_SNAPSHOT_ID_MAX+1];
+    onlp_snapshot_entry_t psus[ONLP_CONFIG_TELEMETRY_SNAPSHOT_ID_MAX+1];
+} onlp_snapshot_t;
+
+static onlp_snapshot_t* snapshot__ = NULL;
+static pthread_once_t snapshot_once__ = PTHREAD_ONCE_INIT;
+
+static void
+snapshot_init__(void)
+{
+    onlp_snapshot_t* s = NULL;
+
+    if(onlp_shmem_create(ONLP_SNAPSHOT_KEY, sizeof(*s), (void**)&s) < 0) {
+        AIM_LOG_ERROR("Could not attach the telemetry snapshot.");
+        return;
+    }
+
+    /* New segments are zero filled. */
+    if(s->magic == 0) {
+        uint32_t zero = 0;
+        s->size = sizeof(*s);
+        __atomic_compare_exchange_n(&s->magic, &zero, ONLP_SNAPSHOT_MAGIC, 0,
+                                    __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+    }
+
+    if(s->magic != ONLP_SNAPSHOT_MAGIC || s->size != sizeof(*s)) {
+        AIM_LOG_ERROR("The telemetry snapshot layout does not match this build.");
+        return;
+    }
+    snapshot__ = s;
+}
+
+static onlp_snapshot_entry_t*
+snapshot_entry__(onlp_oid_t oid)
+{
+    int id = ONLP_OID_ID_GET(oid);
+
+    pthread_once(&snapshot_once__, snapshot_init__);
+    if(snapshot__ == NULL || id > ONLP_CONFIG_TELEMETRY_SNAPSHOT_ID_MAX) {
+        return NULL;
+    }
+
+    switch(ONLP_OID_TYPE_GET(oid))
+        {
+        case ONLP_OID_TYPE_THERMAL: return snapshot__->thermals + id;
+        case ONLP_OID_TYPE_FAN: return snapshot__->fans + id;
+        case ONLP_OID_TYPE_PSU: return snapshot__->psus + id;
+        default: return NULL;
+        }
+}
+
+int
+onlp_snapshot_get(onlp_oid_t oid, void* info, int size)
+{
+    int i;
+    onlp_snapshot_entry_t* e = snapshot_entry__(oid);
+
+    if(e == NULL) {
+        return ONLP_STATUS_E_MISSING;
+    }
+
+    for(i = 0; i < ONLP_SNAPSHOT_READ_RETRIES; i++) {
+        uint64_t updated;
+        uint32_t seq = __atomic_load_n(&e->seq, __ATOMIC_ACQUIRE);
+
+        if(seq & 1) {
+            continue;
+        }
+        updated = e->updated;
+        memcpy(info, &e->info, size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if(__atomic_load_n(&e->seq, __ATOMIC_RELAXED) != seq) {
+            continue;
+        }
+
+        if(updated == 0 ||
+           aim_time_monotonic() - updated > ONLP_CONFIG_TELEMETRY_SNAPSHOT_MAX_AGE) {
+            return ONLP_STATUS_E_MISSING;
+        }
+        return ONLP_STATUS_OK;
+    }
+    return ONLP_STATUS_E_MISSING;
+}
+
+static void
+snapshot_put__(onlp_snapshot_entry_t* e, const void* info, int size)
+{
+    uint32_t next;
+    uint32_t seq = __atomic_load_n(&e->seq, __ATOMIC_ACQUIRE);
+
+    if(seq & 1) {
+        /*
+         * Another publisher is updating this entry. Take it over
+         * only if that publisher no longer exists.
+         */
+        if(!(kill(e->writer, 0) == -1 && errno == ESRCH)) {
+            return;
+        }
+        next = seq + 2;
+    }
+    else {
+        next = seq + 1;
+    }
+
+    if(!__atomic_compare_exchange_n(&e->seq, &seq, next, 0,
+                                    __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        /* Lost the race to another publisher. */
+        return;
+    }
+    e->writer = getpid();
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    if(info) {
+        memcpy(&e->info, info, size);
+        e->updated = aim_time_monotonic();
+    }
+    else {
+        e->updated = 0;
+    }
+
+    __atomic_store_n(&e->seq, next + 1, __ATOMIC_RELEASE);
+}
+
+void
+onlp_snapshot_invalidate(onlp_oid_t oid)
+{
+    onlp_snapshot_entry_t* e = snapshot_entry__(oid);
+    if(e) {
+        snapshot_put__(e, NULL, 0);
+    }
+}
+
+typedef struct snapshot_oids_s {
+    int count;
+    onlp_oid_t oids[ONLP_OID_TABLE_SIZE];
+    /* Last published presence of each OID. -1 if not yet read. */
+    int present[ONLP_OID_TABLE_SIZE];
+} snapshot_oids_t;
+
+static snapshot_oids_t snapshot_oids__ = { -1 };
+
+static int
+snapshot_oids_collect__(onlp_oid_t oid, void* cookie)
+{
+    snapshot_oids_t* so = (snapshot_oids_t*)cookie;
+
+    if((ONLP_OID_IS_THERMAL(oid) || ONLP_OID_IS_FAN(oid) || ONLP_OID_IS_PSU(oid)) &&
+       so->count < AIM_ARRAYSIZE(so->oids)) {
+        so->present[so->count] = -1;
+        so->oids[so->count++] = oid;
+    }
+    return 0;
+}
+
+/*
+ * Enumerate the OIDs to publish. Entries for OIDs which have left
+ * the hierarchy since the last enumeration are invalidated.
+ */
+static int
+snapshot_oids_refresh__(void)
+{
+    int i, j;
+    snapshot_oids_t so;
+
+    so.count = 0;
+    if(onlp_oid_iterate(ONLP_OID_SYS, 0, snapshot_oids_collect__, &so) < 0) {
+        AIM_LOG_ERROR("Could not enumerate the telemetry snapshot OIDs.");
+        return -1;
+    }
+
+    for(i = 0; i < snapshot_oids__.count; i++) {
+        for(j = 0; j < so.count; j++) {
+            if(so.oids[j] == snapshot_oids__.oids[i]) {
+                break;
+            }
+        }
+        if(j == so.count) {
+            onlp_snapshot_invalidate(snapshot_oids__.oids[i]);
+        }
+    }
+
+    snapshot_oids__ = so;
+    return 0;
+}
+
+int
+onlp_snapshot_publish(void)
+{
+    int i;
+    int changed = 0;
+    snapshot_oids_t* so = &snapshot_oids__;
+
+    if(so->count < 0 && snapshot_oids_refresh__() < 0) {
+        return -1;
+    }
+
+    for(i = 0; i < so->count; i++) {
+        int rv;
+        int present;
+        onlp_oid_t oid = so->oids[i];
+        onlp_snapshot_entry_t* e = snapshot_entry__(oid);
+
+        if(e == NULL) {
+            continue;
+        }
+
+        if(ONLP_OID_IS_THERMAL(oid)) {
+            onlp_thermal_info_t ti;
+            rv = onlp_thermal_info_read(oid, &ti);
+            snapshot_put__(e, (rv < 0) ? NULL : &ti, sizeof(ti));
+            present = (rv >= 0) && (ti.status & ONLP_THERMAL_STATUS_PRESENT);
+        }
+        else if(ONLP_OID_IS_FAN(oid)) {
+            onlp_fan_info_t fi;
+            rv = onlp_fan_info_read(oid, &fi);
+            snapshot_put__(e, (rv < 0) ? NULL : &fi, sizeof(fi));
+            present = (rv >= 0) && (fi.status & ONLP_FAN_STATUS_PRESENT);
+        }
+        else {
+            onlp_psu_info_t pi;
+            rv = onlp_psu_info_read(oid, &pi);
+            snapshot_put__(e, (rv < 0) ? NULL : &pi, sizeof(pi));
+            present = (rv >= 0) && (pi.status & ONLP_PSU_STATUS_PRESENT);
+        }
+
+        if(so->present[i] >= 0 && so->present[i] != present) {
+            changed = 1;
+        }
+        so->present[i] = present;
+    }
+
+    if(changed) {
+        /*
+         * A device was inserted or removed. Its children may have
+         * changed as well, so enumerate again for the next period.
+         */
+        snapshot_oids_refresh__();
+    }
+    return 0;
+}
+
+#endif /* ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT */
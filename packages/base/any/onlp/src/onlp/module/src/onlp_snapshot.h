@@ -0,0 +1,60 @@
+/************************************************************
+ * <bsn.cl fy=2014 v=onl>
+ *
+ *        Copyright 2014, 2015 Big Switch Networks, Inc.
+ *
+ * Licensed under the Eclipse Public License, Version 1.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ *        http://www.eclipse.org/legal/epl-v10.html
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the
+ * License.
+ *
+ * </bsn.cl>
+ ************************************************************
+ *
+ * Shared telemetry snapshot.
+ *
+ ***********************************************************/
+#ifndef __ONLP_SNAPSHOT_H__
+#define __ONLP_SNAPSHOT_H__
+
+#include <onlp/onlp_config.h>
+#include <onlp/oids.h>
+
+#if ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT == 1
+
+/**
+ * @brief Get an OID's info struct from the snapshot.
+ * @param oid The thermal, fan, or psu OID.
+ * @param info Receives the info struct.
+ * @param size The size of the info struct.
+ * @returns ONLP_STATUS_OK if a fresh entry was available.
+ * @returns ONLP_STATUS_E_MISSING otherwise.
+ */
+int onlp_snapshot_get(onlp_oid_t oid, void* info, int size);
+
+/**
+ * @brief Read all thermal, fan, and psu OIDs from the
+ * platform and publish them to the snapshot.
+ * @note This is called periodically by the platform manager.
+ * The OIDs are enumerated again whenever one of them changes
+ * presence.
+ */
+int onlp_snapshot_publish(void);
+
+/**
+ * @brief Invalidate an OID's snapshot entry.
+ * @param oid The OID.
+ */
+void onlp_snapshot_invalidate(onlp_oid_t oid);
+
+#endif
+
+#endif /* __ONLP_SNAPSHOT_H__ */
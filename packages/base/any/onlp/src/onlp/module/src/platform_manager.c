@@ -33,9 +33,14 @@
 #include <AIM/aim.h>
 #include "onlp_log.h"
 #include "onlp_int.h"
+#include "onlp_snapshot.h"
+#include <cjson_util/cjson_util.h>
 #include <sys/eventfd.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <pthread.h>
+#include <stdint.h>
+#include <string.h>
 
 /**
  * Timer wheel callback entry.
@@ -47,17 +52,71 @@ typedef struct management_entry_s {
     /** This is the callback for this timer */
     int (*manage)(void);
 
-    /** This is the callback rate in microseconds */
+    /** This is the current callback rate in microseconds */
     uint64_t rate;
 
-    /** The name of this callback (for debugging) */
-    const char* name;
+    /** The name of this callback (for debugging and configuration) */
+    char name[32];
 
     /** The number of times this has been called. */
     int calls;
 
+    /** The registered callback rate in microseconds */
+    uint64_t rate_base;
+
+    /** The longest rate the callback may back off to */
+    uint64_t rate_max;
+
+    /** Back off after this many consecutive idle calls. Zero disables. */
+    int idle_cycles;
+
+    /** The current number of consecutive idle calls. */
+    int idle;
+
+    /** Set while the callback is executing. */
+    int running;
+
+    /** Set when the entry should be released. */
+    int removed;
+
+    /** The time the current call was dispatched. */
+    uint64_t started;
+
+    /** Set once an overrun of the current call has been logged. */
+    int warned;
+
+    /** The number of calls which exceeded the callback period. */
+    int overruns;
+
+    /** The longest call duration in microseconds. */
+    uint64_t runtime_max;
+
 } management_entry_t;
 
+#define MANAGEMENT_ENTRIES_MAX 32
+
+#define MANAGEMENT_INTERRUPTS_MAX 32
+#define MANAGEMENT_INTERRUPT_CALLBACKS_MAX 4
+
+/**
+ * Interrupt mapping.
+ */
+typedef struct management_interrupt_s {
+    /** The watched file (for debugging) */
+    char* path;
+
+    /** The callbacks to run when the interrupt fires */
+    char callbacks[MANAGEMENT_INTERRUPT_CALLBACKS_MAX][32];
+
+    /** The OIDs to invalidate when the interrupt fires */
+    onlp_oid_t* oids;
+    int count;
+
+    /** The number of times the interrupt has fired */
+    uint64_t fired;
+
+} management_interrupt_t;
+
 /**
  * Platform management control structure.
  */
@@ -67,10 +126,34 @@ typedef struct management_ctrl_s {
     int eventfd;
     pthread_t thread;
 
+    /* Wakes the management thread after a rate change. */
+    int wakefd;
+
+    /* Protects the entry table, timer wheel, and work queue. */
+    pthread_mutex_t lock;
+    management_entry_t* entries[MANAGEMENT_ENTRIES_MAX];
+
+    /*
+     * Worker pool. Expired entries are queued to the workers
+     * when any are running, otherwise they are called inline.
+     */
+    pthread_cond_t work;
+    management_entry_t* queue[MANAGEMENT_ENTRIES_MAX];
+    int queue_head;
+    int queue_count;
+    int workers;
+    /* Incremented to retire the current workers. */
+    int workers_gen;
+
+    /* Interrupt sources and their mappings. */
+    onlp_gpio_watcher_t* watcher;
+    management_interrupt_t* interrupts[MANAGEMENT_INTERRUPTS_MAX];
+
 } management_ctrl_t;
 
 /* This is the global control state */
-static management_ctrl_t control__ = { NULL };
+static management_ctrl_t control__ = { NULL, -1, 0, -1, PTHREAD_MUTEX_INITIALIZER,
+                                       { NULL }, PTHREAD_COND_INITIALIZER };
 
 
 /*
@@ -87,64 +170,621 @@ static int platform_psus_notify__(void);
 static int platform_fans_notify__(void);
 
 
+static management_entry_t*
+management_entry_find__(const char* name)
+{
+    int i;
+    for(i = 0; i < MANAGEMENT_ENTRIES_MAX; i++) {
+        management_entry_t* e = control__.entries[i];
+        if(e && !e->removed && !strcmp(e->name, name)) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static void
+management_wake__(void)
+{
+    if(control__.wakefd >= 0) {
+        uint64_t one = 1;
+        if(write(control__.wakefd, &one, sizeof(one)) < 0) {
+            /* The thread will pick up the change on its next wakeup. */
+        }
+    }
+}
 
 /*
- * First Version : Static callback rates.
- * TODO: Allow individual platform callbacks to reregister
- * themselves at whatever rate they want.
+ * Reschedule an entry which is not currently running.
  */
-static management_entry_t management_entries[] =
-    {
-        {
-            { },
-            onlp_sysi_platform_manage_fans,
-            /* Every 10 seconds */
-            10*1000*1000,
-            "Fans",
-        },
-        {
-            { },
-            onlp_sysi_platform_manage_leds,
-            /* Every 2 seconds */
-            2*1000*1000,
-            "LEDs",
-
-        },
-        {
-            { },
-            platform_psus_notify__,
-            /* Every second */
-            1*1000*1000,
-            "PSUs",
-        },
-        {
-            { },
-            platform_fans_notify__,
-            /* Every second */
-            1*1000*1000,
-            "Fans",
-        }
-    };
+static void
+management_entry_schedule__(management_entry_t* e, uint64_t now)
+{
+    if(control__.tw && !e->running) {
+        timer_wheel_remove(control__.tw, &e->twe);
+        timer_wheel_insert(control__.tw, &e->twe, now + e->rate);
+    }
+}
+
+/*
+ * Apply any overrides from the configuration file:
+ *
+ * "platform-manager" : {
+ *     "<name>" : { "rate" : <usecs>, "rate-max" : <usecs>, "idle-cycles" : <n> }
+ * }
+ *
+ * A rate of zero disables the callback.
+ */
+static void
+management_entry_config__(management_entry_t* e)
+{
+    int v;
+    cJSON* root = onlp_json_get(0);
+
+    if(cjson_util_lookup_int(root, &v, "platform-manager.%s.rate", e->name) == 0) {
+        e->rate_base = e->rate = v;
+    }
+    if(cjson_util_lookup_int(root, &v, "platform-manager.%s.rate-max", e->name) == 0) {
+        e->rate_max = v;
+    }
+    if(cjson_util_lookup_int(root, &v, "platform-manager.%s.idle-cycles", e->name) == 0) {
+        e->idle_cycles = v;
+    }
+    if(e->rate_max < e->rate_base) {
+        e->rate_max = e->rate_base;
+    }
+}
+
+static int
+management_interrupt_calls__(management_interrupt_t* mi, const char* name)
+{
+    int i;
+    for(i = 0; i < MANAGEMENT_INTERRUPT_CALLBACKS_MAX; i++) {
+        if(!strcmp(mi->callbacks[i], name)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Callbacks which are triggered by an interrupt only need to
+ * poll as a safety scan in case an interrupt is missed.
+ */
+static void
+management_entry_safety__(management_entry_t* e)
+{
+    int i;
+    for(i = 0; i < MANAGEMENT_INTERRUPTS_MAX; i++) {
+        management_interrupt_t* mi = control__.interrupts[i];
+        if(mi && management_interrupt_calls__(mi, e->name)) {
+            if(e->rate_base && e->rate_base < ONLP_CONFIG_PLATFORM_MANAGE_INTERRUPT_SAFETY_RATE) {
+                e->rate = e->rate_base = ONLP_CONFIG_PLATFORM_MANAGE_INTERRUPT_SAFETY_RATE;
+            }
+            if(e->rate_max < e->rate_base) {
+                e->rate_max = e->rate_base;
+            }
+            return;
+        }
+    }
+}
+
+static int
+management_entry_add__(const char* name, int (*manage)(void), uint64_t rate,
+                       uint64_t rate_max, int idle_cycles)
+{
+    int i;
+    management_entry_t* e;
+
+    if(name == NULL || manage == NULL) {
+        return ONLP_STATUS_E_PARAM;
+    }
+    if(management_entry_find__(name)) {
+        return ONLP_STATUS_E_PARAM;
+    }
+
+    for(i = 0; i < MANAGEMENT_ENTRIES_MAX; i++) {
+        if(control__.entries[i] == NULL) {
+            break;
+        }
+    }
+    if(i == MANAGEMENT_ENTRIES_MAX) {
+        AIM_LOG_ERROR("Cannot register platform management callback '%s': too many callbacks.", name);
+        return ONLP_STATUS_E_INTERNAL;
+    }
+
+    e = aim_zmalloc(sizeof(*e));
+    aim_strlcpy(e->name, name, sizeof(e->name));
+    e->manage = manage;
+    e->rate = e->rate_base = rate;
+    e->rate_max = rate_max;
+    e->idle_cycles = idle_cycles;
+    management_entry_config__(e);
+    management_entry_safety__(e);
+    control__.entries[i] = e;
+
+    if(control__.tw && e->rate) {
+        timer_wheel_insert(control__.tw, &e->twe, os_time_monotonic() + e->rate);
+        management_wake__();
+    }
+    return ONLP_STATUS_OK;
+}
+
+static void
+management_entry_free__(management_entry_t* e)
+{
+    int i;
+    for(i = 0; i < MANAGEMENT_ENTRIES_MAX; i++) {
+        if(control__.entries[i] == e) {
+            control__.entries[i] = NULL;
+        }
+    }
+    aim_free(e);
+}
+
+int
+onlp_sys_platform_manage_register(const char* name, int (*manage)(void),
+                                  uint64_t rate)
+{
+    int rv;
+    pthread_mutex_lock(&control__.lock);
+    rv = management_entry_add__(name, manage, rate, rate, 0);
+    pthread_mutex_unlock(&control__.lock);
+    return rv;
+}
+
+int
+onlp_sys_platform_manage_unregister(const char* name)
+{
+    int rv = ONLP_STATUS_E_MISSING;
+    management_entry_t* e;
+
+    pthread_mutex_lock(&control__.lock);
+    if( (e = management_entry_find__(name)) ) {
+        if(e->running) {
+            /* Released by the management thread when the callback returns. */
+            e->removed = 1;
+        }
+        else {
+            if(control__.tw && e->rate) {
+                timer_wheel_remove(control__.tw, &e->twe);
+            }
+            management_entry_free__(e);
+        }
+        rv = ONLP_STATUS_OK;
+    }
+    pthread_mutex_unlock(&control__.lock);
+    return rv;
+}
 
+int
+onlp_sys_platform_manage_rate_set(const char* name, uint64_t rate)
+{
+    int rv = ONLP_STATUS_E_MISSING;
+    management_entry_t* e;
+
+    if(rate == 0) {
+        return ONLP_STATUS_E_PARAM;
+    }
+
+    pthread_mutex_lock(&control__.lock);
+    if( (e = management_entry_find__(name)) ) {
+        uint64_t old = e->rate;
+        e->rate = e->rate_base = rate;
+        if(e->rate_max < e->rate_base) {
+            e->rate_max = e->rate_base;
+        }
+        e->idle = 0;
+        if(old) {
+            management_entry_schedule__(e, os_time_monotonic());
+        }
+        else if(control__.tw && !e->running) {
+            timer_wheel_insert(control__.tw, &e->twe, os_time_monotonic() + e->rate);
+        }
+        management_wake__();
+        rv = ONLP_STATUS_OK;
+    }
+    pthread_mutex_unlock(&control__.lock);
+    return rv;
+}
+
+int
+onlp_sys_platform_manage_rate_get(const char* name, uint64_t* rate)
+{
+    int rv = ONLP_STATUS_E_MISSING;
+    management_entry_t* e;
+
+    pthread_mutex_lock(&control__.lock);
+    if( (e = management_entry_find__(name)) ) {
+        *rate = e->rate;
+        rv = ONLP_STATUS_OK;
+    }
+    pthread_mutex_unlock(&control__.lock);
+    return rv;
+}
+
+int
+onlp_sys_platform_manage_backoff_set(const char* name, uint64_t rate_max,
+                                     int idle_cycles)
+{
+    int rv = ONLP_STATUS_E_MISSING;
+    management_entry_t* e;
+
+    pthread_mutex_lock(&control__.lock);
+    if( (e = management_entry_find__(name)) ) {
+        e->rate_max = (rate_max > e->rate_base) ? rate_max : e->rate_base;
+        e->idle_cycles = idle_cycles;
+        e->idle = 0;
+        rv = ONLP_STATUS_OK;
+    }
+    pthread_mutex_unlock(&control__.lock);
+    return rv;
+}
+
+/*
+ * Adjust the rate of an entry based on the result of its last call.
+ * Callbacks return > 0 when they observed a change. Consecutive
+ * idle calls stretch the rate up to rate_max. Any change restores
+ * the registered rate.
+ */
+static void
+management_entry_backoff__(management_entry_t* e, int rv)
+{
+    if(e->idle_cycles == 0) {
+        return;
+    }
+    if(rv > 0) {
+        e->idle = 0;
+        if(e->rate != e->rate_base) {
+            AIM_LOG_VERBOSE("%s: activity, rate restored to %"PRIu64" usecs",
+                            e->name, e->rate_base);
+            e->rate = e->rate_base;
+        }
+    }
+    else if(++e->idle >= e->idle_cycles && e->rate < e->rate_max) {
+        e->idle = 0;
+        e->rate = (e->rate*2 < e->rate_max) ? e->rate*2 : e->rate_max;
+        AIM_LOG_VERBOSE("%s: idle, rate stretched to %"PRIu64" usecs",
+                        e->name, e->rate);
+    }
+}
+
+/*
+ * Interrupt handler. Runs on the thread calling
+ * onlp_sys_platform_manage_now().
+ */
+static void
+management_interrupt__(void* cookie, const char* path, int value)
+{
+    int i;
+    management_interrupt_t* mi = (management_interrupt_t*)cookie;
+
+    AIM_LOG_VERBOSE("interrupt: %s=%d", path, value);
+
+    for(i = 0; i < mi->count; i++) {
+        onlp_oid_cache_flush(mi->oids[i]);
+#if ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT == 1
+        onlp_snapshot_invalidate(mi->oids[i]);
+#endif
+    }
+
+    pthread_mutex_lock(&control__.lock);
+    mi->fired++;
+    for(i = 0; i < MANAGEMENT_INTERRUPT_CALLBACKS_MAX; i++) {
+        management_entry_t* e;
+        if(mi->callbacks[i][0] && (e = management_entry_find__(mi->callbacks[i]))) {
+            /* Due now. A running entry is rescheduled when it completes. */
+            e->idle = 0;
+            if(control__.tw && e->rate && !e->running) {
+                timer_wheel_remove(control__.tw, &e->twe);
+                timer_wheel_insert(control__.tw, &e->twe, os_time_monotonic());
+            }
+        }
+    }
+    pthread_mutex_unlock(&control__.lock);
+}
+
+static int
+management_interrupt_add__(int gpio, onlp_gpio_edge_t edge, const char* path,
+                           const char* callbacks,
+                           const onlp_oid_t* oids, int count)
+{
+    int i, rv, slot;
+    char* names;
+    char* name;
+    char* saveptr = NULL;
+    management_interrupt_t* mi;
+
+    if(callbacks == NULL || count < 0 || (count && oids == NULL)) {
+        return ONLP_STATUS_E_PARAM;
+    }
+
+    pthread_mutex_lock(&control__.lock);
+
+    for(slot = 0; slot < MANAGEMENT_INTERRUPTS_MAX; slot++) {
+        if(control__.interrupts[slot] == NULL) {
+            break;
+        }
+    }
+    if(slot == MANAGEMENT_INTERRUPTS_MAX) {
+        AIM_LOG_ERROR("Cannot register interrupt: too many interrupts.");
+        pthread_mutex_unlock(&control__.lock);
+        return ONLP_STATUS_E_INTERNAL;
+    }
+
+    if(control__.watcher == NULL &&
+       (rv = onlp_gpio_watcher_create(&control__.watcher)) < 0) {
+        pthread_mutex_unlock(&control__.lock);
+        return rv;
+    }
+
+    mi = aim_zmalloc(sizeof(*mi));
+    names = aim_strdup(callbacks);
+    for(i = 0, name = strtok_r(names, ", ", &saveptr);
+        name && i < MANAGEMENT_INTERRUPT_CALLBACKS_MAX;
+        i++, name = strtok_r(NULL, ", ", &saveptr)) {
+        aim_strlcpy(mi->callbacks[i], name, sizeof(mi->callbacks[i]));
+    }
+    aim_free(names);
+    if(count) {
+        mi->oids = aim_zmalloc(count*sizeof(*oids));
+        memcpy(mi->oids, oids, count*sizeof(*oids));
+        mi->count = count;
+    }
+
+    if(path) {
+        mi->path = aim_strdup(path);
+        rv = onlp_gpio_watch_file(control__.watcher, management_interrupt__, mi,
+                                  "%s", path);
+    }
+    else {
+        mi->path = aim_fstrdup("gpio%d", gpio);
+        rv = onlp_gpio_watch_gpio(control__.watcher, gpio, edge,
+                                  management_interrupt__, mi);
+    }
+    if(rv < 0) {
+        aim_free(mi->path);
+        aim_free(mi->oids);
+        aim_free(mi);
+        pthread_mutex_unlock(&control__.lock);
+        return rv;
+    }
+    control__.interrupts[slot] = mi;
+
+    /* Drop the mapped callbacks to the safety scan rate. */
+    for(i = 0; i < MANAGEMENT_ENTRIES_MAX; i++) {
+        management_entry_t* e = control__.entries[i];
+        if(e && !e->removed && management_interrupt_calls__(mi, e->name)) {
+            uint64_t rate = e->rate;
+            management_entry_safety__(e);
+            if(rate && e->rate != rate) {
+                management_entry_schedule__(e, os_time_monotonic());
+            }
+        }
+    }
+
+    /* The management thread must add the watcher to its wait set. */
+    management_wake__();
+    pthread_mutex_unlock(&control__.lock);
+    return ONLP_STATUS_OK;
+}
+
+int
+onlp_sys_platform_manage_interrupt_gpio(int gpio, onlp_gpio_edge_t edge,
+                                        const char* callbacks,
+                                        const onlp_oid_t* oids, int count)
+{
+    return management_interrupt_add__(gpio, edge, NULL, callbacks, oids, count);
+}
+
+int
+onlp_sys_platform_manage_interrupt_file(const char* path,
+                                        const char* callbacks,
+                                        const onlp_oid_t* oids, int count)
+{
+    if(path == NULL) {
+        return ONLP_STATUS_E_PARAM;
+    }
+    return management_interrupt_add__(-1, ONLP_GPIO_EDGE_NONE, path,
+                                      callbacks, oids, count);
+}
+
+static pthread_once_t sysi_manage_init_once__ = PTHREAD_ONCE_INIT;
+
+static void
+sysi_manage_init__(void)
+{
+    /* Platforms may register additional callbacks here. */
+    onlp_sysi_platform_manage_init();
+}
 
 void
 onlp_sys_platform_manage_init(void)
 {
+    pthread_mutex_lock(&control__.lock);
     if(control__.tw == NULL) {
         int i;
-        uint64_t now = os_time_monotonic();
+        uint64_t now;
 
-        onlp_sysi_platform_manage_init();
-        control__.tw = timer_wheel_create(4, 512, now);
+        /*
+         * The platform registers its callbacks with the control lock,
+         * so it cannot be held here. The once control keeps concurrent
+         * callers from running the platform init twice.
+         */
+        pthread_mutex_unlock(&control__.lock);
+        pthread_once(&sysi_manage_init_once__, sysi_manage_init__);
+        pthread_mutex_lock(&control__.lock);
 
-        for(i = 0; i < AIM_ARRAYSIZE(management_entries); i++) {
-            management_entry_t* e = management_entries+i;
-            timer_wheel_insert(control__.tw,  &e->twe, now + e->rate);
+        if(control__.tw == NULL) {
+            /* Every 10 seconds */
+            management_entry_add__("fans", onlp_sysi_platform_manage_fans,
+                                   10*1000*1000, 10*1000*1000, 0);
+            /* Every 2 seconds */
+            management_entry_add__("leds", onlp_sysi_platform_manage_leds,
+                                   2*1000*1000, 2*1000*1000, 0);
+            /* Every second, backing off while nothing changes */
+            management_entry_add__("psu-notify", platform_psus_notify__,
+                                   1*1000*1000, ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_RATE_MAX,
+                                   ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_IDLE_CYCLES);
+            management_entry_add__("fan-notify", platform_fans_notify__,
+                                   1*1000*1000, ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_RATE_MAX,
+                                   ONLP_CONFIG_PLATFORM_MANAGE_NOTIFY_IDLE_CYCLES);
+#if ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT == 1
+            management_entry_add__("snapshot", onlp_snapshot_publish,
+                                   ONLP_CONFIG_TELEMETRY_SNAPSHOT_RATE,
+                                   ONLP_CONFIG_TELEMETRY_SNAPSHOT_RATE, 0);
+#endif
+
+            now = os_time_monotonic();
+            control__.tw = timer_wheel_create(4, 512, now);
+
+            for(i = 0; i < MANAGEMENT_ENTRIES_MAX; i++) {
+                management_entry_t* e = control__.entries[i];
+                if(e && e->rate) {
+                    timer_wheel_insert(control__.tw,  &e->twe, now + e->rate);
+                }
+            }
         }
     }
+    pthread_mutex_unlock(&control__.lock);
 }
 
 
+/*
+ * Account for a completed call and reschedule the entry.
+ * Called with the control lock held.
+ */
+static void
+management_entry_complete__(management_entry_t* e, int rv)
+{
+    uint64_t runtime = os_time_monotonic() - e->started;
+
+    e->running = 0;
+    e->calls++;
+    if(runtime > e->runtime_max) {
+        e->runtime_max = runtime;
+    }
+    if(e->rate && runtime > e->rate) {
+        e->overruns++;
+        AIM_LOG_WARN("Platform management callback '%s' took %"PRIu64" usecs (period %"PRIu64" usecs).",
+                     e->name, runtime, e->rate);
+    }
+
+    if(e->removed) {
+        management_entry_free__(e);
+        return;
+    }
+    management_entry_backoff__(e, rv);
+    if(e->rate) {
+        timer_wheel_insert(control__.tw, &e->twe, os_time_monotonic() + e->rate);
+    }
+}
+
+/*
+ * Log calls which are still running past their period.
+ * Called with the control lock held.
+ */
+static void
+management_entries_check__(uint64_t now)
+{
+    int i;
+    for(i = 0; i < MANAGEMENT_ENTRIES_MAX; i++) {
+        management_entry_t* e = control__.entries[i];
+        if(e && e->running && !e->warned && e->rate &&
+           now - e->started > e->rate) {
+            e->warned = 1;
+            AIM_LOG_WARN("Platform management callback '%s' has not completed after %"PRIu64" usecs (period %"PRIu64" usecs).",
+                         e->name, now - e->started, e->rate);
+        }
+    }
+}
+
+static void*
+management_worker__(void* arg)
+{
+    int gen = (int)(intptr_t)arg;
+
+    os_thread_name_set("onlp.sys.pmw");
+
+    pthread_mutex_lock(&control__.lock);
+    for(;;) {
+        management_entry_t* e;
+        int rv;
+
+        while(control__.queue_count == 0 && control__.workers_gen == gen) {
+            pthread_cond_wait(&control__.work, &control__.lock);
+        }
+        if(control__.workers_gen != gen) {
+            break;
+        }
+
+        e = control__.queue[control__.queue_head];
+        control__.queue_head = (control__.queue_head + 1) % MANAGEMENT_ENTRIES_MAX;
+        control__.queue_count--;
+
+        pthread_mutex_unlock(&control__.lock);
+        rv = e->manage();
+        pthread_mutex_lock(&control__.lock);
+
+        management_entry_complete__(e, rv);
+        /* The entry's next deadline may be the earliest. */
+        management_wake__();
+    }
+    pthread_mutex_unlock(&control__.lock);
+    return NULL;
+}
+
+static int
+management_workers_start__(int count)
+{
+    int i;
+    pthread_attr_t attr;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    pthread_mutex_lock(&control__.lock);
+    for(i = 0; i < count; i++) {
+        pthread_t thread;
+        if(pthread_create(&thread, &attr, management_worker__,
+                          (void*)(intptr_t)control__.workers_gen) != 0) {
+            AIM_LOG_ERROR("Platform management worker create failed.");
+            break;
+        }
+        control__.workers++;
+    }
+    pthread_mutex_unlock(&control__.lock);
+
+    pthread_attr_destroy(&attr);
+    return i;
+}
+
+/*
+ * Retire the current workers. Workers which are blocked in a callback
+ * exit when it returns. Queued entries are returned to the timer wheel.
+ */
+static void
+management_workers_stop__(void)
+{
+    pthread_mutex_lock(&control__.lock);
+    control__.workers_gen++;
+    control__.workers = 0;
+    while(control__.queue_count) {
+        management_entry_t* e = control__.queue[control__.queue_head];
+        control__.queue_head = (control__.queue_head + 1) % MANAGEMENT_ENTRIES_MAX;
+        control__.queue_count--;
+        e->running = 0;
+        if(e->removed) {
+            management_entry_free__(e);
+        }
+        else if(e->rate) {
+            timer_wheel_insert(control__.tw, &e->twe, os_time_monotonic() + e->rate);
+        }
+    }
+    pthread_cond_broadcast(&control__.work);
+    pthread_mutex_unlock(&control__.lock);
+}
+
 void
 onlp_sys_platform_manage_now(void)
 {
@@ -152,14 +792,63 @@ onlp_sys_platform_manage_now(void)
 
     onlp_sys_platform_manage_init();
 
+    if(control__.watcher) {
+        /* Dispatch any pending interrupts. Their callbacks are now due. */
+        onlp_gpio_watcher_run(control__.watcher, 0);
+    }
+
+    pthread_mutex_lock(&control__.lock);
     while( (e = (management_entry_t*) timer_wheel_next(control__.tw,
                                                        os_time_monotonic())) ) {
+        int rv = 0;
+
+        e->running = 1;
+        e->warned = 0;
+        e->started = os_time_monotonic();
+
+        if(control__.workers) {
+            int tail = (control__.queue_head + control__.queue_count) % MANAGEMENT_ENTRIES_MAX;
+            control__.queue[tail] = e;
+            control__.queue_count++;
+            pthread_cond_signal(&control__.work);
+            continue;
+        }
+
+        /* Callbacks may use the registration interfaces. */
+        pthread_mutex_unlock(&control__.lock);
         if(e->manage) {
-            e->manage();
+            rv = e->manage();
         }
-        e->calls++;
-        timer_wheel_insert(control__.tw, &e->twe, os_time_monotonic() + e->rate);
+        pthread_mutex_lock(&control__.lock);
+        management_entry_complete__(e, rv);
     }
+    management_entries_check__(os_time_monotonic());
+    pthread_mutex_unlock(&control__.lock);
+}
+
+void
+onlp_sys_platform_manage_stats_show(aim_pvs_t* pvs)
+{
+    int i;
+
+    aim_printf(pvs, "%-16s %10s %10s %10s %10s %12s\n",
+               "callback", "rate", "calls", "overruns", "running", "runtime-max");
+    pthread_mutex_lock(&control__.lock);
+    for(i = 0; i < MANAGEMENT_ENTRIES_MAX; i++) {
+        management_entry_t* e = control__.entries[i];
+        if(e && !e->removed) {
+            aim_printf(pvs, "%-16s %10"PRIu64" %10d %10d %10s %12"PRIu64"\n",
+                       e->name, e->rate, e->calls, e->overruns,
+                       e->running ? "yes" : "no", e->runtime_max);
+        }
+    }
+    for(i = 0; i < MANAGEMENT_INTERRUPTS_MAX; i++) {
+        management_interrupt_t* mi = control__.interrupts[i];
+        if(mi) {
+            aim_printf(pvs, "interrupt %s: fired %"PRIu64"\n", mi->path, mi->fired);
+        }
+    }
+    pthread_mutex_unlock(&control__.lock);
 }
 
 static void*
@@ -178,15 +867,29 @@ onlp_sys_platform_manage_thread__(void* vctrl)
         uint64_t now;
         struct timeval tv;
         timer_wheel_entry_t* twe;
+        uint64_t deadline = 0;
 
         FD_ZERO(&fds);
         FD_SET(ctrl->eventfd, &fds);
+        FD_SET(ctrl->wakefd, &fds);
+        int maxfd = (ctrl->eventfd > ctrl->wakefd) ? ctrl->eventfd : ctrl->wakefd;
+        if(ctrl->watcher) {
+            /* Interrupts are dispatched by onlp_sys_platform_manage_now() */
+            int wfd = onlp_gpio_watcher_fd(ctrl->watcher);
+            FD_SET(wfd, &fds);
+            maxfd = (wfd > maxfd) ? wfd : maxfd;
+        }
 
         /*
          * Ask the timer wheel if there is an expiration in the next 2 seconds.
          */
         now = os_time_monotonic();
+        pthread_mutex_lock(&control__.lock);
         twe = timer_wheel_peek(ctrl->tw, now + 20000000);
+        if(twe) {
+            deadline = twe->deadline;
+        }
+        pthread_mutex_unlock(&control__.lock);
 
         if(twe == NULL) {
             /* Nothing in the next two seconds. */
@@ -194,10 +897,10 @@ onlp_sys_platform_manage_thread__(void* vctrl)
             tv.tv_usec = 0;
         }
         else {
-            if(twe->deadline > now) {
+            if(deadline > now) {
                 /* Sleep until next deadline */
-                tv.tv_sec = (twe->deadline - now) / 1000000;
-                tv.tv_usec = (twe->deadline - now) % 1000000;
+                tv.tv_sec = (deadline - now) / 1000000;
+                tv.tv_usec = (deadline - now) % 1000000;
             }
             else {
                 /* We have surpassed the current deadline */
@@ -206,8 +909,8 @@ onlp_sys_platform_manage_thread__(void* vctrl)
             }
         }
 
-        int rv = select(ctrl->eventfd+1, &fds, NULL, NULL, &tv);
-        if(rv == 1 && FD_ISSET(ctrl->eventfd, &fds)) {
+        int rv = select(maxfd+1, &fds, NULL, NULL, &tv);
+        if(rv > 0 && FD_ISSET(ctrl->eventfd, &fds)) {
             /* We've been asked to terminate. */
             AIM_LOG_MSG("Terminating.");
             /* Also signifies that we have exit */
@@ -215,6 +918,13 @@ onlp_sys_platform_manage_thread__(void* vctrl)
             ctrl->eventfd = -1;
             return NULL;
         }
+        if(rv > 0 && FD_ISSET(ctrl->wakefd, &fds)) {
+            /* A rate has changed. Clear the wakeup and recompute the deadline. */
+            uint64_t count;
+            if(read(ctrl->wakefd, &count, sizeof(count)) < 0) {
+                AIM_LOG_ERROR("wakefd read failed: %{errno}", errno);
+            }
+        }
         if(rv < 0) {
             AIM_LOG_ERROR("select() returned %d (%{errno})", rv, errno);
             /* Sleep 1 second, but continue to run */
@@ -243,6 +953,14 @@ onlp_sys_platform_manage_start(int block)
         return -1;
     }
 
+    if(control__.wakefd < 0 &&
+       (control__.wakefd = eventfd(0, EFD_NONBLOCK)) < 0) {
+        AIM_LOG_ERROR("eventfd create failed: %{errno}", errno);
+        close(control__.eventfd);
+        control__.eventfd = -1;
+        return -1;
+    }
+
     if( (pthread_create(&control__.thread, NULL, onlp_sys_platform_manage_thread__,
                         &control__)) != 0) {
         AIM_LOG_ERROR("pthread create failed.");
@@ -251,6 +969,10 @@ onlp_sys_platform_manage_start(int block)
         return -1;
     }
 
+#if ONLP_CONFIG_PLATFORM_MANAGE_WORKERS > 0
+    management_workers_start__(ONLP_CONFIG_PLATFORM_MANAGE_WORKERS);
+#endif
+
     if(block) {
         onlp_sys_platform_manage_join();
     }
@@ -265,6 +987,7 @@ onlp_sys_platform_manage_stop(int block)
         uint64_t zero = 1;
         /* Tell the thread to exit */
         write(control__.eventfd, &zero, sizeof(zero));
+        management_workers_stop__();
 
         if(block) {
             onlp_sys_platform_manage_join();
@@ -292,6 +1015,7 @@ platform_psus_notify__(void)
     static onlp_oid_t psu_oid_table[ONLP_OID_TABLE_SIZE] = {0};
     static onlp_psu_info_t psu_info_table[ONLP_OID_TABLE_SIZE];
     int i = 0;
+    int changed = 0;
     static int flag[ONLP_OID_TABLE_SIZE] = {0};
 
     if(psu_oid_table[0] == 0) {
@@ -348,6 +1072,7 @@ platform_psus_notify__(void)
          * Log any presences or failure transitions.
          */
         if(pi.status != psu_info_table[i].status) {
+            changed = 1;
             uint32_t new = pi.status;
             uint32_t old = psu_info_table[i].status;
 
@@ -396,7 +1121,7 @@ platform_psus_notify__(void)
             memcpy(psu_info_table+i, &pi, sizeof(pi));
         }
     }
-    return 0;
+    return changed;
 }
 
 static int
@@ -405,6 +1130,7 @@ platform_fans_notify__(void)
     static onlp_oid_t fan_oid_table[ONLP_OID_TABLE_SIZE] = {0};
     static onlp_fan_info_t fan_info_table[ONLP_OID_TABLE_SIZE];
     int i = 0;
+    int changed = 0;
     static int flag[ONLP_OID_TABLE_SIZE] = {0};
 
     if(fan_oid_table[0] == 0) {
@@ -456,6 +1182,7 @@ platform_fans_notify__(void)
          * Log any presences or failure transitions.
          */
         if(fi.status != fan_info_table[i].status) {
+            changed = 1;
             uint32_t new = fi.status;
             uint32_t old = fan_info_table[i].status;
 
@@ -487,7 +1214,7 @@ platform_fans_notify__(void)
             memcpy(fan_info_table+i, &fi, sizeof(fi));
         }
     }
-    return 0;
+    return changed;
 }
 
 
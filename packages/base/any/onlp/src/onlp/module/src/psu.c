@@ -29,6 +29,8 @@
 #include <onlp/platformi/psui.h>
 #include "onlp_int.h"
 #include "onlp_locks.h"
+#include "onlp_oid_cache.h"
+#include "onlp_snapshot.h"
 
 #define VALIDATE(_id)                           \
     do {                                        \
@@ -53,12 +55,34 @@ onlp_psu_init_locked__(void)
 ONLP_LOCKED_API0(onlp_psu_init);
 
 static int
-onlp_psu_info_get_locked__(onlp_oid_t id,  onlp_psu_info_t* info)
+onlp_psu_info_read_locked__(onlp_oid_t id,  onlp_psu_info_t* info)
 {
     VALIDATE(id);
     return onlp_psui_info_get(id, info);
 }
-ONLP_LOCKED_API2(onlp_psu_info_get, onlp_oid_t, id, onlp_psu_info_t*, info);
+ONLP_LOCKED_API2(onlp_psu_info_read, onlp_oid_t, id, onlp_psu_info_t*, info);
+
+int
+onlp_psu_info_get(onlp_oid_t id, onlp_psu_info_t* info)
+{
+    int rv;
+    uint32_t gen;
+
+    if(onlp_oid_cache_get(id, info, sizeof(*info), &gen) == ONLP_STATUS_OK) {
+        return ONLP_STATUS_OK;
+    }
+#if ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT == 1
+    if(!onlp_oid_cache_bypassed() &&
+       onlp_snapshot_get(id, info, sizeof(*info)) == ONLP_STATUS_OK) {
+        return ONLP_STATUS_OK;
+    }
+#endif
+    rv = onlp_psu_info_read(id, info);
+    if(rv >= 0) {
+        onlp_oid_cache_put(id, info, sizeof(*info), gen);
+    }
+    return rv;
+}
 
 static int
 onlp_psu_status_get_locked__(onlp_oid_t id, uint32_t* status)
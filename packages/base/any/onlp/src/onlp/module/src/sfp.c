@@ -32,6 +32,11 @@
  */
 static onlp_sfp_bitmap_t sfpi_bitmap__;
 
+/**
+ * The bus of each port, or -1 if unknown.
+ */
+static int sfpi_bus__[ONLP_SFP_PORT_COUNT_MAX];
+
 void
 onlp_sfp_bitmap_t_init(onlp_sfp_bitmap_t* bmap)
 {
@@ -39,6 +44,29 @@ onlp_sfp_bitmap_t_init(onlp_sfp_bitmap_t* bmap)
     AIM_BITMAP_CLR_ALL(bmap);
 }
 
+static void
+onlp_sfp_topology_init__(void)
+{
+    int p;
+
+    for(p = 0; p < ONLP_SFP_PORT_COUNT_MAX; p++) {
+        int rport = p;
+        sfpi_bus__[p] = -1;
+        if(AIM_BITMAP_GET(&sfpi_bitmap__, p)) {
+            onlp_sfpi_port_map(p, &rport);
+            if(onlp_sfpi_port_bus_get(rport, sfpi_bus__ + p) < 0) {
+                sfpi_bus__[p] = -1;
+            }
+        }
+    }
+}
+
+int
+onlp_sfp_port_bus(int port)
+{
+    return (port >= 0 && port < ONLP_SFP_PORT_COUNT_MAX) ? sfpi_bus__[port] : -1;
+}
+
 static int
 onlp_sfp_init_locked__(void)
 {
@@ -64,6 +92,7 @@ onlp_sfp_init_locked__(void)
             AIM_LOG_ERROR("onlp_sfpi_bitmap_get(): %{onlp_status}", rv);
             return rv;
         }
+        onlp_sfp_topology_init__();
         return ONLP_STATUS_OK;
     }
 }
@@ -105,28 +134,45 @@ onlp_sfp_is_present_locked__(int port)
     ONLP_SFP_PORT_VALIDATE_AND_MAP(port);
     return onlp_sfpi_is_present(port);
 }
-ONLP_LOCKED_API1(onlp_sfp_is_present, int, port);
+ONLP_LOCKED_PORT_API1(onlp_sfp_is_present, int, port);
+
+/*
+ * The calling thread holds the SFP lock on behalf of the sweep threads.
+ */
+static int
+onlp_sfp_presence_sweep__(int port, void* cookie)
+{
+    return onlp_sfp_is_present_locked__(port);
+}
 
 static int
 onlp_sfp_presence_bitmap_get_locked__(onlp_sfp_bitmap_t* dst)
 {
+    int rv;
+
     onlp_sfp_bitmap_t_init(dst);
-    int rv = onlp_sfpi_presence_bitmap_get(dst);
+    rv = onlp_sfpi_presence_bitmap_get(dst);
 
     if(rv == ONLP_STATUS_E_UNSUPPORTED) {
-        /* Generate from single-port API */
+        /*
+         * Generate from single-port API. Ports on different
+         * buses are read concurrently.
+         */
         int p;
+        int* results = aim_zmalloc(sizeof(int) * ONLP_SFP_PORT_COUNT_MAX);
+        onlp_sfp_sweep(&sfpi_bitmap__, onlp_sfp_presence_sweep__, NULL, results);
+        rv = 0;
         AIM_BITMAP_CLR_ALL(dst);
         AIM_BITMAP_ITER(&sfpi_bitmap__, p) {
-            rv = onlp_sfp_is_present_locked__(p);
-            if(rv < 0) {
-                return rv;
+            if(results[p] < 0) {
+                rv = results[p];
+                break;
             }
-            if(rv > 0) {
+            if(results[p] > 0) {
                 AIM_BITMAP_SET(dst, p);
             }
         }
-        return 0;
+        aim_free(results);
     }
 
     return rv;
@@ -154,7 +200,7 @@ onlp_sfp_eeprom_read_locked__(int port, uint8_t** datap)
     *datap = data;
     return rv;
 }
-ONLP_LOCKED_API2(onlp_sfp_eeprom_read, int, port, uint8_t**, rv);
+ONLP_LOCKED_PORT_API2(onlp_sfp_eeprom_read, int, port, uint8_t**, rv);
 
 static int
 onlp_sfp_dom_read_locked__(int port, uint8_t** datap)
@@ -171,29 +217,176 @@ onlp_sfp_dom_read_locked__(int port, uint8_t** datap)
     *datap = data;
     return rv;
 }
-ONLP_LOCKED_API2(onlp_sfp_dom_read, int, port, uint8_t**, rv);
+ONLP_LOCKED_PORT_API2(onlp_sfp_dom_read, int, port, uint8_t**, rv);
+
+/*
+ * Paged EEPROM access.
+ *
+ * The upper half of each device address (bytes 128-255) is a window
+ * onto the page selected by byte 127 of the lower half. Modules with
+ * flat memory only implement page 0.
+ */
+#define SFP_EEPROM_PAGE_SELECT 127
+#define SFP_EEPROM_UPPER       128
+
+static int
+sfp_eeprom_paged__(int port, uint8_t devaddr)
+{
+    int id, status;
+
+    if((id = onlp_sfpi_dev_readb(port, 0x50, 0)) < 0) {
+        return id;
+    }
+
+    switch(id)
+        {
+        case 0x0C: /* QSFP */
+        case 0x0D: /* QSFP+ */
+        case 0x11: /* QSFP28 */
+            /* SFF-8636: byte 2 bit 2 is Flat_mem */
+            status = onlp_sfpi_dev_readb(port, 0x50, 2);
+            return (status < 0) ? status : !(status & 0x04);
+
+        case 0x18: /* QSFP-DD */
+        case 0x19: /* OSFP */
+        case 0x1E: /* QSFP+ CMIS */
+            /* CMIS: byte 2 bit 7 is MemoryModel (flat) */
+            status = onlp_sfpi_dev_readb(port, 0x50, 2);
+            return (status < 0) ? status : !(status & 0x80);
+
+        case 0x03: /* SFP */
+            /* SFF-8472: only the diagnostic address is paged. */
+            return devaddr == 0x51;
+
+        default:
+            return 0;
+        }
+}
+
+/*
+ * Emulate a partial read using a full 256 byte read.
+ */
+static int
+sfp_eeprom_readv_full__(int port, uint8_t devaddr, int offset, int len, uint8_t* dst)
+{
+    int rv;
+    uint8_t data[256];
+
+    if(devaddr == 0x50) {
+        rv = onlp_sfpi_eeprom_read(port, data);
+    }
+    else if(devaddr == 0x51) {
+        rv = onlp_sfpi_dom_read(port, data);
+    }
+    else {
+        return ONLP_STATUS_E_UNSUPPORTED;
+    }
+
+    if(rv >= 0) {
+        memcpy(dst, data + offset, len);
+        rv = 0;
+    }
+    return rv;
+}
+
+static int
+onlp_sfp_eeprom_readv_locked__(int port, uint8_t devaddr, int page,
+                               int offset, int len, uint8_t* dst)
+{
+    int rv;
+    int select;
+
+    ONLP_SFP_PORT_VALIDATE_AND_MAP(port);
+
+    if(dst == NULL || page < 0 || page > 255 || offset < 0 || len <= 0 ||
+       offset + len > 256) {
+        return ONLP_STATUS_E_PARAM;
+    }
+
+    rv = onlp_sfpi_eeprom_readv(port, devaddr, page, offset, len, dst);
+    if(rv != ONLP_STATUS_E_UNSUPPORTED) {
+        return rv;
+    }
+
+    /* Only reads which reach the upper half depend on the page. */
+    select = (page != 0 && offset + len > SFP_EEPROM_UPPER);
+
+    if(select) {
+        if((rv = sfp_eeprom_paged__(port, devaddr)) <= 0) {
+            return (rv == 0) ? ONLP_STATUS_E_UNSUPPORTED : rv;
+        }
+        if((rv = onlp_sfpi_dev_writeb(port, devaddr, SFP_EEPROM_PAGE_SELECT, page)) < 0) {
+            return rv;
+        }
+    }
+
+    rv = onlp_sfpi_dev_read(port, devaddr, offset, dst, len);
+
+    if(select) {
+        /* Other readers expect page 0. */
+        int wrv = onlp_sfpi_dev_writeb(port, devaddr, SFP_EEPROM_PAGE_SELECT, 0);
+        if(wrv < 0) {
+            AIM_LOG_ERROR("Port %d: could not restore page 0: %{onlp_status}", port, wrv);
+        }
+    }
+    else if(rv == ONLP_STATUS_E_UNSUPPORTED) {
+        return sfp_eeprom_readv_full__(port, devaddr, offset, len, dst);
+    }
+
+    return (rv < 0) ? rv : 0;
+}
+ONLP_LOCKED_PORT_API6(onlp_sfp_eeprom_readv, int, port, uint8_t, devaddr, int, page,
+                      int, offset, int, len, uint8_t*, dst);
+
+/**
+ * These are the control bits reported as the port status.
+ */
+static const onlp_sfp_control_t sfp_control_flags__[] =
+    {
+        ONLP_SFP_CONTROL_RESET_STATE,
+        ONLP_SFP_CONTROL_RX_LOS,
+        ONLP_SFP_CONTROL_TX_FAULT,
+        ONLP_SFP_CONTROL_TX_DISABLE,
+        ONLP_SFP_CONTROL_LP_MODE
+    };
+
+static int
+onlp_sfp_dump_sweep__(int port, void* cookie)
+{
+    uint8_t** idproms = (uint8_t**)cookie;
+    return onlp_sfp_eeprom_read(port, idproms + port);
+}
 
 void
 onlp_sfp_dump(aim_pvs_t* pvs)
 {
     int p;
     int rv;
+    int i;
+    int* results;
+    uint8_t** idproms;
+    int crv[AIM_ARRAYSIZE(sfp_control_flags__)];
+    onlp_sfp_bitmap_t controls[AIM_ARRAYSIZE(sfp_control_flags__)];
 
     if(AIM_BITMAP_COUNT(&sfpi_bitmap__) == 0) {
         aim_printf(pvs, "There are no SFP capable ports.\n");
         return;
     }
 
-    onlp_sfp_bitmap_t bmap;
-    onlp_sfp_bitmap_t_init(&bmap);
-    rv = onlp_sfp_presence_bitmap_get(&bmap);
+    int prv;
+    onlp_sfp_bitmap_t present;
+    onlp_sfp_bitmap_t_init(&present);
+    prv = onlp_sfp_presence_bitmap_get(&present);
     aim_printf(pvs, "  Presence Bitmap: ");
-    if(rv == 0) {
-        aim_printf(pvs, "%{aim_bitmap}\n", &bmap);
+    if(prv == 0) {
+        aim_printf(pvs, "%{aim_bitmap}\n", &present);
     }
     else {
-        aim_printf(pvs,"Error: %{onlp_status}\n", rv);
+        aim_printf(pvs,"Error: %{onlp_status}\n", prv);
     }
+
+    onlp_sfp_bitmap_t bmap;
+    onlp_sfp_bitmap_t_init(&bmap);
     aim_printf(pvs, "  RX_LOS Bitmap: ");
     rv = onlp_sfp_rx_los_bitmap_get(&bmap);
     if(rv == 0) {
@@ -204,41 +397,61 @@ onlp_sfp_dump(aim_pvs_t* pvs)
     }
     aim_printf(pvs, "\n");
 
+    /* Collect the port status for all ports at once. */
+    for(i = 0; i < AIM_ARRAYSIZE(sfp_control_flags__); i++) {
+        onlp_sfp_bitmap_t_init(controls + i);
+        crv[i] = onlp_sfp_control_bitmap_get(sfp_control_flags__[i], controls + i);
+    }
+
+    /* Read the EEPROMs of all present modules, one thread per bus. */
+    results = aim_zmalloc(sizeof(int) * ONLP_SFP_PORT_COUNT_MAX);
+    idproms = aim_zmalloc(sizeof(uint8_t*) * ONLP_SFP_PORT_COUNT_MAX);
+    if(prv == 0) {
+        onlp_sfp_sweep(&present, onlp_sfp_dump_sweep__, idproms, results);
+    }
+
     AIM_BITMAP_ITER(&sfpi_bitmap__, p) {
-        rv = onlp_sfp_is_present(p);
         aim_printf(pvs, "Port %.2d: ", p);
-        if(rv == 0) {
+        if(prv < 0) {
+            /* Error */
+            aim_printf(pvs, "Error: %{onlp_status}\n", prv);
+        }
+        else if(!AIM_BITMAP_GET(&present, p)) {
             /* Missing, OK */
             aim_printf(pvs, "Missing.\n");
         }
-        else if(rv == 1) {
+        else {
             /* Present, OK */
-            int srv;
+            int srv = 0;
             uint32_t flags = 0;
-            srv = onlp_sfp_control_flags_get(p, &flags);
+            for(i = 0; i < AIM_ARRAYSIZE(sfp_control_flags__); i++) {
+                if(crv[i] >= 0) {
+                    if(AIM_BITMAP_GET(controls + i, p)) {
+                        flags |= (1 << sfp_control_flags__[i]);
+                    }
+                }
+                else if(crv[i] != ONLP_STATUS_E_UNSUPPORTED) {
+                    srv = crv[i];
+                }
+            }
             if(srv >= 0) {
                 aim_printf(pvs, "Present, Status = %{onlp_sfp_control_flags}\n", flags);
             }
             else {
                 aim_printf(pvs, "Present, Status Unavailable [ %{onlp_status} ]\n", srv);
             }
-        }
-        else {
-            /* Error */
-            aim_printf(pvs, "Error: %{onlp_status}\n", rv);
-        }
-        if(rv == 1) {
-            uint8_t* idprom = NULL;
-            rv = onlp_sfp_eeprom_read(p, &idprom);
-            if(rv < 0) {
-                aim_printf(pvs, "Error reading eeprom: %{onlp_status}\n");
+
+            if(results[p] < 0) {
+                aim_printf(pvs, "Error reading eeprom: %{onlp_status}\n", results[p]);
             }
             else {
-                aim_printf(pvs, "eeprom:\n%{data}\n", idprom, 256);
-                aim_free(idprom);
+                aim_printf(pvs, "eeprom:\n%{data}\n", idproms[p], 256);
+                aim_free(idproms[p]);
             }
         }
     }
+    aim_free(idproms);
+    aim_free(results);
     return;
 }
 
@@ -248,7 +461,7 @@ onlp_sfp_post_insert_locked__(int port, sff_info_t* info)
     ONLP_SFP_PORT_VALIDATE_AND_MAP(port);
     return onlp_sfpi_post_insert(port, info);
 }
-ONLP_LOCKED_API2(onlp_sfp_post_insert, int, port, sff_info_t*, info);
+ONLP_LOCKED_PORT_API2(onlp_sfp_post_insert, int, port, sff_info_t*, info);
 
 static int
 onlp_sfp_control_set_locked__(int port, onlp_sfp_control_t control, int value)
@@ -280,7 +493,7 @@ onlp_sfp_control_set_locked__(int port, onlp_sfp_control_t control, int value)
         }
     return onlp_sfpi_control_set(port, control, value);
 }
-ONLP_LOCKED_API3(onlp_sfp_control_set, int, port, onlp_sfp_control_t, control,
+ONLP_LOCKED_PORT_API3(onlp_sfp_control_set, int, port, onlp_sfp_control_t, control,
                  int, value);
 
 static int
@@ -311,50 +524,72 @@ onlp_sfp_control_get_locked__(int port, onlp_sfp_control_t control, int* value)
 
     return (value) ? onlp_sfpi_control_get(port, control, value) : ONLP_STATUS_E_PARAM;
 }
-ONLP_LOCKED_API3(onlp_sfp_control_get, int, port, onlp_sfp_control_t, control,
+ONLP_LOCKED_PORT_API3(onlp_sfp_control_get, int, port, onlp_sfp_control_t, control,
                  int*, value);
 
 
 
 static int
-onlp_sfp_rx_los_bitmap_get_locked__(onlp_sfp_bitmap_t* dst)
+onlp_sfp_control_bitmap_get_locked__(onlp_sfp_control_t control, onlp_sfp_bitmap_t* dst)
 {
-    int rv = onlp_sfpi_rx_los_bitmap_get(dst);
+    int p;
+    int rv;
+    onlp_sfp_bitmap_t present;
 
-    if(rv == ONLP_STATUS_E_UNSUPPORTED) {
-        /* Generate from control API */
-        int p;
-        AIM_BITMAP_CLR_ALL(dst);
-        AIM_BITMAP_ITER(&sfpi_bitmap__, p) {
-            int v;
-            rv = onlp_sfp_control_get_locked__(p, ONLP_SFP_CONTROL_RX_LOS, &v);
-            if(rv < 0) {
-                return rv;
-            }
-            if(v) {
-                AIM_BITMAP_SET(dst, p);
-            }
-        }
+    if(!ONLP_SFP_CONTROL_VALID(control) || control == ONLP_SFP_CONTROL_RESET) {
+        return ONLP_STATUS_E_PARAM;
+    }
+
+    AIM_BITMAP_CLR_ALL(dst);
+    rv = onlp_sfpi_control_bitmap_get(control, dst);
+    if(rv == ONLP_STATUS_E_UNSUPPORTED && control == ONLP_SFP_CONTROL_RX_LOS) {
+        rv = onlp_sfpi_rx_los_bitmap_get(dst);
+    }
+    if(rv != ONLP_STATUS_E_UNSUPPORTED) {
+        return rv;
     }
 
+    /* Generate from control API on the present ports */
+    if((rv = onlp_sfp_presence_bitmap_get_locked__(&present)) < 0) {
+        return rv;
+    }
+    rv = ONLP_STATUS_E_UNSUPPORTED;
+    AIM_BITMAP_CLR_ALL(dst);
+    AIM_BITMAP_ITER(&sfpi_bitmap__, p) {
+        int v;
+        int prv;
+        if(AIM_BITMAP_GET(&present, p) == 0) {
+            continue;
+        }
+        prv = onlp_sfp_control_get_locked__(p, control, &v);
+        if(prv == ONLP_STATUS_E_UNSUPPORTED) {
+            continue;
+        }
+        if(prv < 0) {
+            return prv;
+        }
+        rv = 0;
+        if(v) {
+            AIM_BITMAP_SET(dst, p);
+        }
+    }
     return rv;
 }
+ONLP_LOCKED_API2(onlp_sfp_control_bitmap_get, onlp_sfp_control_t, control,
+                 onlp_sfp_bitmap_t*, dst);
+
+static int
+onlp_sfp_rx_los_bitmap_get_locked__(onlp_sfp_bitmap_t* dst)
+{
+    return onlp_sfp_control_bitmap_get_locked__(ONLP_SFP_CONTROL_RX_LOS, dst);
+}
 ONLP_LOCKED_API1(onlp_sfp_rx_los_bitmap_get, onlp_sfp_bitmap_t*, dst);
 
 
 int
 onlp_sfp_control_flags_get(int port, uint32_t* flags)
 {
-    /**
-     * These are the control bits queried and returned.
-     */
-    onlp_sfp_control_t controls[] =
-        {
-            ONLP_SFP_CONTROL_RESET_STATE,
-            ONLP_SFP_CONTROL_RX_LOS,
-            ONLP_SFP_CONTROL_TX_DISABLE,
-            ONLP_SFP_CONTROL_LP_MODE
-        };
+    const onlp_sfp_control_t* controls = sfp_control_flags__;
 
     if(flags) {
         *flags = 0;
@@ -365,7 +600,7 @@ onlp_sfp_control_flags_get(int port, uint32_t* flags)
 
     int rv, i, v;
 
-    for(i = 0; i < AIM_ARRAYSIZE(controls); i++) {
+    for(i = 0; i < AIM_ARRAYSIZE(sfp_control_flags__); i++) {
         rv = onlp_sfp_control_get(port, controls[i], &v);
         if(rv >= 0) {
             if(v) {
@@ -397,7 +632,7 @@ onlp_sfp_vioctl_locked__(int port, va_list vargs)
 {
     return onlp_sfpi_ioctl(port, vargs);
 };
-ONLP_LOCKED_API2(onlp_sfp_vioctl, int, port, va_list, vargs);
+ONLP_LOCKED_PORT_API2(onlp_sfp_vioctl, int, port, va_list, vargs);
 
 
 int
@@ -406,7 +641,7 @@ onlp_sfp_dev_readb_locked__(int port, uint8_t devaddr, uint8_t addr)
     ONLP_SFP_PORT_VALIDATE_AND_MAP(port);
     return onlp_sfpi_dev_readb(port, devaddr, addr);
 }
-ONLP_LOCKED_API3(onlp_sfp_dev_readb, int, port, uint8_t, devaddr, uint8_t, addr);
+ONLP_LOCKED_PORT_API3(onlp_sfp_dev_readb, int, port, uint8_t, devaddr, uint8_t, addr);
 
 int
 onlp_sfp_dev_writeb_locked__(int port, uint8_t devaddr, uint8_t addr, uint8_t value)
@@ -414,7 +649,7 @@ onlp_sfp_dev_writeb_locked__(int port, uint8_t devaddr, uint8_t addr, uint8_t va
     ONLP_SFP_PORT_VALIDATE_AND_MAP(port);
     return onlp_sfpi_dev_writeb(port, devaddr, addr, value);
 }
-ONLP_LOCKED_API4(onlp_sfp_dev_writeb, int, port, uint8_t, devaddr, uint8_t, addr, uint8_t, value);
+ONLP_LOCKED_PORT_API4(onlp_sfp_dev_writeb, int, port, uint8_t, devaddr, uint8_t, addr, uint8_t, value);
 
 int
 onlp_sfp_dev_readw_locked__(int port, uint8_t devaddr, uint8_t addr)
@@ -422,7 +657,7 @@ onlp_sfp_dev_readw_locked__(int port, uint8_t devaddr, uint8_t addr)
     ONLP_SFP_PORT_VALIDATE_AND_MAP(port);
     return onlp_sfpi_dev_readw(port, devaddr, addr);
 }
-ONLP_LOCKED_API3(onlp_sfp_dev_readw, int, port, uint8_t, devaddr, uint8_t, addr);
+ONLP_LOCKED_PORT_API3(onlp_sfp_dev_readw, int, port, uint8_t, devaddr, uint8_t, addr);
 
 int
 onlp_sfp_dev_writew_locked__(int port, uint8_t devaddr, uint8_t addr, uint16_t value)
@@ -430,7 +665,7 @@ onlp_sfp_dev_writew_locked__(int port, uint8_t devaddr, uint8_t addr, uint16_t v
     ONLP_SFP_PORT_VALIDATE_AND_MAP(port);
     return onlp_sfpi_dev_writew(port, devaddr, addr, value);
 }
-ONLP_LOCKED_API4(onlp_sfp_dev_writew, int, port, uint8_t, devaddr, uint8_t, addr, uint16_t, value);
+ONLP_LOCKED_PORT_API4(onlp_sfp_dev_writew, int, port, uint8_t, devaddr, uint8_t, addr, uint16_t, value);
 
 int
 onlp_sfp_dev_read_locked__(int port, uint8_t devaddr, uint8_t addr, uint8_t* rdata, int size)
@@ -438,7 +673,7 @@ onlp_sfp_dev_read_locked__(int port, uint8_t devaddr, uint8_t addr, uint8_t* rda
     ONLP_SFP_PORT_VALIDATE_AND_MAP(port);
     return onlp_sfpi_dev_read(port, devaddr, addr, rdata, size);
 }
-ONLP_LOCKED_API5(onlp_sfp_dev_read, int, port, uint8_t, devaddr, uint8_t, addr, uint8_t*, rdata, int, size);
+ONLP_LOCKED_PORT_API5(onlp_sfp_dev_read, int, port, uint8_t, devaddr, uint8_t, addr, uint8_t*, rdata, int, size);
 
 int
 onlp_sfp_dev_write_locked__(int port, uint8_t devaddr, uint8_t addr, uint8_t* data, int size)
@@ -446,4 +681,4 @@ onlp_sfp_dev_write_locked__(int port, uint8_t devaddr, uint8_t addr, uint8_t* da
     ONLP_SFP_PORT_VALIDATE_AND_MAP(port);
     return onlp_sfpi_dev_write(port, devaddr, addr, data, size);
 }
-ONLP_LOCKED_API5(onlp_sfp_dev_write, int, port, uint8_t, devaddr, uint8_t, addr, uint8_t*, data, int, size);
+ONLP_LOCKED_PORT_API5(onlp_sfp_dev_write, int, port, uint8_t, devaddr, uint8_t, addr, uint8_t*, data, int, size);
@@ -0,0 +1,696 @@
+/************************************************************
+ * <bsn.cl fy=2014 v=onl>
+ *
+ *        Copyright 2014, 2015 Big Switch Networks, Inc.
+ *
+ * Licensed under the Eclipse Public License, Version 1.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ *        http://www.eclipse.org/legal/epl-v10.html
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the
+ * License.
+ *
+ * </bsn.cl>
+ ************************************************************
+ *
+ * SFP DOM Monitor.
+ *
+ * Each polling period the monitor reads the presence bitmap,
+ * retires the records of removed modules, and then refreshes
+ * the ports whose records are older than the refresh interval,
+ * starting where the previous period stopped, until the byte
+ * budget for the period is spent. A refresh which finds a
+ * different serial number handles the port as a removal and
+ * a new insertion.
+ *
+ * Records are allocated on first insertion and reused for the
+ * life of the process.
+ *
+ ***********************************************************/
+#include <onlp/onlp_config.h>
+#include <onlp/onlp.h>
+#include <onlp/sfp.h>
+#include <onlp/sfp_dom.h>
+#include <onlp/sys.h>
+#include "onlp_log.h"
+
+#if ONLP_CONFIG_INCLUDE_SFP_DOM_MONITOR == 1
+
+#include <AIM/aim_time.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <string.h>
+
+#define DOM_PORTS_MAX 256
+#define DOM_SN_LEN 16
+
+typedef struct dom_port_s {
+    int present;
+    /* Vendor serial number of the module the record belongs to. */
+    uint8_t sn[DOM_SN_LEN];
+    onlp_sfp_dom_t dom;
+} dom_port_t;
+
+typedef struct dom_subscriber_s {
+    uint32_t events;
+    onlp_sfp_dom_handler_f handler;
+    void* cookie;
+} dom_subscriber_t;
+
+typedef struct dom_ctrl_s {
+    /* Protects the records and subscribers. */
+    pthread_mutex_t lock;
+    /* Serializes pollers. */
+    pthread_mutex_t poll_lock;
+
+    dom_port_t* ports[DOM_PORTS_MAX];
+    /* The next port to consider for refresh. */
+    int cursor;
+
+    dom_subscriber_t subscribers[ONLP_CONFIG_SFP_DOM_MONITOR_SUBSCRIBERS_MAX];
+} dom_ctrl_t;
+
+static dom_ctrl_t dom__ = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER };
+
+/*
+ * Where the live values and thresholds are found for each
+ * management interface. Value offsets are relative to the
+ * start of their read.
+ */
+typedef struct dom_layout_s {
+    /* Live values */
+    uint8_t devaddr;
+    int offset;
+    int len;
+    int temp;
+    int vcc;
+    /* Per-lane values. Relative to the lane read if there is one. */
+    int bias;
+    int tx_power;
+    int rx_power;
+
+    /* Per-lane values in a separate page (CMIS). Negative page if none. */
+    int lane_page;
+    int lane_offset;
+    int lane_len;
+
+    /* Thresholds */
+    uint8_t th_devaddr;
+    int th_page;
+    int th_offset;
+    int th_len;
+    int th[ONLP_SFP_DOM_VALUE_COUNT];
+
+    /* Vendor serial number (0x50, page 0) */
+    int sn_offset;
+} dom_layout_t;
+
+static const dom_layout_t dom_layout_sff8472__ = {
+    0x51, 96, 10, 0, 2, 4, 6, 8,
+    -1, 0, 0,
+    0x51, 0, 0, 40, { 0, 8, 16, 24, 32 },
+    68,
+};
+
+static const dom_layout_t dom_layout_sff8636__ = {
+    0x50, 22, 36, 0, 4, 20, 28, 12,
+    -1, 0, 0,
+    0x50, 3, 128, 72, { 0, 16, 56, 64, 48 },
+    196,
+};
+
+static const dom_layout_t dom_layout_cmis__ = {
+    0x50, 14, 4, 0, 2, 16, 0, 32,
+    0x11, 154, 48,
+    0x50, 2, 128, 72, { 0, 8, 56, 48, 64 },
+    166,
+};
+
+static const dom_layout_t*
+dom_layout__(onlp_sfp_dom_type_t type)
+{
+    switch(type)
+        {
+        case ONLP_SFP_DOM_TYPE_SFF8472: return &dom_layout_sff8472__;
+        case ONLP_SFP_DOM_TYPE_SFF8636: return &dom_layout_sff8636__;
+        case ONLP_SFP_DOM_TYPE_CMIS: return &dom_layout_cmis__;
+        default: return NULL;
+        }
+}
+
+static int
+dom_read__(int port, uint8_t devaddr, int page, int offset, int len,
+           uint8_t* dst, int* budget)
+{
+    *budget -= len;
+    return onlp_sfp_eeprom_readv(port, devaddr, page, offset, len, dst);
+}
+
+static uint16_t
+dom_u16__(const uint8_t* data)
+{
+    return (data[0] << 8) | data[1];
+}
+
+/*
+ * Convert a raw 16 bit value to the record units.
+ */
+static int32_t
+dom_convert__(onlp_sfp_dom_value_t value, const uint8_t* data)
+{
+    uint16_t raw = dom_u16__(data);
+
+    switch(value)
+        {
+        case ONLP_SFP_DOM_VALUE_TEMP: return ((int16_t)raw * 1000) / 256;
+        case ONLP_SFP_DOM_VALUE_VCC: return raw * 100;
+        case ONLP_SFP_DOM_VALUE_BIAS: return raw * 2;
+        default: return raw;
+        }
+}
+
+/*
+ * Identify the module's management interface.
+ */
+static int
+dom_identify__(int port, onlp_sfp_dom_t* dom, int* paged, int* budget)
+{
+    int rv;
+    uint8_t id[3];
+    uint8_t diag;
+
+    memset(dom, 0, sizeof(*dom));
+    *paged = 0;
+
+    if((rv = dom_read__(port, 0x50, 0, 0, sizeof(id), id, budget)) < 0) {
+        return rv;
+    }
+
+    switch(id[0])
+        {
+        case 0x03: /* SFP */
+            /* Byte 92 bit 6: Digital diagnostic monitoring implemented */
+            if((rv = dom_read__(port, 0x50, 0, 92, 1, &diag, budget)) < 0) {
+                return rv;
+            }
+            if(diag & 0x40) {
+                dom->type = ONLP_SFP_DOM_TYPE_SFF8472;
+                dom->lanes = 1;
+                *paged = 1;
+            }
+            break;
+
+        case 0x0C: /* QSFP */
+        case 0x0D: /* QSFP+ */
+        case 0x11: /* QSFP28 */
+            dom->type = ONLP_SFP_DOM_TYPE_SFF8636;
+            dom->lanes = 4;
+            *paged = !(id[2] & 0x04);
+            break;
+
+        case 0x18: /* QSFP-DD */
+        case 0x19: /* OSFP */
+        case 0x1E: /* QSFP+ CMIS */
+            dom->type = ONLP_SFP_DOM_TYPE_CMIS;
+            *paged = !(id[2] & 0x80);
+            /* Lane monitors are only available on paged modules. */
+            if(!*paged) {
+                dom->lanes = 0;
+            }
+            else if(id[0] == 0x1E) {
+                dom->lanes = 4;
+            }
+            else {
+                /* Byte 88: media lane count of the default application */
+                if((rv = dom_read__(port, 0x50, 0, 88, 1, &diag, budget)) < 0) {
+                    return rv;
+                }
+                dom->lanes = diag & 0x0F;
+                if(dom->lanes == 0 || dom->lanes > ONLP_SFP_DOM_LANES_MAX) {
+                    dom->lanes = ONLP_SFP_DOM_LANES_MAX;
+                }
+            }
+            break;
+
+        default:
+            break;
+        }
+    return 0;
+}
+
+/*
+ * The serial number identifies a module which was replaced
+ * between two polls.
+ */
+static int
+dom_sn_read__(int port, const onlp_sfp_dom_t* dom, uint8_t* sn, int* budget)
+{
+    const dom_layout_t* layout = dom_layout__(dom->type);
+
+    memset(sn, 0, DOM_SN_LEN);
+    if(layout == NULL) {
+        return 0;
+    }
+    return dom_read__(port, 0x50, 0, layout->sn_offset, DOM_SN_LEN, sn, budget);
+}
+
+/*
+ * Thresholds are static and only read on insertion.
+ */
+static int
+dom_thresholds_read__(int port, onlp_sfp_dom_t* dom, int paged, int* budget)
+{
+    int rv, v, l;
+    uint8_t data[72];
+    const dom_layout_t* layout = dom_layout__(dom->type);
+
+    if(layout == NULL || (layout->th_page && !paged)) {
+        return 0;
+    }
+
+    if((rv = dom_read__(port, layout->th_devaddr, layout->th_page,
+                        layout->th_offset, layout->th_len, data, budget)) < 0) {
+        return rv;
+    }
+
+    for(v = 0; v < ONLP_SFP_DOM_VALUE_COUNT; v++) {
+        for(l = 0; l < ONLP_SFP_DOM_LEVEL_COUNT; l++) {
+            dom->thresholds[v][l] = dom_convert__(v, data + layout->th[v] + l*2);
+        }
+    }
+    return 0;
+}
+
+static void
+dom_lanes_parse__(onlp_sfp_dom_t* dom, const dom_layout_t* layout,
+                  const uint8_t* data)
+{
+    int l;
+    for(l = 0; l < dom->lanes; l++) {
+        dom->bias[l] = dom_convert__(ONLP_SFP_DOM_VALUE_BIAS, data + layout->bias + l*2);
+        dom->tx_power[l] = dom_convert__(ONLP_SFP_DOM_VALUE_TX_POWER, data + layout->tx_power + l*2);
+        dom->rx_power[l] = dom_convert__(ONLP_SFP_DOM_VALUE_RX_POWER, data + layout->rx_power + l*2);
+    }
+}
+
+static int
+dom_values_read__(int port, onlp_sfp_dom_t* dom, int* budget)
+{
+    int rv;
+    uint8_t data[48];
+    const dom_layout_t* layout = dom_layout__(dom->type);
+
+    if(layout == NULL) {
+        return 0;
+    }
+
+    if((rv = dom_read__(port, layout->devaddr, 0, layout->offset, layout->len,
+                        data, budget)) < 0) {
+        return rv;
+    }
+    dom->temp = dom_convert__(ONLP_SFP_DOM_VALUE_TEMP, data + layout->temp);
+    dom->vcc = dom_convert__(ONLP_SFP_DOM_VALUE_VCC, data + layout->vcc);
+
+    if(layout->lane_page < 0) {
+        dom_lanes_parse__(dom, layout, data);
+    }
+    else if(dom->lanes) {
+        if((rv = dom_read__(port, layout->devaddr, layout->lane_page,
+                            layout->lane_offset, layout->lane_len,
+                            data, budget)) < 0) {
+            return rv;
+        }
+        dom_lanes_parse__(dom, layout, data);
+    }
+    return 0;
+}
+
+static uint32_t
+dom_value_flags__(const onlp_sfp_dom_t* dom, onlp_sfp_dom_value_t v, int32_t value)
+{
+    uint32_t flags = 0;
+    const int32_t* th = dom->thresholds[v];
+
+    /* All zero means the thresholds are unavailable. */
+    if(!th[0] && !th[1] && !th[2] && !th[3]) {
+        return 0;
+    }
+    if(value > th[ONLP_SFP_DOM_LEVEL_HIGH_ALARM]) {
+        flags |= ONLP_SFP_DOM_FLAG(v, ONLP_SFP_DOM_LEVEL_HIGH_ALARM);
+    }
+    if(value < th[ONLP_SFP_DOM_LEVEL_LOW_ALARM]) {
+        flags |= ONLP_SFP_DOM_FLAG(v, ONLP_SFP_DOM_LEVEL_LOW_ALARM);
+    }
+    if(value > th[ONLP_SFP_DOM_LEVEL_HIGH_WARNING]) {
+        flags |= ONLP_SFP_DOM_FLAG(v, ONLP_SFP_DOM_LEVEL_HIGH_WARNING);
+    }
+    if(value < th[ONLP_SFP_DOM_LEVEL_LOW_WARNING]) {
+        flags |= ONLP_SFP_DOM_FLAG(v, ONLP_SFP_DOM_LEVEL_LOW_WARNING);
+    }
+    return flags;
+}
+
+static uint32_t
+dom_flags__(const onlp_sfp_dom_t* dom)
+{
+    int l;
+    uint32_t flags = 0;
+
+    flags |= dom_value_flags__(dom, ONLP_SFP_DOM_VALUE_TEMP, dom->temp);
+    flags |= dom_value_flags__(dom, ONLP_SFP_DOM_VALUE_VCC, dom->vcc);
+    for(l = 0; l < dom->lanes; l++) {
+        flags |= dom_value_flags__(dom, ONLP_SFP_DOM_VALUE_BIAS, dom->bias[l]);
+        flags |= dom_value_flags__(dom, ONLP_SFP_DOM_VALUE_TX_POWER, dom->tx_power[l]);
+        flags |= dom_value_flags__(dom, ONLP_SFP_DOM_VALUE_RX_POWER, dom->rx_power[l]);
+    }
+    return flags;
+}
+
+static int
+dom_values_equal__(const onlp_sfp_dom_t* a, const onlp_sfp_dom_t* b)
+{
+    return a->temp == b->temp && a->vcc == b->vcc &&
+        !memcmp(a->bias, b->bias, sizeof(a->bias)) &&
+        !memcmp(a->tx_power, b->tx_power, sizeof(a->tx_power)) &&
+        !memcmp(a->rx_power, b->rx_power, sizeof(a->rx_power));
+}
+
+static void
+dom_dispatch__(int port, uint32_t events, const onlp_sfp_dom_t* dom, uint32_t flags)
+{
+    int i;
+    dom_subscriber_t subscribers[ONLP_CONFIG_SFP_DOM_MONITOR_SUBSCRIBERS_MAX];
+
+    if(events == 0) {
+        return;
+    }
+
+    /* Handlers may (un)subscribe. */
+    pthread_mutex_lock(&dom__.lock);
+    memcpy(subscribers, dom__.subscribers, sizeof(subscribers));
+    pthread_mutex_unlock(&dom__.lock);
+
+    for(i = 0; i < AIM_ARRAYSIZE(subscribers); i++) {
+        if(subscribers[i].handler && (subscribers[i].events & events)) {
+            subscribers[i].handler(subscribers[i].cookie, port,
+                                   subscribers[i].events & events, dom, flags);
+        }
+    }
+}
+
+/*
+ * Refresh one port. Returns > 0 if it changed.
+ */
+static int
+dom_port_refresh__(int port, uint64_t now, int* budget)
+{
+    int rv;
+    int paged;
+    uint32_t events = 0;
+    uint32_t flags = 0;
+    onlp_sfp_dom_t dom;
+    uint8_t sn[DOM_SN_LEN];
+    dom_port_t* dp = dom__.ports[port];
+    int insert = (dp == NULL || !dp->present);
+
+    if(!insert) {
+        pthread_mutex_lock(&dom__.lock);
+        dom = dp->dom;
+        pthread_mutex_unlock(&dom__.lock);
+
+        if((rv = dom_sn_read__(port, &dom, sn, budget)) < 0) {
+            return rv;
+        }
+        if(memcmp(sn, dp->sn, sizeof(sn))) {
+            /* Replaced while present. Retire the old module's record. */
+            pthread_mutex_lock(&dom__.lock);
+            dp->present = 0;
+            pthread_mutex_unlock(&dom__.lock);
+            dom_dispatch__(port, ONLP_SFP_DOM_EVENT_REMOVE, &dom, dom.flags);
+            insert = 1;
+        }
+    }
+
+    if(insert) {
+        if((rv = dom_identify__(port, &dom, &paged, budget)) < 0 ||
+           (rv = dom_thresholds_read__(port, &dom, paged, budget)) < 0 ||
+           (rv = dom_sn_read__(port, &dom, sn, budget)) < 0) {
+            return rv;
+        }
+    }
+
+    if((rv = dom_values_read__(port, &dom, budget)) < 0) {
+        /* The record is left as is and retried next period. */
+        return rv;
+    }
+    dom.flags = dom_flags__(&dom);
+    dom.updated = now;
+    dom.seq++;
+
+    pthread_mutex_lock(&dom__.lock);
+    if(dp == NULL) {
+        dp = dom__.ports[port] = aim_zmalloc(sizeof(*dp));
+    }
+    if(insert) {
+        events |= ONLP_SFP_DOM_EVENT_INSERT;
+        if(dom.flags) {
+            events |= ONLP_SFP_DOM_EVENT_THRESHOLD;
+        }
+    }
+    else {
+        if(!dom_values_equal__(&dom, &dp->dom)) {
+            events |= ONLP_SFP_DOM_EVENT_CHANGE;
+        }
+        if(dom.flags != dp->dom.flags) {
+            events |= ONLP_SFP_DOM_EVENT_THRESHOLD;
+        }
+        flags = dp->dom.flags;
+    }
+    dp->dom = dom;
+    memcpy(dp->sn, sn, sizeof(sn));
+    dp->present = 1;
+    pthread_mutex_unlock(&dom__.lock);
+
+    dom_dispatch__(port, events, &dom, flags);
+    return events != 0;
+}
+
+int
+onlp_sfp_dom_monitor_poll(void)
+{
+    int i, rv;
+    int changed = 0;
+    uint64_t now;
+    onlp_sfp_bitmap_t valid;
+    onlp_sfp_bitmap_t present;
+    int budget = ONLP_CONFIG_SFP_DOM_MONITOR_BUDGET;
+
+    pthread_mutex_lock(&dom__.poll_lock);
+
+    onlp_sfp_bitmap_t_init(&valid);
+    onlp_sfp_bitmap_t_init(&present);
+    if((rv = onlp_sfp_bitmap_get(&valid)) < 0 ||
+       (rv = onlp_sfp_presence_bitmap_get(&present)) < 0) {
+        pthread_mutex_unlock(&dom__.poll_lock);
+        return rv;
+    }
+
+    /* Removals */
+    for(i = 0; i < DOM_PORTS_MAX; i++) {
+        dom_port_t* dp = dom__.ports[i];
+        if(dp && dp->present && !AIM_BITMAP_GET(&present, i)) {
+            onlp_sfp_dom_t dom;
+            pthread_mutex_lock(&dom__.lock);
+            dp->present = 0;
+            dom = dp->dom;
+            pthread_mutex_unlock(&dom__.lock);
+            dom_dispatch__(i, ONLP_SFP_DOM_EVENT_REMOVE, &dom, dom.flags);
+            changed = 1;
+        }
+    }
+
+    /* Refresh round-robin until the budget is spent. */
+    now = aim_time_monotonic();
+    for(i = 0; i < DOM_PORTS_MAX && budget > 0; i++) {
+        int port = (dom__.cursor + i) % DOM_PORTS_MAX;
+        dom_port_t* dp = dom__.ports[port];
+
+        if(!AIM_BITMAP_GET(&valid, port) || !AIM_BITMAP_GET(&present, port)) {
+            continue;
+        }
+        if(dp && dp->present &&
+           now - dp->dom.updated < ONLP_CONFIG_SFP_DOM_MONITOR_INTERVAL) {
+            continue;
+        }
+
+        rv = dom_port_refresh__(port, now, &budget);
+        if(rv < 0) {
+            AIM_LOG_VERBOSE("Port %d: DOM refresh failed: %{onlp_status}", port, rv);
+        }
+        else if(rv > 0) {
+            changed = 1;
+        }
+        dom__.cursor = (port + 1) % DOM_PORTS_MAX;
+    }
+
+    pthread_mutex_unlock(&dom__.poll_lock);
+    return changed;
+}
+
+int
+onlp_sfp_dom_monitor_start(void)
+{
+    return onlp_sys_platform_manage_register("sfp-dom", onlp_sfp_dom_monitor_poll,
+                                             ONLP_CONFIG_SFP_DOM_MONITOR_RATE);
+}
+
+int
+onlp_sfp_dom_monitor_stop(void)
+{
+    return onlp_sys_platform_manage_unregister("sfp-dom");
+}
+
+int
+onlp_sfp_dom_get(int port, onlp_sfp_dom_t* dom)
+{
+    int rv = ONLP_STATUS_E_MISSING;
+
+    if(port < 0 || port >= DOM_PORTS_MAX || dom == NULL) {
+        return ONLP_STATUS_E_PARAM;
+    }
+
+    pthread_mutex_lock(&dom__.lock);
+    if(dom__.ports[port] && dom__.ports[port]->present) {
+        *dom = dom__.ports[port]->dom;
+        rv = ONLP_STATUS_OK;
+    }
+    pthread_mutex_unlock(&dom__.lock);
+    return rv;
+}
+
+int
+onlp_sfp_dom_subscribe(uint32_t events, onlp_sfp_dom_handler_f handler,
+                       void* cookie)
+{
+    int i;
+    int rv = ONLP_STATUS_E_INTERNAL;
+
+    if(handler == NULL) {
+        return ONLP_STATUS_E_PARAM;
+    }
+
+    pthread_mutex_lock(&dom__.lock);
+    for(i = 0; i < AIM_ARRAYSIZE(dom__.subscribers); i++) {
+        if(dom__.subscribers[i].handler == NULL) {
+            dom__.subscribers[i].events = events;
+            dom__.subscribers[i].handler = handler;
+            dom__.subscribers[i].cookie = cookie;
+            rv = ONLP_STATUS_OK;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&dom__.lock);
+    return rv;
+}
+
+int
+onlp_sfp_dom_unsubscribe(onlp_sfp_dom_handler_f handler, void* cookie)
+{
+    int i;
+    int rv = ONLP_STATUS_E_MISSING;
+
+    pthread_mutex_lock(&dom__.lock);
+    for(i = 0; i < AIM_ARRAYSIZE(dom__.subscribers); i++) {
+        if(dom__.subscribers[i].handler == handler &&
+           dom__.subscribers[i].cookie == cookie) {
+            memset(dom__.subscribers + i, 0, sizeof(dom__.subscribers[i]));
+            rv = ONLP_STATUS_OK;
+        }
+    }
+    pthread_mutex_unlock(&dom__.lock);
+    return rv;
+}
+
+void
+onlp_sfp_dom_show(aim_pvs_t* pvs)
+{
+    int p, l;
+    uint64_t now = aim_time_monotonic();
+
+    aim_printf(pvs, "%-6s %-8s %10s %10s %10s %10s %8s\n",
+               "port", "type", "temp(mC)", "vcc(uV)", "flags", "age(ms)", "seq");
+    pthread_mutex_lock(&dom__.lock);
+    for(p = 0; p < DOM_PORTS_MAX; p++) {
+        dom_port_t* dp = dom__.ports[p];
+        if(dp == NULL || !dp->present) {
+            continue;
+        }
+        aim_printf(pvs, "%-6d %-8s %10d %10d 0x%08x %10"PRIu64" %8u\n",
+                   p,
+                   dp->dom.type == ONLP_SFP_DOM_TYPE_SFF8472 ? "sff8472" :
+                   dp->dom.type == ONLP_SFP_DOM_TYPE_SFF8636 ? "sff8636" :
+                   dp->dom.type == ONLP_SFP_DOM_TYPE_CMIS ? "cmis" : "none",
+                   dp->dom.temp, dp->dom.vcc, dp->dom.flags,
+                   (now - dp->dom.updated) / 1000, dp->dom.seq);
+        for(l = 0; l < dp->dom.lanes; l++) {
+            aim_printf(pvs, "    lane %d: bias %d uA, tx %d.%d uW, rx %d.%d uW\n", l,
+                       dp->dom.bias[l],
+                       dp->dom.tx_power[l] / 10, dp->dom.tx_power[l] % 10,
+                       dp->dom.rx_power[l] / 10, dp->dom.rx_power[l] % 10);
+        }
+    }
+    pthread_mutex_unlock(&dom__.lock);
+}
+
+#else
+
+int
+onlp_sfp_dom_monitor_start(void)
+{
+    return ONLP_STATUS_E_UNSUPPORTED;
+}
+
+int
+onlp_sfp_dom_monitor_stop(void)
+{
+    return ONLP_STATUS_E_UNSUPPORTED;
+}
+
+int
+onlp_sfp_dom_monitor_poll(void)
+{
+    return ONLP_STATUS_E_UNSUPPORTED;
+}
+
+int
+onlp_sfp_dom_get(int port, onlp_sfp_dom_t* dom)
+{
+    return ONLP_STATUS_E_UNSUPPORTED;
+}
+
+int
+onlp_sfp_dom_subscribe(uint32_t events, onlp_sfp_dom_handler_f handler,
+                       void* cookie)
+{
+    return ONLP_STATUS_E_UNSUPPORTED;
+}
+
+int
+onlp_sfp_dom_unsubscribe(onlp_sfp_dom_handler_f handler, void* cookie)
+{
+    return ONLP_STATUS_E_UNSUPPORTED;
+}
+
+void
+onlp_sfp_dom_show(aim_pvs_t* pvs)
+{
+    aim_printf(pvs, "The DOM monitor is not available in this build.\n");
+}
+
+#endif /* ONLP_CONFIG_INCLUDE_SFP_DOM_MONITOR */
@@ -0,0 +1,438 @@
+/************************************************************
+ * <bsn.cl fy=2014 v=onl>
+ *
+ *        Copyright 2014, 2015 Big Switch Networks, Inc.
+ *
+ * Licensed under the Eclipse Public License, Version 1.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ *        http://www.eclipse.org/legal/epl-v10.html
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the
+ * License.
+ *
+ * </bsn.cl>
+ ************************************************************
+ *
+ * SFP inventory cache.
+ *
+ * The raw EEPROM of every present module is kept in shared
+ * memory so all ONLP clients share one copy. Parsed entries
+ * contain pointers and are therefore kept per process, and
+ * reparsed when the shared entry's generation changes.
+ *
+ ***********************************************************/
+#include <onlp/onlp_config.h>
+#include <onlp/onlp.h>
+#include <onlp/sfp.h>
+#include "onlp_log.h"
+
+#if ONLP_CONFIG_INCLUDE_SFP_INVENTORY == 1
+
+#include <onlplib/shlocks.h>
+#include <AIM/aim_time.h>
+#include <pthread.h>
+#include <string.h>
+
+#define ONLP_SFP_INVENTORY_KEY      0xF00DF500
+#define ONLP_SFP_INVENTORY_LOCK_KEY 0xF00DF501
+#define ONLP_SFP_INVENTORY_MAGIC    0x494E5631
+
+#define INVENTORY_PORTS_MAX 256
+
+typedef struct inventory_entry_s {
+    /* Incremented whenever the entry changes. */
+    uint32_t gen;
+    /* 0 if data is valid, otherwise ONLP_STATUS_E_MISSING or the read error. */
+    int status;
+    /* The last EEPROM read or verification (monotonic usecs). */
+    uint64_t verified;
+    uint8_t data[256];
+} inventory_entry_t;
+
+typedef struct inventory_s {
+    uint32_t magic;
+    uint32_t size;
+    inventory_entry_t entries[INVENTORY_PORTS_MAX];
+} inventory_t;
+
+typedef struct inventory_parsed_s {
+    int valid;
+    uint32_t gen;
+    sff_eeprom_t sff;
+} inventory_parsed_t;
+
+static inventory_t* inventory__ = NULL;
+static onlp_shlock_t* inventory_lock__ = NULL;
+static pthread_once_t inventory_once__ = PTHREAD_ONCE_INIT;
+
+/* Per-process parsed entries. */
+static pthread_mutex_t parsed_lock__ = PTHREAD_MUTEX_INITIALIZER;
+static inventory_parsed_t* parsed__ = NULL;
+
+static void
+inventory_init__(void)
+{
+    int i;
+    inventory_t* inv = NULL;
+
+    if(onlp_shlock_create(ONLP_SFP_INVENTORY_LOCK_KEY, &inventory_lock__,
+                          "onlp-sfp-inventory-lock") < 0) {
+        return;
+    }
+    if(onlp_shmem_create(ONLP_SFP_INVENTORY_KEY, sizeof(*inv), (void**)&inv) < 0) {
+        AIM_LOG_ERROR("Could not create the SFP inventory.");
+        return;
+    }
+
+    onlp_shlock_take(inventory_lock__);
+    if(inv->magic != ONLP_SFP_INVENTORY_MAGIC || inv->size != sizeof(*inv)) {
+        memset(inv, 0, sizeof(*inv));
+        for(i = 0; i < INVENTORY_PORTS_MAX; i++) {
+            inv->entries[i].status = ONLP_STATUS_E_MISSING;
+        }
+        inv->size = sizeof(*inv);
+        inv->magic = ONLP_SFP_INVENTORY_MAGIC;
+    }
+    onlp_shlock_give(inventory_lock__);
+
+    parsed__ = aim_zmalloc(sizeof(*parsed__) * INVENTORY_PORTS_MAX);
+    inventory__ = inv;
+}
+
+static inventory_t*
+inventory_get__(void)
+{
+    pthread_once(&inventory_once__, inventory_init__);
+    return inventory__;
+}
+
+/*
+ * The EEPROM range which identifies the module, or -1 if unknown.
+ * Each range spans the base ID checksum (CC_BASE), the vendor
+ * serial number and, where defined, the extended ID checksum
+ * (CC_EXT), so a swap is detected even if the checksums collide.
+ */
+static int
+inventory_key_range__(const uint8_t* data, int* len)
+{
+    switch(data[0])
+        {
+        case 0x03: /* SFP: CC_BASE 63, serial 68-83, CC_EXT 95 */
+            *len = 95 - 63 + 1;
+            return 63;
+        case 0x0C: /* QSFP */
+        case 0x0D: /* QSFP+ */
+        case 0x11: /* QSFP28: CC_BASE 191, serial 196-211, CC_EXT 223 */
+            *len = 223 - 191 + 1;
+            return 191;
+        case 0x18: /* QSFP-DD */
+        case 0x19: /* OSFP */
+        case 0x1E: /* QSFP+ CMIS: serial 166-181, page 00h checksum 222 */
+            *len = 222 - 166 + 1;
+            return 166;
+        default:
+            return -1;
+        }
+}
+
+/*
+ * Returns true if the cached EEPROM still matches the module.
+ */
+static int
+inventory_verify__(int port, inventory_entry_t* e)
+{
+    uint8_t key[64];
+    int len;
+    int offset = inventory_key_range__(e->data, &len);
+
+    if(offset < 0) {
+        /* Rely on presence transitions only. */
+        return 1;
+    }
+    if(onlp_sfp_eeprom_readv(port, 0x50, 0, offset, len, key) < 0) {
+        return 0;
+    }
+    return memcmp(key, e->data + offset, len) == 0;
+}
+
+/*
+ * Per-port refresh work. Runs on the sweep threads.
+ */
+typedef struct inventory_sweep_s {
+    inventory_t* inv;
+    /* Ports whose cached EEPROM only needs verification. */
+    onlp_sfp_bitmap_t verify;
+    /* EEPROM read buffers, indexed by port. */
+    uint8_t (*data)[256];
+} inventory_sweep_t;
+
+#define INVENTORY_SWEEP_VERIFIED 0
+#define INVENTORY_SWEEP_READ     1
+
+static int
+inventory_sweep__(int port, void* cookie)
+{
+    int rv;
+    uint8_t* data = NULL;
+    inventory_sweep_t* is = (inventory_sweep_t*)cookie;
+
+    if(AIM_BITMAP_GET(&is->verify, port) &&
+       inventory_verify__(port, is->inv->entries + port)) {
+        return INVENTORY_SWEEP_VERIFIED;
+    }
+
+    if((rv = onlp_sfp_eeprom_read(port, &data)) < 0) {
+        return rv;
+    }
+    memcpy(is->data[port], data, sizeof(is->data[port]));
+    aim_free(data);
+    return INVENTORY_SWEEP_READ;
+}
+
+/*
+ * Apply a port's sweep result. Called with the inventory lock held.
+ */
+static void
+inventory_port_update__(int port, inventory_entry_t* e, int rv,
+                        const uint8_t* data, uint64_t now)
+{
+    e->verified = now;
+    if(rv == INVENTORY_SWEEP_VERIFIED) {
+        return;
+    }
+
+    e->gen++;
+    if(rv < 0) {
+        e->status = rv;
+        return;
+    }
+    memcpy(e->data, data, sizeof(e->data));
+    e->status = 0;
+
+    /* This is the only place a new insertion is observed. */
+    sff_eeprom_t sff;
+    sff_eeprom_parse(&sff, e->data);
+    if(sff.identified) {
+        rv = onlp_sfp_post_insert(port, &sff.info);
+        if(rv < 0 && rv != ONLP_STATUS_E_UNSUPPORTED) {
+            AIM_LOG_ERROR("Port %d: post insert failed: %{onlp_status}", port, rv);
+        }
+    }
+}
+
+int
+onlp_sfp_inventory_refresh(void)
+{
+    int rv, port;
+    uint64_t now;
+    int* results;
+    onlp_sfp_bitmap_t valid;
+    onlp_sfp_bitmap_t present;
+    onlp_sfp_bitmap_t todo;
+    inventory_sweep_t is;
+    inventory_t* inv = inventory_get__();
+
+    if(inv == NULL) {
+        return ONLP_STATUS_E_INTERNAL;
+    }
+
+    onlp_sfp_bitmap_t_init(&valid);
+    onlp_sfp_bitmap_t_init(&present);
+    onlp_sfp_bitmap_t_init(&todo);
+    onlp_sfp_bitmap_t_init(&is.verify);
+    if((rv = onlp_sfp_bitmap_get(&valid)) < 0) {
+        return rv;
+    }
+
+    onlp_shlock_take(inventory_lock__);
+    if((rv = onlp_sfp_presence_bitmap_get(&present)) < 0) {
+        onlp_shlock_give(inventory_lock__);
+        return rv;
+    }
+
+    now = aim_time_monotonic();
+    AIM_BITMAP_ITER(&valid, port) {
+        inventory_entry_t* e;
+
+        if(port >= INVENTORY_PORTS_MAX) {
+            break;
+        }
+        e = inv->entries + port;
+
+        if(!AIM_BITMAP_GET(&present, port)) {
+            if(e->status != ONLP_STATUS_E_MISSING) {
+                /* Removal */
+                e->status = ONLP_STATUS_E_MISSING;
+                e->gen++;
+            }
+            continue;
+        }
+
+        if(e->status == ONLP_STATUS_E_MISSING) {
+            /* Insertion */
+            AIM_BITMAP_SET(&todo, port);
+        }
+        else if(now - e->verified >= ONLP_CONFIG_SFP_INVENTORY_VERIFY_INTERVAL) {
+            /* Verify the module, or retry a failed read. */
+            AIM_BITMAP_SET(&todo, port);
+            if(e->status == 0) {
+                AIM_BITMAP_SET(&is.verify, port);
+            }
+        }
+    }
+
+    if(AIM_BITMAP_COUNT(&todo)) {
+        /* Ports on different buses are read concurrently. */
+        is.inv = inv;
+        is.data = aim_zmalloc(sizeof(*is.data) * INVENTORY_PORTS_MAX);
+        results = aim_zmalloc(sizeof(int) * ONLP_SFP_PORT_COUNT_MAX);
+        onlp_sfp_sweep(&todo, inventory_sweep__, &is, results);
+
+        AIM_BITMAP_ITER(&todo, port) {
+            inventory_port_update__(port, inv->entries + port, results[port],
+                                    is.data[port], now);
+        }
+        aim_free(results);
+        aim_free(is.data);
+    }
+    onlp_shlock_give(inventory_lock__);
+    return 0;
+}
+
+/*
+ * Bring the process's parsed entry up to date.
+ * Called with both locks held.
+ */
+static int
+inventory_parsed_sync__(inventory_t* inv, int port)
+{
+    inventory_entry_t* e = inv->entries + port;
+    inventory_parsed_t* p = parsed__ + port;
+
+    if(e->status < 0) {
+        return e->status;
+    }
+    if(!p->valid || p->gen != e->gen) {
+        sff_eeprom_parse(&p->sff, e->data);
+        p->gen = e->gen;
+        p->valid = 1;
+    }
+    return 0;
+}
+
+int
+onlp_sfp_inventory_get(int port, sff_eeprom_t* sff)
+{
+    int rv;
+    inventory_t* inv = inventory_get__();
+
+    if(inv == NULL) {
+        return ONLP_STATUS_E_INTERNAL;
+    }
+    if(port < 0 || port >= INVENTORY_PORTS_MAX || sff == NULL) {
+        return ONLP_STATUS_E_PARAM;
+    }
+
+    pthread_mutex_lock(&parsed_lock__);
+    onlp_shlock_take(inventory_lock__);
+    if((rv = inventory_parsed_sync__(inv, port)) == 0) {
+        *sff = parsed__[port].sff;
+    }
+    onlp_shlock_give(inventory_lock__);
+    pthread_mutex_unlock(&parsed_lock__);
+    return rv;
+}
+
+int
+onlp_sfp_inventory_iterate(onlp_sfp_inventory_f cb, void* cookie)
+{
+    int rv, port;
+    onlp_sfp_bitmap_t valid;
+    inventory_t* inv;
+
+    if((rv = onlp_sfp_inventory_refresh()) < 0) {
+        return rv;
+    }
+    inv = inventory_get__();
+
+    onlp_sfp_bitmap_t_init(&valid);
+    onlp_sfp_bitmap_get(&valid);
+
+    /*
+     * Each entry is copied out so the callback runs without the
+     * locks held and may call back into the inventory.
+     */
+    AIM_BITMAP_ITER(&valid, port) {
+        sff_eeprom_t sff;
+        if(port >= INVENTORY_PORTS_MAX) {
+            break;
+        }
+        pthread_mutex_lock(&parsed_lock__);
+        onlp_shlock_take(inventory_lock__);
+        if((rv = inventory_parsed_sync__(inv, port)) == 0) {
+            sff = parsed__[port].sff;
+        }
+        onlp_shlock_give(inventory_lock__);
+        pthread_mutex_unlock(&parsed_lock__);
+        cb(cookie, port, rv, (rv == 0) ? &sff : NULL);
+    }
+    return 0;
+}
+
+#else
+
+int
+onlp_sfp_inventory_refresh(void)
+{
+    return ONLP_STATUS_E_UNSUPPORTED;
+}
+
+int
+onlp_sfp_inventory_get(int port, sff_eeprom_t* sff)
+{
+    return ONLP_STATUS_E_UNSUPPORTED;
+}
+
+/*
+ * Without the cache every iteration reads the modules directly.
+ */
+int
+onlp_sfp_inventory_iterate(onlp_sfp_inventory_f cb, void* cookie)
+{
+    int rv, port;
+    onlp_sfp_bitmap_t valid;
+    onlp_sfp_bitmap_t present;
+
+    onlp_sfp_bitmap_t_init(&valid);
+    onlp_sfp_bitmap_t_init(&present);
+    if((rv = onlp_sfp_bitmap_get(&valid)) < 0 ||
+       (rv = onlp_sfp_presence_bitmap_get(&present)) < 0) {
+        return rv;
+    }
+
+    AIM_BITMAP_ITER(&valid, port) {
+        uint8_t* data;
+        sff_eeprom_t sff;
+
+        if(!AIM_BITMAP_GET(&present, port)) {
+            cb(cookie, port, ONLP_STATUS_E_MISSING, NULL);
+            continue;
+        }
+        if((rv = onlp_sfp_eeprom_read(port, &data)) < 0) {
+            cb(cookie, port, rv, NULL);
+            continue;
+        }
+        sff_eeprom_parse(&sff, data);
+        aim_free(data);
+        cb(cookie, port, 0, &sff);
+    }
+    return 0;
+}
+
+#endif /* ONLP_CONFIG_INCLUDE_SFP_INVENTORY */
@@ -0,0 +1,123 @@
+/************************************************************
+ * <bsn.cl fy=2014 v=onl>
+ *
+ *        Copyright 2014, 2015 Big Switch Networks, Inc.
+ *
+ * Licensed under the Eclipse Public License, Version 1.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ *        http://www.eclipse.org/legal/epl-v10.html
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the
+ * License.
+ *
+ * </bsn.cl>
+ ************************************************************
+ *
+ * SFP port sweeps.
+ *
+ * Ports are grouped by bus and each group is serviced by its
+ * own thread, so the time to sweep all ports is bounded by the
+ * busiest bus rather than the number of ports.
+ *
+ ***********************************************************/
+#include <onlp/onlp_config.h>
+#include <onlp/onlp.h>
+#include <onlp/sfp.h>
+#include "onlp_int.h"
+#include "onlp_log.h"
+#include <pthread.h>
+
+typedef struct sweep_group_s {
+    int bus;
+    onlp_sfp_bitmap_t ports;
+
+    onlp_sfp_sweep_f fn;
+    void* cookie;
+    int* results;
+
+    pthread_t thread;
+    int started;
+} sweep_group_t;
+
+static void*
+sweep_group__(void* arg)
+{
+    int p;
+    sweep_group_t* g = (sweep_group_t*)arg;
+
+    AIM_BITMAP_ITER(&g->ports, p) {
+        int rv = g->fn(p, g->cookie);
+        if(g->results) {
+            g->results[p] = rv;
+        }
+    }
+    return NULL;
+}
+
+int
+onlp_sfp_sweep(onlp_sfp_bitmap_t* ports, onlp_sfp_sweep_f fn, void* cookie,
+               int* results)
+{
+    int p, i;
+    int count = 0;
+    sweep_group_t groups[ONLP_CONFIG_SFP_SWEEP_WORKERS_MAX];
+
+    if(ports == NULL || fn == NULL) {
+        return ONLP_STATUS_E_PARAM;
+    }
+
+    AIM_BITMAP_ITER(ports, p) {
+        int bus = onlp_sfp_port_bus(p);
+
+        for(i = 0; i < count; i++) {
+            if(groups[i].bus == bus) {
+                break;
+            }
+        }
+        if(i == count) {
+            if(count < AIM_ARRAYSIZE(groups)) {
+                sweep_group_t* g = groups + count++;
+                g->bus = bus;
+                onlp_sfp_bitmap_t_init(&g->ports);
+                g->fn = fn;
+                g->cookie = cookie;
+                g->results = results;
+                g->started = 0;
+            }
+            else {
+                /* More buses than workers. Share a worker. */
+                i = (bus < 0 ? 0 : bus) % count;
+            }
+        }
+        AIM_BITMAP_SET(&groups[i].ports, p);
+    }
+
+    /* The calling thread services the first group. */
+    for(i = 1; i < count; i++) {
+        if(pthread_create(&groups[i].thread, NULL, sweep_group__, groups + i) == 0) {
+            groups[i].started = 1;
+        }
+        else {
+            AIM_LOG_ERROR("Could not start an SFP sweep thread. Sweeping serially.");
+        }
+    }
+
+    for(i = 0; i < count; i++) {
+        if(!groups[i].started) {
+            sweep_group__(groups + i);
+        }
+    }
+
+    for(i = 1; i < count; i++) {
+        if(groups[i].started) {
+            pthread_join(groups[i].thread, NULL);
+        }
+    }
+    return 0;
+}
@@ -27,6 +27,8 @@
 #include <onlp/oids.h>
 #include "onlp_int.h"
 #include "onlp_locks.h"
+#include "onlp_oid_cache.h"
+#include "onlp_snapshot.h"
 
 #define VALIDATE(_id)                           \
     do {                                        \
@@ -75,7 +77,7 @@ onlp_thermali_info_from_json__(cJSON* data, onlp_thermal_info_t* info, int error
 #endif
 
 static int
-onlp_thermal_info_get_locked__(onlp_oid_t oid, onlp_thermal_info_t* info)
+onlp_thermal_info_read_locked__(onlp_oid_t oid, onlp_thermal_info_t* info)
 {
     int rv;
     VALIDATE(oid);
@@ -94,7 +96,29 @@ onlp_thermal_info_get_locked__(onlp_oid_t oid, onlp_thermal_info_t* info)
     }
     return rv;
 }
-ONLP_LOCKED_API2(onlp_thermal_info_get, onlp_oid_t, oid, onlp_thermal_info_t*, info);
+ONLP_LOCKED_API2(onlp_thermal_info_read, onlp_oid_t, oid, onlp_thermal_info_t*, info);
+
+int
+onlp_thermal_info_get(onlp_oid_t oid, onlp_thermal_info_t* info)
+{
+    int rv;
+    uint32_t gen;
+
+    if(onlp_oid_cache_get(oid, info, sizeof(*info), &gen) == ONLP_STATUS_OK) {
+        return ONLP_STATUS_OK;
+    }
+#if ONLP_CONFIG_INCLUDE_TELEMETRY_SNAPSHOT == 1
+    if(!onlp_oid_cache_bypassed() &&
+       onlp_snapshot_get(oid, info, sizeof(*info)) == ONLP_STATUS_OK) {
+        return ONLP_STATUS_OK;
+    }
+#endif
+    rv = onlp_thermal_info_read(oid, info);
+    if(rv >= 0) {
+        onlp_oid_cache_put(oid, info, sizeof(*info), gen);
+    }
+    return rv;
+}
 
 static int
 onlp_thermal_status_get_locked__(onlp_oid_t id, uint32_t* status)
@@ -26,6 +26,7 @@
 #define __ONLPLIB_FILE_H__
 
 #include <onlplib/onlplib_config.h>
+#include <AIM/aim_pvs.h>
 
 /**
  * @brief Read the size of the given file.
@@ -194,7 +195,74 @@ int onlp_file_vopen(int flags, int log, const char* fmt, va_list vargs);
 
 /**
  * @brief Search a directory tree for the given file.
+ * @note Results are remembered. A remembered path is used for as
+ * long as it exists and no devices have been added or removed.
  */
 int onlp_file_find(char* root, char* fname, char** rpath);
 
+/**
+ * @brief Forget all remembered onlp_file_find() results.
+ */
+void onlp_file_find_invalidate(void);
+
+/**
+ * @brief Show the onlp_file_find() cache statistics.
+ * @param pvs The output pvs.
+ */
+void onlp_file_find_stats_show(aim_pvs_t* pvs);
+
+
+/**
+ * Persistent file handles.
+ *
+ * A handle resolves its filename once and keeps the file open.
+ * Every read re-reads the file from offset 0, which makes sysfs
+ * attributes regenerate their contents. If the file goes away
+ * (e.g. its device was unplugged) the handle reopens it on the
+ * next read.
+ *
+ * onlp_file_read() and its variants keep a process-wide LRU
+ * cache of handles for sysfs files.
+ */
+typedef struct onlp_file_handle_s onlp_file_handle_t;
+
+/**
+ * @brief Open a file handle.
+ * @param [out] rv Receives the handle.
+ * @param fmt The filename format string.
+ * @param vargs The format arguments.
+ * @note The file need not exist yet.
+ */
+int onlp_file_handle_vopen(onlp_file_handle_t** rv, const char* fmt, va_list vargs);
+
+/**
+ * @brief Open a file handle.
+ * @param [out] rv Receives the handle.
+ * @param fmt The filename format string.
+ * @param ... The format arguments.
+ */
+int onlp_file_handle_open(onlp_file_handle_t** rv, const char* fmt, ...);
+
+/**
+ * @brief Close a file handle.
+ * @param h The handle.
+ */
+void onlp_file_handle_close(onlp_file_handle_t* h);
+
+/**
+ * @brief Read the contents of a file handle.
+ * @param h The handle.
+ * @param data Receives the data.
+ * @param max Maximum read size.
+ * @param len Receives the actual read length.
+ */
+int onlp_file_handle_read(onlp_file_handle_t* h, uint8_t* data, int max, int* len);
+
+/**
+ * @brief Read the integer contents of a file handle.
+ * @param h The handle.
+ * @param value Receives the value.
+ */
+int onlp_file_handle_read_int(onlp_file_handle_t* h, int* value);
+
 #endif /* __ONLPLIB_FILE_H__ */
@@ -26,6 +26,7 @@
 #define __ONLP_GPIO_H__
 
 #include <onlplib/onlplib_config.h>
+#include <stdarg.h>
 
 typedef enum onlp_gpio_direction_e {
     ONLP_GPIO_DIRECTION_NONE,
@@ -57,5 +58,100 @@ int onlp_gpio_set(int gpio, int v);
  */
 int onlp_gpio_get(int gpio, int* rv);
 
+typedef enum onlp_gpio_edge_e {
+    ONLP_GPIO_EDGE_NONE,
+    ONLP_GPIO_EDGE_RISING,
+    ONLP_GPIO_EDGE_FALLING,
+    ONLP_GPIO_EDGE_BOTH,
+} onlp_gpio_edge_t;
+
+/**
+ * @brief Set the edge(s) on which the given GPIO generates an interrupt.
+ * @param gpio The gpio number.
+ * @param edge The interrupt edge.
+ * @note The GPIO must be exported as an input.
+ */
+int onlp_gpio_edge_set(int gpio, onlp_gpio_edge_t edge);
+
+
+/**
+ * GPIO and sysfs attribute watcher.
+ *
+ * A watcher waits for interrupts on GPIO value files and on any
+ * sysfs attribute whose driver calls sysfs_notify(). Each watched
+ * file has a handler which is called with the file's new value
+ * whenever the kernel signals a change.
+ */
+typedef struct onlp_gpio_watcher_s onlp_gpio_watcher_t;
+
+/**
+ * @brief Watch handler.
+ * @param cookie The cookie passed when the watch was added.
+ * @param path The watched file.
+ * @param value The file's current value, or negative if it could not be read.
+ */
+typedef void (*onlp_gpio_watch_f)(void* cookie, const char* path, int value);
+
+/**
+ * @brief Create a watcher.
+ * @param [out] rv Receives the watcher.
+ */
+int onlp_gpio_watcher_create(onlp_gpio_watcher_t** rv);
+
+/**
+ * @brief Destroy a watcher and close all watched files.
+ * @param w The watcher.
+ */
+void onlp_gpio_watcher_destroy(onlp_gpio_watcher_t* w);
+
+/**
+ * @brief Watch a GPIO.
+ * @param w The watcher.
+ * @param gpio The gpio number. It is exported as an input if necessary.
+ * @param edge The interrupt edge.
+ * @param handler The handler.
+ * @param cookie The handler cookie.
+ */
+int onlp_gpio_watch_gpio(onlp_gpio_watcher_t* w, int gpio, onlp_gpio_edge_t edge,
+                         onlp_gpio_watch_f handler, void* cookie);
+
+/**
+ * @brief Watch a sysfs attribute.
+ * @param w The watcher.
+ * @param handler The handler.
+ * @param cookie The handler cookie.
+ * @param fmt The attribute path format.
+ * @note The attribute's driver must call sysfs_notify() when it changes.
+ */
+int onlp_gpio_watch_file(onlp_gpio_watcher_t* w,
+                         onlp_gpio_watch_f handler, void* cookie,
+                         const char* fmt, ...);
+
+/**
+ * @brief Watch a sysfs attribute (va_list).
+ */
+int onlp_gpio_watch_vfile(onlp_gpio_watcher_t* w,
+                          onlp_gpio_watch_f handler, void* cookie,
+                          const char* fmt, va_list vargs);
+
+/**
+ * @brief Get the watcher's descriptor.
+ * @param w The watcher.
+ * @returns A descriptor which becomes readable when a watched
+ * file has changed. Use it to add the watcher to an external
+ * select() or poll() loop, then call onlp_gpio_watcher_run()
+ * with a zero timeout.
+ */
+int onlp_gpio_watcher_fd(onlp_gpio_watcher_t* w);
+
+/**
+ * @brief Wait for changes and call their handlers.
+ * @param w The watcher.
+ * @param timeout_ms The maximum wait in milliseconds. Zero does not
+ * wait and negative waits forever.
+ * @returns The number of handlers called, or negative on error.
+ */
+int onlp_gpio_watcher_run(onlp_gpio_watcher_t* w, int timeout_ms);
+
 
 #endif /* __ONLP_GPIO_H__ */
@@ -0,0 +1,107 @@
+/************************************************************
+ * <bsn.cl fy=2014 v=onl>
+ *
+ *        Copyright 2014, 2015 Big Switch Networks, Inc.
+ *
+ * Licensed under the Eclipse Public License, Version 1.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ *        http://www.eclipse.org/legal/epl-v10.html
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the
+ * License.
+ *
+ * </bsn.cl>
+ ************************************************************
+ *
+ * Hwmon device sampling.
+ *
+ * A hwmon handle holds every sensor attribute of one hwmon
+ * device open and reads them all in a single pass, rather than
+ * opening, reading, and closing each attribute separately.
+ * Standard attribute names are mapped onto the PSU and thermal
+ * info structures.
+ *
+ ***********************************************************/
+#ifndef __ONLPLIB_HWMON_H__
+#define __ONLPLIB_HWMON_H__
+
+#include <onlplib/onlplib_config.h>
+#include <onlp/psu.h>
+#include <onlp/thermal.h>
+#include <stdarg.h>
+
+typedef struct onlp_hwmon_s onlp_hwmon_t;
+
+/**
+ * @brief Open a hwmon device.
+ * @param [out] rv Receives the handle.
+ * @param fmt The device directory format string.
+ * @param vargs The device directory format arguments.
+ * @note The directory may be the hwmon device itself
+ * (e.g. /sys/class/hwmon/hwmon3) or its parent device
+ * (e.g. /sys/bus/i2c/devices/4-0058). Given a parent device,
+ * attributes missing from its hwmonN child are taken from the
+ * parent itself.
+ * @returns ONLP_STATUS_E_MISSING if the device does not exist.
+ */
+int onlp_hwmon_vopen(onlp_hwmon_t** rv, const char* fmt, va_list vargs);
+
+/**
+ * @brief Open a hwmon device.
+ * @param [out] rv Receives the handle.
+ * @param fmt The device directory format string.
+ * @param ... The device directory format arguments.
+ */
+int onlp_hwmon_open(onlp_hwmon_t** rv, const char* fmt, ...);
+
+/**
+ * @brief Close a hwmon device.
+ * @param hw The handle.
+ */
+void onlp_hwmon_close(onlp_hwmon_t* hw);
+
+/**
+ * @brief Read all attributes of the device.
+ * @param hw The handle.
+ * @returns ONLP_STATUS_E_MISSING if the device has gone away.
+ * @note If the device has been removed and recreated since the
+ * last sample its attributes are reopened.
+ */
+int onlp_hwmon_sample(onlp_hwmon_t* hw);
+
+/**
+ * @brief Get an attribute value from the last sample.
+ * @param hw The handle.
+ * @param name The attribute name, e.g. "in1_input".
+ * @param [out] value Receives the value.
+ */
+int onlp_hwmon_value_get(onlp_hwmon_t* hw, const char* name, int* value);
+
+/**
+ * @brief Populate PSU measurements from the last sample.
+ * @param hw The handle.
+ * @param [out] info Receives the measurements and their capabilities.
+ * @note Attributes are identified by their pmbus labels ("vin",
+ * "vout1", "iin", "iout1", "pin", "pout1"). Without labels,
+ * index 1 is the input and index 2 is the output.
+ */
+int onlp_hwmon_psu_info_get(onlp_hwmon_t* hw, onlp_psu_info_t* info);
+
+/**
+ * @brief Populate a thermal from the last sample.
+ * @param hw The handle.
+ * @param index The temperature index (tempN_input).
+ * @param [out] info Receives the temperature and thresholds.
+ * @note tempN_max, tempN_crit and tempN_emergency provide the
+ * warning, error and shutdown thresholds.
+ */
+int onlp_hwmon_thermal_info_get(onlp_hwmon_t* hw, int index,
+                                onlp_thermal_info_t* info);
+
+#endif /* __ONLPLIB_HWMON_H__ */
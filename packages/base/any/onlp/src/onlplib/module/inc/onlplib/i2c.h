@@ -77,6 +77,23 @@
  */
 #define ONLP_I2C_F_DISABLE_READ_RETRIES 0x80
 
+/**
+ * Use a single combined I2C_RDWR transfer for reads if the
+ * adapter supports it. Falls back to SMBUS reads otherwise.
+ * Like ONLP_I2C_F_FORCE, I2C_RDWR bypasses the kernel's busy
+ * address check. Combine the two so the fallback behaves the same.
+ */
+#define ONLP_I2C_F_USE_RDWR 0x100
+
+/**
+ * Deselect lazily. The mux channels are left selected after
+ * device operations. If ONLPLIB_CONFIG_I2C_MUX_STATE_TTL is
+ * enabled, channels which the shared mux state shows are already
+ * selected are not rewritten, and the shared mux state lock is
+ * held from the channel selection until the operation completes.
+ */
+#define ONLP_I2C_F_MUX_LAZY_DESELECT 0x200
+
 /**
  * @brief Open and prepare for reading or writing.
  * @param bus The i2c bus number.
@@ -86,6 +103,27 @@
  */
 int onlp_i2c_open(int bus, uint8_t addr, uint32_t flags);
 
+/**
+ * @brief Close cached i2c bus descriptors.
+ * @param bus The i2c bus number, or -1 for all buses.
+ * @note The onlp_i2c_* transaction functions keep one descriptor
+ * open per bus (see ONLPLIB_CONFIG_INCLUDE_I2C_FD_CACHE).
+ * Call this if the bus topology has changed (e.g. a mux driver
+ * was reloaded). Descriptors are reopened on next use.
+ */
+void onlp_i2c_cache_flush(int bus);
+
+/**
+ * @brief Get the root adapter of an i2c bus.
+ * @param bus The i2c bus number.
+ * @returns The bus number of the adapter at the top of the mux
+ * tree the bus belongs to, or the bus itself if it is not a mux
+ * channel. Transfers on buses with the same root are serialized
+ * by the kernel.
+ * @returns ONLP_STATUS_E_MISSING if the bus does not exist.
+ */
+int onlp_i2c_bus_root(int bus);
+
 
 /**
  * @brief Read i2c data.
@@ -182,6 +220,78 @@ int onlp_i2c_writew(int bus, uint8_t addr, uint8_t offset, uint16_t word,
                     uint32_t flags);
 
 
+/****************************************************************************
+ *
+ * Combined (I2C_RDWR) transfers.
+ *
+ ***************************************************************************/
+
+/**
+ * The maximum number of messages in a single transfer.
+ * This is the kernel's I2C_RDWR_IOCTL_MAX_MSGS.
+ */
+#define ONLP_I2C_TRANSFER_MAX_MSGS 42
+
+/**
+ * The maximum length of a single message.
+ */
+#define ONLP_I2C_TRANSFER_MAX_LEN 8192
+
+/**
+ * This message is a read. The default is a write.
+ */
+#define ONLP_I2C_MSG_F_READ 0x1
+
+/**
+ * A single message in a combined transfer.
+ */
+typedef struct onlp_i2c_msg_s {
+    /** Slave address */
+    uint8_t addr;
+
+    /** See ONLP_I2C_MSG_F_* */
+    uint32_t flags;
+
+    /** Data length */
+    uint16_t len;
+
+    /** Data to write or buffer to receive the read data. */
+    uint8_t* buf;
+
+} onlp_i2c_msg_t;
+
+/**
+ * @brief Perform a combined transfer.
+ * @param bus The i2c bus number.
+ * @param msgs The messages.
+ * @param count The number of messages.
+ * @param flags See ONLP_I2C_F_*
+ * @note All messages are issued in a single I2C_RDWR ioctl
+ * with repeated starts between them. Messages may target different
+ * slave addresses (e.g. a mux channel select followed by a device read).
+ * @returns ONLP_STATUS_E_UNSUPPORTED if the adapter does not
+ * support plain i2c transfers.
+ */
+int onlp_i2c_transfer(int bus, onlp_i2c_msg_t* msgs, int count,
+                      uint32_t flags);
+
+/**
+ * @brief Read i2c data using a single combined transfer.
+ * @param bus The i2c bus number.
+ * @param addr The slave address.
+ * @param offset The starting offset.
+ * @param size The byte count.
+ * @param rdata [out] Receives the data.
+ * @param flags See ONLP_I2C_F_*
+ * @note The offset is written and all data is read back
+ * in one kernel round-trip.
+ * @returns ONLP_STATUS_E_UNSUPPORTED if the adapter does not
+ * support plain i2c transfers.
+ */
+int onlp_i2c_rdwr_read(int bus, uint8_t addr, uint8_t offset, int size,
+                       uint8_t* rdata, uint32_t flags);
+
+
 
 /****************************************************************************
  *
@@ -274,6 +384,7 @@ typedef struct onlp_i2c_dev_s {
  * @brief Select a mux channel.
  * @param muxdev The mux device instance.
  * @param channel The channel number to select.
+ * @note The selection is always written to the mux.
  */
 int onlp_i2c_mux_select(onlp_i2c_mux_device_t* muxdev, int channel);
 
@@ -283,6 +394,22 @@ int onlp_i2c_mux_select(onlp_i2c_mux_device_t* muxdev, int channel);
  */
 int onlp_i2c_mux_deselect(onlp_i2c_mux_device_t* muxdev);
 
+/**
+ * @brief Rewrite the tracked channel selection to the mux.
+ * @param muxdev The mux device instance.
+ * @note If the channel state is unknown (or not tracked)
+ * the mux is deselected.
+ */
+int onlp_i2c_mux_resync(onlp_i2c_mux_device_t* muxdev);
+
+/**
+ * @brief Forget the tracked channel selection.
+ * @param muxdev The mux device instance.
+ * @note The next select will always be written to the mux.
+ * Use this if the mux may have been programmed elsewhere.
+ */
+void onlp_i2c_mux_invalidate(onlp_i2c_mux_device_t* muxdev);
+
 /**
  * @brief Select a mux channel.
  */
@@ -0,0 +1,89 @@
+/************************************************************
+ * <bsn.cl fy=2014 v=onl>
+ *
+ *        Copyright 2014, 2015 Big Switch Networks, Inc.
+ *
+ * Licensed under the Eclipse Public License, Version 1.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ *        http://www.eclipse.org/legal/epl-v10.html
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the
+ * License.
+ *
+ * </bsn.cl>
+ ************************************************************
+ *
+ * BMC access through the OpenIPMI driver.
+ *
+ * The sensor data record (SDR) repository is read once and
+ * kept in a per-process sensor table. Readings are fetched with
+ * Get Sensor Reading when a cached reading is older than the
+ * caller's age limit, so no external tools are required.
+ *
+ ***********************************************************/
+#ifndef __ONLPLIB_IPMI_H__
+#define __ONLPLIB_IPMI_H__
+
+#include <onlplib/onlplib_config.h>
+#include <AIM/aim_pvs.h>
+#include <stdint.h>
+
+#define ONLP_IPMI_NETFN_CHASSIS 0x00
+#define ONLP_IPMI_NETFN_SENSOR  0x04
+#define ONLP_IPMI_NETFN_APP     0x06
+#define ONLP_IPMI_NETFN_STORAGE 0x0A
+
+/**
+ * @brief Set the IPMI device.
+ * @param path The device path, or NULL for ONLPLIB_CONFIG_IPMI_DEVICE.
+ * @note This closes the current device and discards the sensor table.
+ */
+int onlp_ipmi_device_set(const char* path);
+
+/**
+ * @brief Send a request to the BMC and wait for the response.
+ * @param netfn The network function.
+ * @param cmd The command.
+ * @param req The request data.
+ * @param req_len The request data length.
+ * @param [out] rsp Receives the response data, without the completion code.
+ * @param rsp_len The maximum response data length.
+ * @returns The response data length, or negative on error.
+ * @note A non-zero completion code is returned as ONLP_STATUS_E_INTERNAL.
+ */
+int onlp_ipmi_cmd(uint8_t netfn, uint8_t cmd,
+                  const uint8_t* req, int req_len,
+                  uint8_t* rsp, int rsp_len);
+
+/**
+ * @brief Get a sensor reading by SDR name.
+ * @param name The sensor ID string, as reported by "ipmitool sdr".
+ * @param max_age The maximum age (in usecs) of a cached reading.
+ * @param [out] value Receives the converted reading.
+ * @returns ONLP_STATUS_E_MISSING if there is no such sensor.
+ * @returns ONLP_STATUS_E_UNSUPPORTED if the reading is unavailable.
+ * @returns ONLP_STATUS_E_INTERNAL if the BMC cannot be reached. A failed
+ * SDR repository load is returned without retrying until its backoff
+ * interval (at most ONLPLIB_CONFIG_IPMI_SDR_RETRY_MS) has passed.
+ */
+int onlp_ipmi_sensor_get(const char* name, uint64_t max_age, double* value);
+
+/**
+ * @brief Re-read the SDR repository on the next sensor access.
+ * @note This also cancels any load failure backoff.
+ */
+void onlp_ipmi_sdr_invalidate(void);
+
+/**
+ * @brief Show the sensor table.
+ * @param pvs The output pvs.
+ */
+void onlp_ipmi_sensors_show(aim_pvs_t* pvs);
+
+#endif /* __ONLPLIB_IPMI_H__ */
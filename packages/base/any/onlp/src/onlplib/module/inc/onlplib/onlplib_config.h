@@ -165,6 +165,116 @@
 #define ONLPLIB_CONFIG_INCLUDE_I2C_SMBUS 0
 #endif
 
+/**
+ * ONLPLIB_CONFIG_INCLUDE_I2C_FD_CACHE
+ *
+ * Cache and reuse per-bus i2c device descriptors across transactions. */
+
+
+#ifndef ONLPLIB_CONFIG_INCLUDE_I2C_FD_CACHE
+#define ONLPLIB_CONFIG_INCLUDE_I2C_FD_CACHE 1
+#endif
+
+/**
+ * ONLPLIB_CONFIG_I2C_FD_CACHE_SIZE
+ *
+ * The number of i2c buses (starting at bus 0) whose descriptors can be cached. */
+
+
+#ifndef ONLPLIB_CONFIG_I2C_FD_CACHE_SIZE
+#define ONLPLIB_CONFIG_I2C_FD_CACHE_SIZE 256
+#endif
+
+/**
+ * ONLPLIB_CONFIG_I2C_MUX_STATE_TTL
+ *
+ * The time (in usecs) a tracked i2c mux channel selection is trusted by ONLP_I2C_F_MUX_LAZY_DESELECT operations. The tracked state is kept in shared memory and only used under a shared lock. Zero disables mux state tracking. */
+
+
+#ifndef ONLPLIB_CONFIG_I2C_MUX_STATE_TTL
+#define ONLPLIB_CONFIG_I2C_MUX_STATE_TTL 0
+#endif
+
+/**
+ * ONLPLIB_CONFIG_INCLUDE_IPMI
+ *
+ * Include OpenIPMI (/dev/ipmi) BMC support. */
+
+
+#ifndef ONLPLIB_CONFIG_INCLUDE_IPMI
+#define ONLPLIB_CONFIG_INCLUDE_IPMI 1
+#endif
+
+/**
+ * ONLPLIB_CONFIG_IPMI_DEVICE
+ *
+ * The default IPMI device. */
+
+
+#ifndef ONLPLIB_CONFIG_IPMI_DEVICE
+#define ONLPLIB_CONFIG_IPMI_DEVICE "/dev/ipmi0"
+#endif
+
+/**
+ * ONLPLIB_CONFIG_IPMI_TIMEOUT_MS
+ *
+ * The time (in msecs) to wait for a BMC response. */
+
+
+#ifndef ONLPLIB_CONFIG_IPMI_TIMEOUT_MS
+#define ONLPLIB_CONFIG_IPMI_TIMEOUT_MS 5000
+#endif
+
+/**
+ * ONLPLIB_CONFIG_IPMI_SENSORS_MAX
+ *
+ * The maximum number of SDR sensor records cached. */
+
+
+#ifndef ONLPLIB_CONFIG_IPMI_SENSORS_MAX
+#define ONLPLIB_CONFIG_IPMI_SENSORS_MAX 256
+#endif
+
+/**
+ * ONLPLIB_CONFIG_HWMON_ATTRIBUTES_MAX
+ *
+ * The maximum number of attributes held open per hwmon device. */
+
+
+#ifndef ONLPLIB_CONFIG_HWMON_ATTRIBUTES_MAX
+#define ONLPLIB_CONFIG_HWMON_ATTRIBUTES_MAX 64
+#endif
+
+/**
+ * ONLPLIB_CONFIG_FILE_HANDLE_CACHE_SIZE
+ *
+ * The number of sysfs attributes kept open by the file read API. Zero disables the cache. */
+
+
+#ifndef ONLPLIB_CONFIG_FILE_HANDLE_CACHE_SIZE
+#define ONLPLIB_CONFIG_FILE_HANDLE_CACHE_SIZE 256
+#endif
+
+/**
+ * ONLPLIB_CONFIG_FILE_FIND_CACHE_SIZE
+ *
+ * The number of onlp_file_find() results remembered. Zero disables the cache. */
+
+
+#ifndef ONLPLIB_CONFIG_FILE_FIND_CACHE_SIZE
+#define ONLPLIB_CONFIG_FILE_FIND_CACHE_SIZE 128
+#endif
+
+/**
+ * ONLPLIB_CONFIG_IPMI_SDR_RETRY_MS
+ *
+ * The maximum time (in msecs) between attempts to load the SDR repository after a failure. The retry interval doubles from one second up to this limit. */
+
+
+#ifndef ONLPLIB_CONFIG_IPMI_SDR_RETRY_MS
+#define ONLPLIB_CONFIG_IPMI_SDR_RETRY_MS 60000
+#endif
+
 
 
 /**
@@ -27,6 +27,7 @@
 
 #include <onlplib/onlplib_config.h>
 #include <pthread.h>
+#include <stdint.h>
 #include <sys/shm.h>
 
 typedef struct onlp_shlock_s onlp_shlock_t;
@@ -76,6 +77,58 @@ int onlp_shlock_give(onlp_shlock_t* shlock);
 const char* onlp_shlock_name(onlp_shlock_t* lock);
 
 
+/**
+ * Shared/exclusive IPC locks.
+ *
+ * Any number of processes may hold the lock shared, or a single
+ * process may hold it exclusively. Waiting writers block new
+ * readers. Holders which exit without releasing the lock are
+ * detected and discarded the next time a waiter times out.
+ *
+ * Ownership is tracked per process, not per thread. A give is
+ * only checked against the calling process, and a holder is only
+ * discarded when its whole process has exited, not a thread.
+ */
+typedef struct onlp_shrwlock_s onlp_shrwlock_t;
+
+/**
+ * @brief Create a shared memory reader/writer lock with the given id.
+ * @param id The shared memory id.
+ * @param rv Receives the shared lock.
+ */
+int onlp_shrwlock_create(key_t id, onlp_shrwlock_t** rv,
+                         const char* name, ...);
+
+/**
+ * @brief Detach from a shared memory reader/writer lock.
+ * @param lock The lock. It must not be held by this process.
+ * @note The shared segment and its state remain for other processes.
+ */
+int onlp_shrwlock_destroy(onlp_shrwlock_t* lock);
+
+/**
+ * @brief Take a shared memory reader/writer lock.
+ * @param lock The lock.
+ * @param exclusive Take the lock exclusively if true, shared otherwise.
+ * @param timeout Timeout in microseconds. Negative waits forever.
+ * @returns 0 on success, -1 if the timeout expired.
+ */
+int onlp_shrwlock_take(onlp_shrwlock_t* lock, int exclusive, int64_t timeout);
+
+/**
+ * @brief Give a shared memory reader/writer lock.
+ * @param lock The lock.
+ * @param exclusive Must match the mode in which the lock was taken.
+ */
+int onlp_shrwlock_give(onlp_shrwlock_t* lock, int exclusive);
+
+/**
+ * @brief Get a reader/writer lock's name.
+ * @param lock The lock.
+ */
+const char* onlp_shrwlock_name(onlp_shrwlock_t* lock);
+
+
 /**
  * A single global lock is always initialized
  * and ready at startup.
@@ -34,6 +34,10 @@
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <sys/stat.h>
+#include <sys/vfs.h>
+#include <linux/magic.h>
+#include <pthread.h>
+#include <inttypes.h>
 
 /**
  * @brief Connects to a unix domain socket.
@@ -81,18 +85,18 @@ ds_connect__(const char* path)
  * @brief Open a file or domain socket.
  * @param dst Receives the full filename (for logging purposes).
  * @param flags The open flags.
- * @param fmt Format specifier.
- * @param vargs Format specifier arguments.
+ * @param name The filename, optionally with a search asterisk.
+ * @param sock If not NULL, receives whether the file is a domain socket.
  */
 static int
-vopen__(char** dst, int flags, const char* fmt, va_list vargs)
+open__(char** dst, int flags, const char* name, int* sock)
 {
     int fd;
     struct stat sb;
     char fname[PATH_MAX];
     char* asterisk;
 
-    ONLPLIB_VSNPRINTF(fname, sizeof(fname)-1, fmt, vargs);
+    aim_strlcpy(fname, name, sizeof(fname));
 
     /**
      * An asterisk in the filename separates a search root
@@ -117,6 +121,10 @@ vopen__(char** dst, int flags, const char* fmt, va_list vargs)
         return ONLP_STATUS_E_MISSING;
     }
 
+    if(sock) {
+        *sock = S_ISSOCK(sb.st_mode);
+    }
+
     if(S_ISSOCK(sb.st_mode)) {
         fd = ds_connect__(fname);
     }
@@ -127,6 +135,193 @@ vopen__(char** dst, int flags, const char* fmt, va_list vargs)
     return (fd > 0) ? fd : ONLP_STATUS_E_MISSING;
 }
 
+/**
+ * @brief Open a file or domain socket.
+ * @param dst Receives the full filename (for logging purposes).
+ * @param flags The open flags.
+ * @param fmt Format specifier.
+ * @param vargs Format specifier arguments.
+ */
+static int
+vopen__(char** dst, int flags, const char* fmt, va_list vargs)
+{
+    char fname[PATH_MAX];
+    ONLPLIB_VSNPRINTF(fname, sizeof(fname)-1, fmt, vargs);
+    return open__(dst, flags, fname, NULL);
+}
+
+/*
+ * The file is lost if its device has gone away.
+ */
+static int
+file_lost__(int err)
+{
+    return err == ENODEV || err == ENOENT || err == ENXIO || err == ESTALE;
+}
+
+
+/************************************************************
+ *
+ * Cached Read Handles
+ *
+ * Reads through the varargs API are served from open sysfs
+ * attributes. Entries are reference counted so an attribute
+ * is never closed while another thread is reading it.
+ *
+ ***********************************************************/
+#if ONLPLIB_CONFIG_FILE_HANDLE_CACHE_SIZE > 0
+
+typedef struct file_cache_entry_s {
+    char* name;
+    uint32_t hash;
+    int fd;
+    int refs;
+    int stale;
+    uint64_t used;
+} file_cache_entry_t;
+
+static file_cache_entry_t file_cache__[ONLPLIB_CONFIG_FILE_HANDLE_CACHE_SIZE];
+static pthread_mutex_t file_cache_lock__ = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t file_cache_clock__ = 0;
+
+static uint32_t
+file_cache_hash__(const char* s)
+{
+    uint32_t h = 2166136261U;
+    for(; *s; s++) {
+        h = (h ^ (uint8_t)*s) * 16777619U;
+    }
+    return h;
+}
+
+static void
+file_cache_drop__(file_cache_entry_t* e)
+{
+    close(e->fd);
+    aim_free(e->name);
+    memset(e, 0, sizeof(*e));
+}
+
+/*
+ * Returns a referenced entry for the given file, or NULL
+ * if the file cannot be cached. If the file cannot be opened
+ * the error is returned in err.
+ */
+static file_cache_entry_t*
+file_cache_get__(const char* name, int* err)
+{
+    int i, fd, sock;
+    struct statfs sfs;
+    uint32_t hash = file_cache_hash__(name);
+    file_cache_entry_t* e = NULL;
+    file_cache_entry_t* victim = NULL;
+
+    pthread_mutex_lock(&file_cache_lock__);
+    for(i = 0; i < AIM_ARRAYSIZE(file_cache__); i++) {
+        file_cache_entry_t* c = file_cache__ + i;
+        if(c->name && !c->stale && c->hash == hash && !strcmp(c->name, name)) {
+            e = c;
+            break;
+        }
+    }
+    if(e) {
+        e->refs++;
+        e->used = ++file_cache_clock__;
+    }
+    pthread_mutex_unlock(&file_cache_lock__);
+    if(e) {
+        return e;
+    }
+
+    /*
+     * Only sysfs regenerates its contents on every read from offset 0.
+     * Anything outside of /sys is rejected without opening it.
+     */
+    if(strncmp(name, "/sys/", 5)) {
+        return NULL;
+    }
+    if((fd = open__(NULL, O_RDONLY, name, &sock)) < 0) {
+        *err = fd;
+        return NULL;
+    }
+    if(sock || fstatfs(fd, &sfs) < 0 || sfs.f_type != SYSFS_MAGIC) {
+        close(fd);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&file_cache_lock__);
+    for(i = 0; i < AIM_ARRAYSIZE(file_cache__); i++) {
+        file_cache_entry_t* c = file_cache__ + i;
+        if(c->refs) {
+            continue;
+        }
+        if(c->name == NULL) {
+            victim = c;
+            break;
+        }
+        if(victim == NULL || c->stale || (!victim->stale && c->used < victim->used)) {
+            victim = c;
+        }
+    }
+    if(victim) {
+        if(victim->name) {
+            file_cache_drop__(victim);
+        }
+        victim->name = aim_strdup(name);
+        victim->hash = hash;
+        victim->fd = fd;
+        victim->refs = 1;
+        victim->used = ++file_cache_clock__;
+    }
+    pthread_mutex_unlock(&file_cache_lock__);
+
+    if(victim == NULL) {
+        /* Every entry is in use. */
+        close(fd);
+    }
+    return victim;
+}
+
+static void
+file_cache_put__(file_cache_entry_t* e, int stale)
+{
+    pthread_mutex_lock(&file_cache_lock__);
+    if(stale) {
+        e->stale = 1;
+    }
+    if(--e->refs == 0 && e->stale) {
+        file_cache_drop__(e);
+    }
+    pthread_mutex_unlock(&file_cache_lock__);
+}
+
+/*
+ * Returns 1 if the read was served from the cache, or the
+ * error if the file could not be opened.
+ */
+static int
+file_cache_read__(const char* name, uint8_t* data, int max, int* len)
+{
+    int n;
+    int err = 0;
+    file_cache_entry_t* e = file_cache_get__(name, &err);
+
+    if(e == NULL) {
+        return err;
+    }
+
+    memset(data, 0, max);
+    n = pread(e->fd, data, max, 0);
+    file_cache_put__(e, n < 0 && file_lost__(errno));
+    if(n > 0) {
+        *len = n;
+        return 1;
+    }
+    return 0;
+}
+
+#endif /* ONLPLIB_CONFIG_FILE_HANDLE_CACHE_SIZE */
+
 int
 onlp_file_vsize(const char* fmt, va_list vargs)
 {
@@ -162,8 +357,17 @@ onlp_file_vread(uint8_t* data, int max, int* len, const char* fmt, va_list vargs
     int fd;
     char* fname = NULL;
     int rv;
+    char name[PATH_MAX];
+
+    ONLPLIB_VSNPRINTF(name, sizeof(name)-1, fmt, vargs);
+
+#if ONLPLIB_CONFIG_FILE_HANDLE_CACHE_SIZE > 0
+    if((rv = file_cache_read__(name, data, max, len)) != 0) {
+        return (rv > 0) ? ONLP_STATUS_OK : rv;
+    }
+#endif
 
-    if ((fd = vopen__(&fname, O_RDONLY, fmt, vargs)) < 0) {
+    if ((fd = open__(&fname, O_RDONLY, name, NULL)) < 0) {
         rv = fd;
     }
     else {
@@ -416,8 +620,8 @@ onlp_file_vopen(int flags, int log, const char* fmt, va_list vargs)
 #include <err.h>
 #include <fts.h>
 
-int
-onlp_file_find(char* root, char* fname, char** rpath)
+static int
+file_find__(char* root, char* fname, char** rpath)
 {
     FTS *fs;
     FTSENT *ent;
@@ -447,3 +651,319 @@ onlp_file_find(char* root, char* fname, char** rpath)
     fts_close(fs);
     return ONLP_STATUS_E_MISSING;
 }
+
+/*
+ * Search results are remembered by (root, filename). A result is
+ * trusted while its path still exists and no kernel add, remove or
+ * move uevents have been seen since it was found.
+ */
+#if ONLPLIB_CONFIG_FILE_FIND_CACHE_SIZE > 0
+
+#include <sys/socket.h>
+#include <linux/netlink.h>
+
+typedef struct file_find_entry_s {
+    char* root;
+    char* fname;
+    char* path;
+    uint64_t used;
+} file_find_entry_t;
+
+static struct {
+    pthread_mutex_t lock;
+    file_find_entry_t entries[ONLPLIB_CONFIG_FILE_FIND_CACHE_SIZE];
+    uint64_t clock;
+    int uevent_fd;
+
+    uint64_t hits;
+    uint64_t walks;
+    uint64_t stale;
+    uint64_t invalidations;
+} find_cache__ = { PTHREAD_MUTEX_INITIALIZER, .uevent_fd = -1 };
+
+static void
+file_find_entry_clear__(file_find_entry_t* e)
+{
+    aim_free(e->root);
+    aim_free(e->fname);
+    aim_free(e->path);
+    memset(e, 0, sizeof(*e));
+}
+
+static void
+file_find_invalidate_locked__(void)
+{
+    int i;
+    for(i = 0; i < AIM_ARRAYSIZE(find_cache__.entries); i++) {
+        if(find_cache__.entries[i].path) {
+            file_find_entry_clear__(find_cache__.entries + i);
+        }
+    }
+    find_cache__.invalidations++;
+}
+
+/*
+ * Drain pending kernel uevents. Any hotplug invalidates the cache.
+ */
+static void
+file_find_uevents__(void)
+{
+    char buf[512];
+    int hotplug = 0;
+    ssize_t n;
+
+    if(find_cache__.uevent_fd < 0) {
+        struct sockaddr_nl sa;
+        int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                        NETLINK_KOBJECT_UEVENT);
+        if(fd < 0) {
+            return;
+        }
+        memset(&sa, 0, sizeof(sa));
+        sa.nl_family = AF_NETLINK;
+        sa.nl_groups = 1;
+        if(bind(fd, (struct sockaddr*)&sa, sizeof(sa)) < 0) {
+            close(fd);
+            return;
+        }
+        find_cache__.uevent_fd = fd;
+    }
+
+    while((n = recv(find_cache__.uevent_fd, buf, sizeof(buf) - 1, MSG_DONTWAIT)) > 0) {
+        buf[n] = 0;
+        if(!strncmp(buf, "add@", 4) || !strncmp(buf, "remove@", 7) ||
+           !strncmp(buf, "move@", 5)) {
+            hotplug = 1;
+        }
+    }
+    if(n < 0 && errno == ENOBUFS) {
+        /* Events were dropped. Assume the worst. */
+        hotplug = 1;
+    }
+    if(hotplug) {
+        file_find_invalidate_locked__();
+    }
+}
+
+int
+onlp_file_find(char* root, char* fname, char** rpath)
+{
+    int i, rv;
+    struct stat sb;
+    char* path = NULL;
+    file_find_entry_t* victim = NULL;
+
+    pthread_mutex_lock(&find_cache__.lock);
+    file_find_uevents__();
+    for(i = 0; i < AIM_ARRAYSIZE(find_cache__.entries); i++) {
+        file_find_entry_t* e = find_cache__.entries + i;
+        if(e->path && !strcmp(e->fname, fname) && !strcmp(e->root, root)) {
+            if(stat(e->path, &sb) == 0) {
+                e->used = ++find_cache__.clock;
+                find_cache__.hits++;
+                *rpath = aim_strdup(e->path);
+                pthread_mutex_unlock(&find_cache__.lock);
+                return ONLP_STATUS_OK;
+            }
+            find_cache__.stale++;
+            file_find_entry_clear__(e);
+            break;
+        }
+    }
+    find_cache__.walks++;
+    pthread_mutex_unlock(&find_cache__.lock);
+
+    if((rv = file_find__(root, fname, &path)) < 0) {
+        return rv;
+    }
+
+    pthread_mutex_lock(&find_cache__.lock);
+    for(i = 0; i < AIM_ARRAYSIZE(find_cache__.entries); i++) {
+        file_find_entry_t* e = find_cache__.entries + i;
+        if(e->path == NULL) {
+            victim = e;
+            break;
+        }
+        if(victim == NULL || e->used < victim->used) {
+            victim = e;
+        }
+    }
+    file_find_entry_clear__(victim);
+    victim->root = aim_strdup(root);
+    victim->fname = aim_strdup(fname);
+    victim->path = aim_strdup(path);
+    victim->used = ++find_cache__.clock;
+    pthread_mutex_unlock(&find_cache__.lock);
+
+    *rpath = path;
+    return ONLP_STATUS_OK;
+}
+
+void
+onlp_file_find_invalidate(void)
+{
+    pthread_mutex_lock(&find_cache__.lock);
+    file_find_invalidate_locked__();
+    pthread_mutex_unlock(&find_cache__.lock);
+}
+
+void
+onlp_file_find_stats_show(aim_pvs_t* pvs)
+{
+    pthread_mutex_lock(&find_cache__.lock);
+    aim_printf(pvs, "file find: %"PRIu64" walks avoided, %"PRIu64" walks, "
+               "%"PRIu64" stale, %"PRIu64" invalidations\n",
+               find_cache__.hits, find_cache__.walks, find_cache__.stale,
+               find_cache__.invalidations);
+    pthread_mutex_unlock(&find_cache__.lock);
+}
+
+#else
+
+int
+onlp_file_find(char* root, char* fname, char** rpath)
+{
+    return file_find__(root, fname, rpath);
+}
+
+void
+onlp_file_find_invalidate(void)
+{
+}
+
+void
+onlp_file_find_stats_show(aim_pvs_t* pvs)
+{
+    aim_printf(pvs, "file find caching is not available in this build.\n");
+}
+
+#endif /* ONLPLIB_CONFIG_FILE_FIND_CACHE_SIZE */
+
+
+/************************************************************
+ *
+ * File Handles
+ *
+ ***********************************************************/
+
+struct onlp_file_handle_s {
+    /* The formatted filename, which may include a search asterisk. */
+    char* name;
+    int fd;
+    /* Domain sockets are reconnected for every read. */
+    int sock;
+};
+
+static int
+handle_open__(onlp_file_handle_t* h)
+{
+    int fd = open__(NULL, O_RDONLY, h->name, &h->sock);
+    if(fd < 0) {
+        return fd;
+    }
+    if(h->sock) {
+        close(fd);
+    }
+    else {
+        h->fd = fd;
+    }
+    return 0;
+}
+
+static void
+handle_close__(onlp_file_handle_t* h)
+{
+    if(h->fd >= 0) {
+        close(h->fd);
+        h->fd = -1;
+    }
+}
+
+int
+onlp_file_handle_vopen(onlp_file_handle_t** rv, const char* fmt, va_list vargs)
+{
+    onlp_file_handle_t* h;
+
+    if(rv == NULL || fmt == NULL) {
+        return ONLP_STATUS_E_PARAM;
+    }
+
+    h = aim_zmalloc(sizeof(*h));
+    h->name = aim_vfstrdup(fmt, vargs);
+    h->fd = -1;
+    /* A missing file is opened on first read. */
+    handle_open__(h);
+    *rv = h;
+    return 0;
+}
+
+int
+onlp_file_handle_open(onlp_file_handle_t** rv, const char* fmt, ...)
+{
+    int rc;
+    va_list vargs;
+    va_start(vargs, fmt);
+    rc = onlp_file_handle_vopen(rv, fmt, vargs);
+    va_end(vargs);
+    return rc;
+}
+
+void
+onlp_file_handle_close(onlp_file_handle_t* h)
+{
+    if(h) {
+        handle_close__(h);
+        aim_free(h->name);
+        aim_free(h);
+    }
+}
+
+int
+onlp_file_handle_read(onlp_file_handle_t* h, uint8_t* data, int max, int* len)
+{
+    int n;
+    int retry;
+
+    if(h->sock) {
+        return onlp_file_read(data, max, len, "%s", h->name);
+    }
+
+    for(retry = 0; retry < 2; retry++) {
+        if(h->fd < 0) {
+            int rv = handle_open__(h);
+            if(rv < 0) {
+                return rv;
+            }
+            if(h->sock) {
+                return onlp_file_read(data, max, len, "%s", h->name);
+            }
+        }
+
+        memset(data, 0, max);
+        if((n = pread(h->fd, data, max, 0)) > 0) {
+            *len = n;
+            return ONLP_STATUS_OK;
+        }
+        if(n == 0 || !file_lost__(errno)) {
+            break;
+        }
+        /* The file went away. Resolve and reopen it. */
+        handle_close__(h);
+    }
+
+    AIM_LOG_ERROR("Failed to read input file '%s'", h->name);
+    return ONLP_STATUS_E_INTERNAL;
+}
+
+int
+onlp_file_handle_read_int(onlp_file_handle_t* h, int* value)
+{
+    int rv, len;
+    uint8_t data[32];
+
+    if((rv = onlp_file_handle_read(h, data, sizeof(data) - 1, &len)) < 0) {
+        return rv;
+    }
+    *value = ONLPLIB_ATOI((char*)data);
+    return 0;
+}
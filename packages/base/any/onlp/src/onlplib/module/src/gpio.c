@@ -29,6 +29,8 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <dirent.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
 #include "onlplib_log.h"
 
 #define SYS_CLASS_GPIO_PATH "/sys/class/gpio/gpio%d"
@@ -88,3 +90,191 @@ onlp_gpio_get(int gpio, int* v)
     return onlp_file_read_int(v, SYS_CLASS_GPIO_PATH "/value", gpio);
 }
 
+
+int
+onlp_gpio_edge_set(int gpio, onlp_gpio_edge_t edge)
+{
+    const char* s;
+    switch(edge)
+        {
+        case ONLP_GPIO_EDGE_NONE: s = "none\n"; break;
+        case ONLP_GPIO_EDGE_RISING: s = "rising\n"; break;
+        case ONLP_GPIO_EDGE_FALLING: s = "falling\n"; break;
+        case ONLP_GPIO_EDGE_BOTH: s = "both\n"; break;
+        default:
+            return ONLP_STATUS_E_PARAM;
+        }
+
+    if(onlp_file_write_str(s, SYS_CLASS_GPIO_PATH "/edge", gpio) < 0) {
+        AIM_LOG_ERROR("Failed to set gpio%d edge=%s: %{errno}",
+                      gpio, s, errno);
+        return -1;
+    }
+    return 0;
+}
+
+
+/*
+ * Watched files are held open. sysfs signals a change as
+ * POLLPRI|POLLERR on the open descriptor, which stays signalled
+ * until the file is read again from the start.
+ */
+typedef struct gpio_watch_s {
+    int fd;
+    char* path;
+    onlp_gpio_watch_f handler;
+    void* cookie;
+    struct gpio_watch_s* next;
+} gpio_watch_t;
+
+struct onlp_gpio_watcher_s {
+    int epfd;
+    gpio_watch_t* watches;
+};
+
+#define GPIO_WATCHER_EVENTS_MAX 16
+
+int
+onlp_gpio_watcher_create(onlp_gpio_watcher_t** rv)
+{
+    onlp_gpio_watcher_t* w = aim_zmalloc(sizeof(*w));
+
+    if((w->epfd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+        AIM_LOG_ERROR("epoll_create1() failed: %{errno}", errno);
+        aim_free(w);
+        return ONLP_STATUS_E_INTERNAL;
+    }
+    *rv = w;
+    return 0;
+}
+
+void
+onlp_gpio_watcher_destroy(onlp_gpio_watcher_t* w)
+{
+    gpio_watch_t* gw;
+
+    if(w == NULL) {
+        return;
+    }
+    while((gw = w->watches)) {
+        w->watches = gw->next;
+        close(gw->fd);
+        aim_free(gw->path);
+        aim_free(gw);
+    }
+    close(w->epfd);
+    aim_free(w);
+}
+
+/*
+ * Read the watched file from the start. This also rearms
+ * the notification.
+ */
+static int
+gpio_watch_read__(gpio_watch_t* gw)
+{
+    char buf[32];
+    ssize_t len;
+
+    if(lseek(gw->fd, 0, SEEK_SET) < 0 ||
+       (len = read(gw->fd, buf, sizeof(buf)-1)) < 0) {
+        return -1;
+    }
+    buf[len] = 0;
+    return (int)strtol(buf, NULL, 0);
+}
+
+int
+onlp_gpio_watch_vfile(onlp_gpio_watcher_t* w,
+                      onlp_gpio_watch_f handler, void* cookie,
+                      const char* fmt, va_list vargs)
+{
+    struct epoll_event ev;
+    gpio_watch_t* gw = aim_zmalloc(sizeof(*gw));
+
+    gw->path = aim_vfstrdup(fmt, vargs);
+    gw->handler = handler;
+    gw->cookie = cookie;
+
+    if((gw->fd = open(gw->path, O_RDONLY | O_CLOEXEC)) < 0) {
+        AIM_LOG_ERROR("Could not open %s: %{errno}", gw->path, errno);
+        aim_free(gw->path);
+        aim_free(gw);
+        return ONLP_STATUS_E_MISSING;
+    }
+
+    /* Consume the initial state so only changes are reported. */
+    gpio_watch_read__(gw);
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLPRI | EPOLLERR;
+    ev.data.ptr = gw;
+    if(epoll_ctl(w->epfd, EPOLL_CTL_ADD, gw->fd, &ev) < 0) {
+        AIM_LOG_ERROR("Could not watch %s: %{errno}", gw->path, errno);
+        close(gw->fd);
+        aim_free(gw->path);
+        aim_free(gw);
+        return ONLP_STATUS_E_INTERNAL;
+    }
+
+    gw->next = w->watches;
+    w->watches = gw;
+    return 0;
+}
+
+int
+onlp_gpio_watch_file(onlp_gpio_watcher_t* w,
+                     onlp_gpio_watch_f handler, void* cookie,
+                     const char* fmt, ...)
+{
+    int rv;
+    va_list vargs;
+    va_start(vargs, fmt);
+    rv = onlp_gpio_watch_vfile(w, handler, cookie, fmt, vargs);
+    va_end(vargs);
+    return rv;
+}
+
+int
+onlp_gpio_watch_gpio(onlp_gpio_watcher_t* w, int gpio, onlp_gpio_edge_t edge,
+                     onlp_gpio_watch_f handler, void* cookie)
+{
+    int rv;
+
+    if((rv = onlp_gpio_export(gpio, ONLP_GPIO_DIRECTION_IN)) < 0) {
+        return rv;
+    }
+    if((rv = onlp_gpio_edge_set(gpio, edge)) < 0) {
+        return rv;
+    }
+    return onlp_gpio_watch_file(w, handler, cookie,
+                                SYS_CLASS_GPIO_PATH "/value", gpio);
+}
+
+int
+onlp_gpio_watcher_fd(onlp_gpio_watcher_t* w)
+{
+    return w->epfd;
+}
+
+int
+onlp_gpio_watcher_run(onlp_gpio_watcher_t* w, int timeout_ms)
+{
+    int i, n;
+    struct epoll_event events[GPIO_WATCHER_EVENTS_MAX];
+
+    n = epoll_wait(w->epfd, events, AIM_ARRAYSIZE(events), timeout_ms);
+    if(n < 0) {
+        if(errno == EINTR) {
+            return 0;
+        }
+        AIM_LOG_ERROR("epoll_wait() failed: %{errno}", errno);
+        return ONLP_STATUS_E_INTERNAL;
+    }
+
+    for(i = 0; i < n; i++) {
+        gpio_watch_t* gw = (gpio_watch_t*)events[i].data.ptr;
+        gw->handler(gw->cookie, gw->path, gpio_watch_read__(gw));
+    }
+    return n;
+}
@@ -0,0 +1,447 @@
+/************************************************************
+ * <bsn.cl fy=2014 v=onl>
+ *
+ *        Copyright 2014, 2015 Big Switch Networks, Inc.
+ *
+ * Licensed under the Eclipse Public License, Version 1.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ *        http://www.eclipse.org/legal/epl-v10.html
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the
+ * License.
+ *
+ * </bsn.cl>
+ ************************************************************
+ *
+ *
+ *
+ ***********************************************************/
+#include <onlplib/hwmon.h>
+#include <onlplib/file.h>
+#include <onlp/onlp.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "onlplib_log.h"
+
+typedef enum hwmon_psu_e {
+    HWMON_PSU_VIN,
+    HWMON_PSU_VOUT,
+    HWMON_PSU_IIN,
+    HWMON_PSU_IOUT,
+    HWMON_PSU_PIN,
+    HWMON_PSU_POUT,
+    HWMON_PSU_COUNT,
+} hwmon_psu_t;
+
+static const struct {
+    const char* class;
+    int index;
+    const char* labels[2];
+    uint32_t caps;
+} hwmon_psu_map__[HWMON_PSU_COUNT] = {
+    [HWMON_PSU_VIN]  = { "in",    1, { "vin",  NULL },    ONLP_PSU_CAPS_VIN },
+    [HWMON_PSU_VOUT] = { "in",    2, { "vout1", "vout" }, ONLP_PSU_CAPS_VOUT },
+    [HWMON_PSU_IIN]  = { "curr",  1, { "iin",  NULL },    ONLP_PSU_CAPS_IIN },
+    [HWMON_PSU_IOUT] = { "curr",  2, { "iout1", "iout" }, ONLP_PSU_CAPS_IOUT },
+    [HWMON_PSU_PIN]  = { "power", 1, { "pin",  NULL },    ONLP_PSU_CAPS_PIN },
+    [HWMON_PSU_POUT] = { "power", 2, { "pout1", "pout" }, ONLP_PSU_CAPS_POUT },
+};
+
+static const char* hwmon_classes__[] = {
+    "in", "curr", "power", "temp", "fan", "humidity",
+};
+
+static const char* hwmon_kinds__[] = {
+    "input", "min", "max", "crit", "emergency",
+};
+
+typedef struct hwmon_attr_s {
+    char name[32];
+    /* The directory holding the attribute, hw->path or hw->device. */
+    const char* dir;
+    const char* class;
+    int index;
+    int fd;
+    int status;
+    int value;
+} hwmon_attr_t;
+
+struct onlp_hwmon_s {
+    /* The directory given at open. */
+    char* device;
+    /* The hwmon directory, and its inode to detect recreation. */
+    char* path;
+    ino_t ino;
+
+    int count;
+    hwmon_attr_t attrs[ONLPLIB_CONFIG_HWMON_ATTRIBUTES_MAX];
+
+    /* Attribute indices for the PSU measurements, or -1. */
+    int psu[HWMON_PSU_COUNT];
+};
+
+/*
+ * Split "<class><index>_<kind>". Only sensor classes and
+ * measurement kinds are accepted.
+ */
+static int
+hwmon_attr_parse__(const char* name, const char** class, int* index)
+{
+    int i;
+    const char* p;
+    char* end;
+
+    for(i = 0; i < AIM_ARRAYSIZE(hwmon_classes__); i++) {
+        int len = strlen(hwmon_classes__[i]);
+        if(!strncmp(name, hwmon_classes__[i], len) &&
+           name[len] >= '0' && name[len] <= '9') {
+            *class = hwmon_classes__[i];
+            *index = strtol(name + len, &end, 10);
+            break;
+        }
+    }
+    if(i == AIM_ARRAYSIZE(hwmon_classes__) || *end != '_') {
+        return 0;
+    }
+    p = end + 1;
+    for(i = 0; i < AIM_ARRAYSIZE(hwmon_kinds__); i++) {
+        if(!strcmp(p, hwmon_kinds__[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int
+hwmon_attr_find__(onlp_hwmon_t* hw, const char* name)
+{
+    int i;
+    for(i = 0; i < hw->count; i++) {
+        if(!strcmp(hw->attrs[i].name, name)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void
+hwmon_psu_map_build__(onlp_hwmon_t* hw)
+{
+    int i, m, l;
+    int labeled = 0;
+    char name[64];
+    char label[32];
+
+    for(m = 0; m < HWMON_PSU_COUNT; m++) {
+        hw->psu[m] = -1;
+    }
+
+    /* Labels are read once. They do not change while the device exists. */
+    for(i = 0; i < hw->count; i++) {
+        hwmon_attr_t* a = hw->attrs + i;
+        int len = 0;
+
+        if(strcmp(strchr(a->name, '_'), "_input")) {
+            continue;
+        }
+        snprintf(name, sizeof(name), "%s%d_label", a->class, a->index);
+        memset(label, 0, sizeof(label));
+        if(onlp_file_read((uint8_t*)label, sizeof(label) - 1, &len, "%s/%s",
+                          a->dir, name) < 0) {
+            continue;
+        }
+        labeled = 1;
+        while(len > 0 && (label[len-1] == '\n' || label[len-1] == ' ')) {
+            label[--len] = 0;
+        }
+        for(m = 0; m < HWMON_PSU_COUNT; m++) {
+            if(strcmp(a->class, hwmon_psu_map__[m].class)) {
+                continue;
+            }
+            for(l = 0; l < AIM_ARRAYSIZE(hwmon_psu_map__[m].labels); l++) {
+                if(hwmon_psu_map__[m].labels[l] &&
+                   !strcmp(label, hwmon_psu_map__[m].labels[l]) &&
+                   hw->psu[m] == -1) {
+                    hw->psu[m] = i;
+                }
+            }
+        }
+    }
+
+    if(!labeled) {
+        for(m = 0; m < HWMON_PSU_COUNT; m++) {
+            snprintf(name, sizeof(name), "%s%d_input",
+                     hwmon_psu_map__[m].class, hwmon_psu_map__[m].index);
+            hw->psu[m] = hwmon_attr_find__(hw, name);
+        }
+    }
+}
+
+static void
+hwmon_attrs_close__(onlp_hwmon_t* hw)
+{
+    int i;
+    for(i = 0; i < hw->count; i++) {
+        close(hw->attrs[i].fd);
+    }
+    hw->count = 0;
+    aim_free(hw->path);
+    hw->path = NULL;
+}
+
+/*
+ * Open the sensor attributes in one directory, skipping any
+ * already opened from another.
+ */
+static void
+hwmon_attrs_scan__(onlp_hwmon_t* hw, const char* path)
+{
+    DIR* dir;
+    struct dirent* de;
+
+    if((dir = opendir(path)) == NULL) {
+        return;
+    }
+    while((de = readdir(dir)) != NULL) {
+        hwmon_attr_t* a;
+        const char* class;
+        int index, fd;
+
+        if(strlen(de->d_name) >= sizeof(a->name) ||
+           !hwmon_attr_parse__(de->d_name, &class, &index) ||
+           hwmon_attr_find__(hw, de->d_name) >= 0) {
+            continue;
+        }
+        if(hw->count == AIM_ARRAYSIZE(hw->attrs)) {
+            AIM_LOG_WARN("%s: too many attributes.", path);
+            break;
+        }
+        if((fd = openat(dirfd(dir), de->d_name, O_RDONLY)) < 0) {
+            /* Write-only attributes. */
+            continue;
+        }
+        a = hw->attrs + hw->count++;
+        strcpy(a->name, de->d_name);
+        a->dir = path;
+        a->class = class;
+        a->index = index;
+        a->fd = fd;
+        a->status = ONLP_STATUS_E_MISSING;
+        a->value = 0;
+    }
+    closedir(dir);
+}
+
+/*
+ * Resolve the hwmon directory and open its attributes.
+ */
+static int
+hwmon_attrs_open__(onlp_hwmon_t* hw)
+{
+    DIR* dir;
+    struct dirent* de;
+    struct stat st;
+    char* sub = aim_fstrdup("%s/hwmon", hw->device);
+
+    /* A parent device has a single hwmon/hwmonN child. */
+    if((dir = opendir(sub)) != NULL) {
+        while((de = readdir(dir)) != NULL) {
+            if(!strncmp(de->d_name, "hwmon", 5)) {
+                hw->path = aim_fstrdup("%s/%s", sub, de->d_name);
+                break;
+            }
+        }
+        closedir(dir);
+    }
+    aim_free(sub);
+    if(hw->path == NULL) {
+        hw->path = aim_strdup(hw->device);
+    }
+
+    if(stat(hw->path, &st) < 0 || !S_ISDIR(st.st_mode)) {
+        aim_free(hw->path);
+        hw->path = NULL;
+        return ONLP_STATUS_E_MISSING;
+    }
+    hw->ino = st.st_ino;
+
+    hwmon_attrs_scan__(hw, hw->path);
+    if(strcmp(hw->path, hw->device)) {
+        /*
+         * Older drivers register an empty hwmonN child and keep
+         * their attributes on the parent device.
+         */
+        hwmon_attrs_scan__(hw, hw->device);
+    }
+
+    hwmon_psu_map_build__(hw);
+    return 0;
+}
+
+int
+onlp_hwmon_vopen(onlp_hwmon_t** rv, const char* fmt, va_list vargs)
+{
+    int rc;
+    onlp_hwmon_t* hw = aim_zmalloc(sizeof(*hw));
+
+    hw->device = aim_vfstrdup(fmt, vargs);
+    if((rc = hwmon_attrs_open__(hw)) < 0) {
+        aim_free(hw->device);
+        aim_free(hw);
+        return rc;
+    }
+    *rv = hw;
+    return 0;
+}
+
+int
+onlp_hwmon_open(onlp_hwmon_t** rv, const char* fmt, ...)
+{
+    int rc;
+    va_list vargs;
+    va_start(vargs, fmt);
+    rc = onlp_hwmon_vopen(rv, fmt, vargs);
+    va_end(vargs);
+    return rc;
+}
+
+void
+onlp_hwmon_close(onlp_hwmon_t* hw)
+{
+    if(hw) {
+        hwmon_attrs_close__(hw);
+        aim_free(hw->device);
+        aim_free(hw);
+    }
+}
+
+int
+onlp_hwmon_sample(onlp_hwmon_t* hw)
+{
+    int i;
+    int missing = 0;
+    struct stat st;
+
+    if(hw->path == NULL || stat(hw->path, &st) < 0 || st.st_ino != hw->ino) {
+        /* The device was removed, and possibly recreated. */
+        hwmon_attrs_close__(hw);
+        if(hwmon_attrs_open__(hw) < 0) {
+            return ONLP_STATUS_E_MISSING;
+        }
+    }
+
+    for(i = 0; i < hw->count; i++) {
+        hwmon_attr_t* a = hw->attrs + i;
+        char buf[32];
+        ssize_t n = pread(a->fd, buf, sizeof(buf) - 1, 0);
+
+        if(n <= 0) {
+            if(n < 0 && (errno == ENODEV || errno == ENXIO)) {
+                missing++;
+            }
+            a->status = ONLP_STATUS_E_INTERNAL;
+            continue;
+        }
+        buf[n] = 0;
+        a->value = strtol(buf, NULL, 0);
+        a->status = 0;
+    }
+
+    if(hw->count && missing == hw->count) {
+        hwmon_attrs_close__(hw);
+        return ONLP_STATUS_E_MISSING;
+    }
+    return 0;
+}
+
+int
+onlp_hwmon_value_get(onlp_hwmon_t* hw, const char* name, int* value)
+{
+    int i = hwmon_attr_find__(hw, name);
+
+    if(i < 0) {
+        return ONLP_STATUS_E_MISSING;
+    }
+    if(hw->attrs[i].status == 0) {
+        *value = hw->attrs[i].value;
+    }
+    return hw->attrs[i].status;
+}
+
+int
+onlp_hwmon_psu_info_get(onlp_hwmon_t* hw, onlp_psu_info_t* info)
+{
+    int m;
+    int* values[HWMON_PSU_COUNT] = {
+        &info->mvin, &info->mvout, &info->miin, &info->miout,
+        &info->mpin, &info->mpout,
+    };
+
+    if(hw->path == NULL) {
+        return ONLP_STATUS_E_MISSING;
+    }
+
+    for(m = 0; m < HWMON_PSU_COUNT; m++) {
+        hwmon_attr_t* a;
+        if(hw->psu[m] < 0) {
+            continue;
+        }
+        a = hw->attrs + hw->psu[m];
+        if(a->status < 0) {
+            continue;
+        }
+        info->caps |= hwmon_psu_map__[m].caps;
+        /* hwmon power is in microwatts. */
+        *values[m] = strcmp(a->class, "power") ? a->value : a->value / 1000;
+    }
+    return 0;
+}
+
+int
+onlp_hwmon_thermal_info_get(onlp_hwmon_t* hw, int index,
+                            onlp_thermal_info_t* info)
+{
+    int i;
+    char name[32];
+    static const struct {
+        const char* kind;
+        uint32_t caps;
+    } thresholds[] = {
+        { "max", ONLP_THERMAL_CAPS_GET_WARNING_THRESHOLD },
+        { "crit", ONLP_THERMAL_CAPS_GET_ERROR_THRESHOLD },
+        { "emergency", ONLP_THERMAL_CAPS_GET_SHUTDOWN_THRESHOLD },
+    };
+    int* values[] = {
+        &info->thresholds.warning, &info->thresholds.error,
+        &info->thresholds.shutdown,
+    };
+
+    snprintf(name, sizeof(name), "temp%d_input", index);
+    if(hw->path == NULL || (i = hwmon_attr_find__(hw, name)) < 0) {
+        return ONLP_STATUS_E_MISSING;
+    }
+    if(hw->attrs[i].status < 0) {
+        return hw->attrs[i].status;
+    }
+    info->mcelsius = hw->attrs[i].value;
+    info->status |= ONLP_THERMAL_STATUS_PRESENT;
+    info->caps |= ONLP_THERMAL_CAPS_GET_TEMPERATURE;
+
+    for(i = 0; i < AIM_ARRAYSIZE(thresholds); i++) {
+        snprintf(name, sizeof(name), "temp%d_%s", index, thresholds[i].kind);
+        if(onlp_hwmon_value_get(hw, name, values[i]) == 0) {
+            info->caps |= thresholds[i].caps;
+        }
+    }
+    return 0;
+}
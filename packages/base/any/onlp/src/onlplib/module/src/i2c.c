@@ -28,60 +28,410 @@
 
 #include <onlplib/file.h>
 #include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include <sys/types.h>
 #include <sys/ioctl.h>
 #include <errno.h>
+#include <pthread.h>
+#include <AIM/aim_time.h>
 #include <onlp/onlp.h>
+#if ONLPLIB_CONFIG_I2C_USE_CUSTOM_HEADER == 0 && ONLPLIB_CONFIG_I2C_INCLUDE_SMBUS == 0
+#include <linux/i2c.h>
+#endif
 #include "onlplib_log.h"
 
+/**
+ * The descriptor mode flags which must be reprogrammed when changed.
+ */
+#define I2C_MODE_FLAGS (ONLP_I2C_F_TENBIT | ONLP_I2C_F_PEC | ONLP_I2C_F_FORCE)
+
+/**
+ * Mode value used when the descriptor state is unknown.
+ */
+#define I2C_MODE_UNKNOWN 0xFFFFFFFF
+
+/**
+ * @brief Program the descriptor for the given slave address and flags.
+ * @param fd The i2c device descriptor.
+ * @param bus The i2c bus number (for logging).
+ * @param addr The slave address.
+ * @param flags See ONLP_I2C_F_*
+ * @param caddr The slave address currently programmed, or -1 if unknown.
+ * @param cmode The mode flags currently programmed, or I2C_MODE_UNKNOWN.
+ * @note Only the settings which differ from the current state are written.
+ */
+static int
+i2c_setup__(int fd, int bus, uint8_t addr, uint32_t flags,
+            int caddr, uint32_t cmode)
+{
+    int rv;
+    uint32_t mode = flags & I2C_MODE_FLAGS;
+
+    /* Set 10 or 7 bit mode */
+    if(cmode == I2C_MODE_UNKNOWN || ((cmode ^ mode) & ONLP_I2C_F_TENBIT)) {
+        rv = ioctl(fd, I2C_TENBIT, (flags & ONLP_I2C_F_TENBIT) ? 1 : 0);
+        if(rv == -1) {
+            AIM_LOG_ERROR("i2c-%d: failed to set %d bit mode", bus,
+                          (flags & ONLP_I2C_F_TENBIT) ? 10 : 7);
+            return ONLP_STATUS_E_I2C;
+        }
+    }
+
+    /* Enable/Disable PEC */
+    if(cmode == I2C_MODE_UNKNOWN || ((cmode ^ mode) & ONLP_I2C_F_PEC)) {
+        rv = ioctl(fd, I2C_PEC, (flags & ONLP_I2C_F_PEC) ? 1 : 0);
+        if(rv == -1) {
+            AIM_LOG_ERROR("i2c-%d: failed to set PEC mode %d", bus,
+                          (flags & ONLP_I2C_F_PEC) ? 1 : 0);
+            return ONLP_STATUS_E_I2C;
+        }
+    }
+
+    /* Set SLAVE or SLAVE_FORCE address */
+    if(cmode == I2C_MODE_UNKNOWN || caddr != addr ||
+       ((cmode ^ mode) & ONLP_I2C_F_FORCE)) {
+        rv = ioctl(fd,
+                   (flags & ONLP_I2C_F_FORCE) ? I2C_SLAVE_FORCE : I2C_SLAVE,
+                   addr);
+
+        if(rv == -1) {
+            AIM_LOG_ERROR("i2c-%d: %s slave address 0x%x failed: %{errno}",
+                          bus,
+                          (flags & ONLP_I2C_F_FORCE) ? "forcing" : "setting",
+                          addr,
+                          errno);
+            return ONLP_STATUS_E_I2C;
+        }
+    }
+
+    return 0;
+}
+
 int
 onlp_i2c_open(int bus, uint8_t addr, uint32_t flags)
 {
     int fd;
-    int rv;
 
     fd = onlp_file_open(O_RDWR, 1, "/dev/i2c-%d", bus);
     if(fd < 0) {
         return fd;
     }
 
-    /* Set 10 or 7 bit mode */
-    rv = ioctl(fd, I2C_TENBIT, (flags & ONLP_I2C_F_TENBIT) ? 1 : 0);
-    if(rv == -1) {
-        AIM_LOG_ERROR("i2c-%d: failed to set %d bit mode", bus,
-                      (flags & ONLP_I2C_F_TENBIT) ? 10 : 7);
-        goto error;
+    if(i2c_setup__(fd, bus, addr, flags, -1, I2C_MODE_UNKNOWN) < 0) {
+        close(fd);
+        return ONLP_STATUS_E_I2C;
     }
 
-    /* Enable/Disable PEC */
-    rv = ioctl(fd, I2C_PEC, (flags & ONLP_I2C_F_PEC) ? 1 : 0);
-    if(rv == -1) {
-        AIM_LOG_ERROR("i2c-%d: failed to set PEC mode %d", bus,
-                      (flags & ONLP_I2C_F_PEC) ? 1 : 0);
-        goto error;
+    return fd;
+}
+
+
+/****************************************************************************
+ *
+ * Per-bus descriptor cache.
+ *
+ * Each bus keeps a single open descriptor along with the slave address
+ * and mode last programmed into it. Transactions on the same bus are
+ * serialized on the bus lock and only reprogram the descriptor when the
+ * slave address or mode changes. Any transaction failure closes the
+ * descriptor so the next access starts from a clean open().
+ *
+ ***************************************************************************/
+typedef struct i2c_bus_s {
+    pthread_mutex_t lock;
+    int fd;
+    int addr;
+    uint32_t mode;
+    unsigned long funcs;
+} i2c_bus_t;
+
+#if ONLPLIB_CONFIG_INCLUDE_I2C_FD_CACHE == 1
+
+static i2c_bus_t i2c_buses__[ONLPLIB_CONFIG_I2C_FD_CACHE_SIZE];
+static pthread_once_t i2c_buses_once__ = PTHREAD_ONCE_INIT;
+
+static void
+i2c_buses_init__(void)
+{
+    int i;
+    for(i = 0; i < AIM_ARRAYSIZE(i2c_buses__); i++) {
+        pthread_mutex_init(&i2c_buses__[i].lock, NULL);
+        i2c_buses__[i].fd = -1;
+        i2c_buses__[i].addr = -1;
+        i2c_buses__[i].mode = I2C_MODE_UNKNOWN;
+        i2c_buses__[i].funcs = 0;
     }
+}
 
-    /* Set SLAVE or SLAVE_FORCE address */
-    rv = ioctl(fd,
-               (flags & ONLP_I2C_F_FORCE) ? I2C_SLAVE_FORCE : I2C_SLAVE,
-               addr);
+static void
+i2c_bus_invalidate__(i2c_bus_t* b)
+{
+    if(b->fd >= 0) {
+        close(b->fd);
+    }
+    b->fd = -1;
+    b->addr = -1;
+    b->mode = I2C_MODE_UNKNOWN;
+    b->funcs = 0;
+}
+
+#endif /* ONLPLIB_CONFIG_INCLUDE_I2C_FD_CACHE */
+
+/**
+ * @brief Open (or reuse) the descriptor for the given bus.
+ * @param bus The i2c bus number.
+ * @param rb [out] Receives the cached bus entry, or NULL if uncached.
+ * @returns The descriptor, or < 0 on error.
+ * @note The slave address is not programmed.
+ * Every successful open must be matched by i2c_bus_release__().
+ */
+static int
+i2c_bus_open__(int bus, i2c_bus_t** rb)
+{
+    *rb = NULL;
+
+#if ONLPLIB_CONFIG_INCLUDE_I2C_FD_CACHE == 1
+    if(bus >= 0 && bus < AIM_ARRAYSIZE(i2c_buses__)) {
+        i2c_bus_t* b = i2c_buses__ + bus;
+
+        pthread_once(&i2c_buses_once__, i2c_buses_init__);
+        pthread_mutex_lock(&b->lock);
+
+        if(b->fd < 0) {
+            b->fd = onlp_file_open(O_RDWR, 1, "/dev/i2c-%d", bus);
+            if(b->fd < 0) {
+                int rv = b->fd;
+                i2c_bus_invalidate__(b);
+                pthread_mutex_unlock(&b->lock);
+                return rv;
+            }
+        }
+        *rb = b;
+        return b->fd;
+    }
+#endif
+
+    return onlp_file_open(O_RDWR, 1, "/dev/i2c-%d", bus);
+}
+
+static void i2c_bus_release__(i2c_bus_t* b, int fd, int error);
 
-    if(rv == -1) {
-        AIM_LOG_ERROR("i2c-%d: %s slave address 0x%x failed: %{errno}",
-                      bus,
-                      (flags & ONLP_I2C_F_FORCE) ? "forcing" : "setting",
-                      addr,
-                      errno);
-        goto error;
+/**
+ * @brief Acquire a descriptor for the given bus and slave address.
+ * @param bus The i2c bus number.
+ * @param addr The slave address.
+ * @param flags See ONLP_I2C_F_*
+ * @param rb [out] Receives the cached bus entry, or NULL if uncached.
+ * @returns The descriptor, or < 0 on error.
+ * @note Every successful acquire must be matched by i2c_bus_release__().
+ */
+static int
+i2c_bus_acquire__(int bus, uint8_t addr, uint32_t flags, i2c_bus_t** rb)
+{
+    int fd = i2c_bus_open__(bus, rb);
+
+    if(fd < 0) {
+        return fd;
+    }
+
+    if(*rb) {
+        if(i2c_setup__(fd, bus, addr, flags, (*rb)->addr, (*rb)->mode) < 0) {
+            i2c_bus_release__(*rb, fd, 1);
+            return ONLP_STATUS_E_I2C;
+        }
+        (*rb)->addr = addr;
+        (*rb)->mode = flags & I2C_MODE_FLAGS;
+    }
+    else if(i2c_setup__(fd, bus, addr, flags, -1, I2C_MODE_UNKNOWN) < 0) {
+        close(fd);
+        return ONLP_STATUS_E_I2C;
     }
 
     return fd;
+}
 
- error:
+/**
+ * @brief Release a descriptor returned by i2c_bus_acquire__().
+ * @param b The cached bus entry (or NULL).
+ * @param fd The descriptor.
+ * @param error Nonzero if the transaction failed.
+ */
+static void
+i2c_bus_release__(i2c_bus_t* b, int fd, int error)
+{
+#if ONLPLIB_CONFIG_INCLUDE_I2C_FD_CACHE == 1
+    if(b) {
+        if(error) {
+            i2c_bus_invalidate__(b);
+        }
+        pthread_mutex_unlock(&b->lock);
+        return;
+    }
+#endif
     close(fd);
-    return ONLP_STATUS_E_I2C;
+}
+
+void
+onlp_i2c_cache_flush(int bus)
+{
+#if ONLPLIB_CONFIG_INCLUDE_I2C_FD_CACHE == 1
+    int i;
+
+    pthread_once(&i2c_buses_once__, i2c_buses_init__);
+
+    for(i = 0; i < AIM_ARRAYSIZE(i2c_buses__); i++) {
+        if(bus < 0 || bus == i) {
+            pthread_mutex_lock(&i2c_buses__[i].lock);
+            i2c_bus_invalidate__(i2c_buses__ + i);
+            pthread_mutex_unlock(&i2c_buses__[i].lock);
+        }
+    }
+#endif
+}
+
+int
+onlp_i2c_bus_root(int bus)
+{
+    int root = -1;
+    char link[64];
+    char path[PATH_MAX];
+    char* p;
+    char* save = NULL;
+
+    snprintf(link, sizeof(link), "/sys/bus/i2c/devices/i2c-%d", bus);
+    if(realpath(link, path) == NULL) {
+        return ONLP_STATUS_E_MISSING;
+    }
+
+    /*
+     * Mux channels are children of their parent adapter, e.g.
+     * /sys/devices/pci0000:00/0000:00:1f.3/i2c-0/i2c-2/i2c-25.
+     * The first adapter in the path is the root.
+     */
+    for(p = strtok_r(path, "/", &save); p; p = strtok_r(NULL, "/", &save)) {
+        if(sscanf(p, "i2c-%d", &root) == 1) {
+            return root;
+        }
+    }
+    return ONLP_STATUS_E_MISSING;
+}
+
+/**
+ * @brief Determine whether the adapter supports plain i2c transfers.
+ * @param b The cached bus entry (or NULL).
+ * @param fd The descriptor.
+ */
+static int
+i2c_rdwr_supported__(i2c_bus_t* b, int fd)
+{
+    unsigned long funcs = 0;
+
+    if(b && b->funcs) {
+        funcs = b->funcs;
+    }
+    else if(ioctl(fd, I2C_FUNCS, &funcs) < 0) {
+        return 0;
+    }
+
+    if(b) {
+        b->funcs = funcs;
+    }
+    return (funcs & I2C_FUNC_I2C) ? 1 : 0;
+}
+
+static int
+i2c_transfer__(int bus, i2c_bus_t* b, int fd,
+               onlp_i2c_msg_t* msgs, int count, uint32_t flags)
+{
+    int i;
+    struct i2c_msg kmsgs[ONLP_I2C_TRANSFER_MAX_MSGS];
+    struct i2c_rdwr_ioctl_data rdwr;
+
+    if(!i2c_rdwr_supported__(b, fd)) {
+        return ONLP_STATUS_E_UNSUPPORTED;
+    }
+
+    for(i = 0; i < count; i++) {
+        kmsgs[i].addr = msgs[i].addr;
+        kmsgs[i].flags = 0;
+        if(msgs[i].flags & ONLP_I2C_MSG_F_READ) {
+            kmsgs[i].flags |= I2C_M_RD;
+        }
+        if(flags & ONLP_I2C_F_TENBIT) {
+            kmsgs[i].flags |= I2C_M_TEN;
+        }
+        kmsgs[i].len = msgs[i].len;
+        kmsgs[i].buf = msgs[i].buf;
+    }
+
+    rdwr.msgs = kmsgs;
+    rdwr.nmsgs = count;
+
+    int retries = (flags & ONLP_I2C_F_DISABLE_READ_RETRIES) ? 1 : ONLPLIB_CONFIG_I2C_READ_RETRY_COUNT;
+    int rv = -1;
+    while(retries-- && rv < 0) {
+        rv = ioctl(fd, I2C_RDWR, &rdwr);
+        if(rv < 0 && (errno == EOPNOTSUPP || errno == EINVAL)) {
+            /* The adapter cannot perform this transfer. Don't retry. */
+            return ONLP_STATUS_E_UNSUPPORTED;
+        }
+    }
+
+    if(rv != count) {
+        AIM_LOG_ERROR("i2c-%d: transfer of %d messages (first address 0x%x) failed: %{errno}",
+                      bus, count, msgs[0].addr, errno);
+        return ONLP_STATUS_E_I2C;
+    }
+    return 0;
+}
+
+int
+onlp_i2c_transfer(int bus, onlp_i2c_msg_t* msgs, int count, uint32_t flags)
+{
+    int fd;
+    int rv;
+    i2c_bus_t* b;
+
+    if(msgs == NULL || count <= 0 || count > ONLP_I2C_TRANSFER_MAX_MSGS) {
+        return ONLP_STATUS_E_PARAM;
+    }
+
+    fd = i2c_bus_open__(bus, &b);
+    if(fd < 0) {
+        return fd;
+    }
+
+    rv = i2c_transfer__(bus, b, fd, msgs, count, flags);
+
+    i2c_bus_release__(b, fd, rv == ONLP_STATUS_E_I2C);
+    return rv;
+}
+
+int
+onlp_i2c_rdwr_read(int bus, uint8_t addr, uint8_t offset, int size,
+                   uint8_t* rdata, uint32_t flags)
+{
+    onlp_i2c_msg_t msgs[2];
+
+    if(size <= 0 || size > ONLP_I2C_TRANSFER_MAX_LEN) {
+        return ONLP_STATUS_E_PARAM;
+    }
+
+    msgs[0].addr = addr;
+    msgs[0].flags = 0;
+    msgs[0].len = 1;
+    msgs[0].buf = &offset;
+
+    msgs[1].addr = addr;
+    msgs[1].flags = ONLP_I2C_MSG_F_READ;
+    msgs[1].len = size;
+    msgs[1].buf = rdata;
+
+    return onlp_i2c_transfer(bus, msgs, 2, flags);
 }
 
 int
@@ -89,8 +439,16 @@ onlp_i2c_block_read(int bus, uint8_t addr, uint8_t offset, int size,
                     uint8_t* rdata, uint32_t flags)
 {
     int fd;
+    i2c_bus_t* b;
+
+    if(flags & ONLP_I2C_F_USE_RDWR) {
+        int rv = onlp_i2c_rdwr_read(bus, addr, offset, size, rdata, flags);
+        if(rv != ONLP_STATUS_E_UNSUPPORTED) {
+            return rv;
+        }
+    }
 
-    fd = onlp_i2c_open(bus, addr, flags);
+    fd = i2c_bus_acquire__(bus, addr, flags, &b);
 
     if(fd < 0) {
         return fd;
@@ -127,11 +485,11 @@ onlp_i2c_block_read(int bus, uint8_t addr, uint8_t offset, int size,
         count -= rsize;
     }
 
-    close(fd);
+    i2c_bus_release__(b, fd, 0);
     return 0;
 
  error:
-    close(fd);
+    i2c_bus_release__(b, fd, 1);
     return ONLP_STATUS_E_I2C;
 }
 
@@ -141,8 +499,16 @@ onlp_i2c_read(int bus, uint8_t addr, uint8_t offset, int size,
 {
     int i;
     int fd;
+    i2c_bus_t* b;
 
-    fd = onlp_i2c_open(bus, addr, flags);
+    if(flags & ONLP_I2C_F_USE_RDWR) {
+        int rv = onlp_i2c_rdwr_read(bus, addr, offset, size, rdata, flags);
+        if(rv != ONLP_STATUS_E_UNSUPPORTED) {
+            return rv;
+        }
+    }
+
+    fd = i2c_bus_acquire__(bus, addr, flags, &b);
 
     if(fd < 0) {
         return fd;
@@ -165,11 +531,11 @@ onlp_i2c_read(int bus, uint8_t addr, uint8_t offset, int size,
             rdata[i] = rv;
         }
     }
-    close(fd);
+    i2c_bus_release__(b, fd, 0);
     return 0;
 
  error:
-    close(fd);
+    i2c_bus_release__(b, fd, 1);
     return ONLP_STATUS_E_I2C;
 }
 
@@ -180,8 +546,9 @@ onlp_i2c_write(int bus, uint8_t addr, uint8_t offset, int size,
 {
     int i;
     int fd;
+    i2c_bus_t* b;
 
-    fd = onlp_i2c_open(bus, addr, flags);
+    fd = i2c_bus_acquire__(bus, addr, flags, &b);
 
     if(fd < 0) {
         return fd;
@@ -195,11 +562,11 @@ onlp_i2c_write(int bus, uint8_t addr, uint8_t offset, int size,
             goto error;
         }
     }
-    close(fd);
+    i2c_bus_release__(b, fd, 0);
     return 0;
 
  error:
-    close(fd);
+    i2c_bus_release__(b, fd, 1);
     return ONLP_STATUS_E_I2C;
 }
 
@@ -235,8 +602,9 @@ onlp_i2c_readw(int bus, uint8_t addr, uint8_t offset, uint32_t flags)
 {
     int fd;
     int rv;
+    i2c_bus_t* b;
 
-    fd = onlp_i2c_open(bus, addr, flags);
+    fd = i2c_bus_acquire__(bus, addr, flags, &b);
 
     if(fd < 0) {
         return fd;
@@ -244,7 +612,7 @@ onlp_i2c_readw(int bus, uint8_t addr, uint8_t offset, uint32_t flags)
 
     rv = i2c_smbus_read_word_data(fd, offset);
 
-    close(fd);
+    i2c_bus_release__(b, fd, rv < 0);
     return rv;
 }
 
@@ -254,8 +622,9 @@ onlp_i2c_writew(int bus, uint8_t addr, uint8_t offset, uint16_t word,
 {
     int fd;
     int rv;
+    i2c_bus_t* b;
 
-    fd = onlp_i2c_open(bus, addr, flags);
+    fd = i2c_bus_acquire__(bus, addr, flags, &b);
 
     if(fd < 0) {
         return fd;
@@ -263,36 +632,218 @@ onlp_i2c_writew(int bus, uint8_t addr, uint8_t offset, uint16_t word,
 
     rv = i2c_smbus_write_word_data(fd, offset, word);
 
-    close(fd);
+    i2c_bus_release__(b, fd, rv < 0);
     return rv;
 
 }
 
-int
-onlp_i2c_mux_select(onlp_i2c_mux_device_t* dev, int channel)
+/****************************************************************************
+ *
+ * Mux channel tracking.
+ *
+ * Muxes are shared by every ONLP process and thread, so the channel
+ * last written to each mux is kept in shared memory and is only read
+ * or updated while the shared mux state lock is held. Operations
+ * using ONLP_I2C_F_MUX_LAZY_DESELECT hold the lock from the channel
+ * selection until the device operation completes and skip channels
+ * which are already selected. All other selections are always
+ * written to the mux.
+ *
+ ***************************************************************************/
+typedef struct mux_state_s {
+    /** Nonzero if the entry is in use. */
+    uint32_t used;
+    int bus;
+    int devaddr;
+    int channel;
+    /** The time at which 'channel' was written, or zero if unknown. */
+    uint64_t synced;
+} mux_state_t;
+
+#if ONLPLIB_CONFIG_I2C_MUX_STATE_TTL > 0
+
+#include <onlplib/shlocks.h>
+
+#define ONLPLIB_I2C_MUX_STATE_LOCK_KEY 0xF00DF1C0
+#define ONLPLIB_I2C_MUX_STATE_KEY 0xF00DF1C1
+#define MUX_STATE_ENTRIES 256
+
+static onlp_shlock_t* mux_state_shlock__;
+static mux_state_t* mux_states__;
+static pthread_once_t mux_state_once__ = PTHREAD_ONCE_INIT;
+/* The lock is reentrant within a thread. */
+static __thread int mux_state_depth__;
+
+static void
+mux_state_init__(void)
+{
+    onlp_shlock_create(ONLPLIB_I2C_MUX_STATE_LOCK_KEY, &mux_state_shlock__,
+                       "i2c-mux-state");
+    if(onlp_shmem_create(ONLPLIB_I2C_MUX_STATE_KEY,
+                         sizeof(mux_state_t)*MUX_STATE_ENTRIES,
+                         (void**)&mux_states__) < 0) {
+        AIM_LOG_ERROR("i2c mux state tracking is unavailable.");
+        mux_states__ = NULL;
+    }
+}
+
+static void
+mux_state_lock__(void)
+{
+    pthread_once(&mux_state_once__, mux_state_init__);
+    if(mux_states__ && mux_state_depth__++ == 0) {
+        onlp_shlock_take(mux_state_shlock__);
+    }
+}
+
+static void
+mux_state_unlock__(void)
+{
+    if(mux_states__ && --mux_state_depth__ == 0) {
+        onlp_shlock_give(mux_state_shlock__);
+    }
+}
+
+/**
+ * @brief Find (or allocate) the tracked state for a mux.
+ * @note The mux state lock must be held.
+ */
+static mux_state_t*
+mux_state_get__(onlp_i2c_mux_device_t* dev)
 {
     int i;
+    mux_state_t* unused = NULL;
+
+    if(mux_states__ == NULL) {
+        return NULL;
+    }
+
+    for(i = 0; i < MUX_STATE_ENTRIES; i++) {
+        mux_state_t* ms = mux_states__ + i;
+        if(!ms->used) {
+            if(unused == NULL) {
+                unused = ms;
+            }
+        }
+        else if(ms->bus == dev->bus && ms->devaddr == dev->devaddr) {
+            return ms;
+        }
+    }
+
+    if(unused) {
+        unused->bus = dev->bus;
+        unused->devaddr = dev->devaddr;
+        unused->synced = 0;
+        unused->used = 1;
+    }
+    return unused;
+}
+
+static int
+mux_state_valid__(mux_state_t* ms, int channel)
+{
+    return (ms && ms->synced && ms->channel == channel &&
+            (aim_time_monotonic() - ms->synced) < ONLPLIB_CONFIG_I2C_MUX_STATE_TTL);
+}
+
+#else
+
+static void mux_state_lock__(void) {}
+static void mux_state_unlock__(void) {}
+static mux_state_t* mux_state_get__(onlp_i2c_mux_device_t* dev) { return NULL; }
+static int mux_state_valid__(mux_state_t* ms, int channel) { return 0; }
+
+#endif /* ONLPLIB_CONFIG_I2C_MUX_STATE_TTL */
+
+/**
+ * @brief Select a mux channel.
+ * @param lazy Skip the write if the channel is known to be selected.
+ */
+static int
+mux_select__(onlp_i2c_mux_device_t* dev, int channel, int lazy)
+{
+    int i, rv;
+    mux_state_t* ms;
+
     for(i = 0; i < AIM_ARRAYSIZE(dev->driver->channels); i++) {
         if(dev->driver->channels[i].channel == channel) {
-            AIM_LOG_VERBOSE("i2c_mux_select: Selecting channel %2d on device '%s'  [ bus=%d addr=0x%x offset=0x%x value=0x%x ]...",
-                        channel, dev->name, dev->bus, dev->devaddr,
-                        dev->driver->control, dev->driver->channels[i].value);
+            break;
+        }
+    }
+    if(i == AIM_ARRAYSIZE(dev->driver->channels)) {
+        return ONLP_STATUS_E_PARAM;
+    }
 
-            int rv = onlp_i2c_writeb(dev->bus,
-                                     dev->devaddr,
-                                     dev->driver->control,
-                                     dev->driver->channels[i].value,
-                                     0);
+    mux_state_lock__();
+    ms = mux_state_get__(dev);
 
-            if(rv < 0) {
-                AIM_LOG_ERROR("i2c_mux_select: Selecting channel %2d on device '%s'  [ bus=%d addr=0x%x offset=0x%x value=0x%x ] failed: %d",
-                              channel, dev->name, dev->bus, dev->devaddr,
-                              dev->driver->control, dev->driver->channels[i].value, rv);
-            }
-            return rv;
+    if(lazy && mux_state_valid__(ms, channel)) {
+        /* Already selected. */
+        mux_state_unlock__();
+        return 0;
+    }
+
+    AIM_LOG_VERBOSE("i2c_mux_select: Selecting channel %2d on device '%s'  [ bus=%d addr=0x%x offset=0x%x value=0x%x ]...",
+                    channel, dev->name, dev->bus, dev->devaddr,
+                    dev->driver->control, dev->driver->channels[i].value);
+
+    rv = onlp_i2c_writeb(dev->bus,
+                         dev->devaddr,
+                         dev->driver->control,
+                         dev->driver->channels[i].value,
+                         0);
+
+    if(rv < 0) {
+        AIM_LOG_ERROR("i2c_mux_select: Selecting channel %2d on device '%s'  [ bus=%d addr=0x%x offset=0x%x value=0x%x ] failed: %d",
+                      channel, dev->name, dev->bus, dev->devaddr,
+                      dev->driver->control, dev->driver->channels[i].value, rv);
+        if(ms) {
+            ms->synced = 0;
         }
     }
-    return ONLP_STATUS_E_PARAM;
+    else if(ms) {
+        ms->channel = channel;
+        ms->synced = aim_time_monotonic();
+    }
+
+    mux_state_unlock__();
+    return rv;
+}
+
+int
+onlp_i2c_mux_select(onlp_i2c_mux_device_t* dev, int channel)
+{
+    return mux_select__(dev, channel, 0);
+}
+
+int
+onlp_i2c_mux_resync(onlp_i2c_mux_device_t* dev)
+{
+    int rv;
+    int channel = -1;
+    mux_state_t* ms;
+
+    mux_state_lock__();
+    ms = mux_state_get__(dev);
+    if(ms && ms->synced) {
+        channel = ms->channel;
+    }
+    rv = mux_select__(dev, channel, 0);
+    mux_state_unlock__();
+    return rv;
+}
+
+void
+onlp_i2c_mux_invalidate(onlp_i2c_mux_device_t* dev)
+{
+    mux_state_t* ms;
+
+    mux_state_lock__();
+    ms = mux_state_get__(dev);
+    if(ms) {
+        ms->synced = 0;
+    }
+    mux_state_unlock__();
 }
 
 
@@ -317,13 +868,14 @@ onlp_i2c_mux_channel_deselect(onlp_i2c_mux_channel_t* mc)
 }
 
 
-int
-onlp_i2c_mux_channels_select(onlp_i2c_mux_channels_t* mcs)
+static int
+mux_channels_select__(onlp_i2c_mux_channels_t* mcs, int lazy)
 {
     int i;
     for(i = 0; i < AIM_ARRAYSIZE(mcs->channels); i++) {
         if(mcs->channels[i].mux) {
-            int rv = onlp_i2c_mux_channel_select(mcs->channels + i);
+            int rv = mux_select__(mcs->channels[i].mux,
+                                  mcs->channels[i].channel, lazy);
             if(rv < 0) {
                 /** Error already reported */
                 return rv;
@@ -333,6 +885,12 @@ onlp_i2c_mux_channels_select(onlp_i2c_mux_channels_t* mcs)
     return 0;
 }
 
+int
+onlp_i2c_mux_channels_select(onlp_i2c_mux_channels_t* mcs)
+{
+    return mux_channels_select__(mcs, 0);
+}
+
 
 int
 onlp_i2c_mux_channels_deselect(onlp_i2c_mux_channels_t* mcs)
@@ -375,22 +933,76 @@ onlp_i2c_dev_mux_channels_deselect(onlp_i2c_dev_t* dev)
 }
 
 
+static onlp_i2c_mux_channels_t*
+dev_mux_channels__(onlp_i2c_dev_t* dev)
+{
+    return (dev->pchannels) ? dev->pchannels : &dev->ichannels;
+}
+
+static void
+dev_mux_channels_invalidate__(onlp_i2c_dev_t* dev)
+{
+    int i;
+    onlp_i2c_mux_channels_t* mcs = dev_mux_channels__(dev);
+    for(i = 0; i < AIM_ARRAYSIZE(mcs->channels); i++) {
+        if(mcs->channels[i].mux) {
+            onlp_i2c_mux_invalidate(mcs->channels[i].mux);
+        }
+    }
+}
+
+static int
+dev_mux_lazy__(uint32_t flags)
+{
+    return ((flags & ONLP_I2C_F_MUX_LAZY_DESELECT) &&
+            !(flags & ONLP_I2C_F_NO_MUX_SELECT));
+}
+
+/**
+ * @brief Select the device's mux channels before an operation.
+ * @note Every successful call must be matched by dev_mux_channels_done__().
+ */
 static int
 dev_mux_channels_select__(onlp_i2c_dev_t* dev, uint32_t flags)
 {
+    int rv;
+
     if(flags & ONLP_I2C_F_NO_MUX_SELECT) {
         return 0;
     }
-    return onlp_i2c_dev_mux_channels_select(dev);
+    if(!dev_mux_lazy__(flags)) {
+        return onlp_i2c_dev_mux_channels_select(dev);
+    }
+
+    /* Hold the mux state until the operation completes. */
+    mux_state_lock__();
+    if( (rv = mux_channels_select__(dev_mux_channels__(dev), 1)) < 0) {
+        mux_state_unlock__();
+    }
+    return rv;
 }
 
+/**
+ * @brief Complete a device operation.
+ * @param rv The result of the operation.
+ * @returns rv, or the deselection error.
+ */
 static int
-dev_mux_channels_deselect__(onlp_i2c_dev_t* dev, uint32_t flags)
+dev_mux_channels_done__(onlp_i2c_dev_t* dev, uint32_t flags, int rv)
 {
-    if(flags & ONLP_I2C_F_NO_MUX_DESELECT) {
-        return 0;
+    int error = 0;
+
+    if(rv < 0) {
+        dev_mux_channels_invalidate__(dev);
     }
-    return onlp_i2c_dev_mux_channels_deselect(dev);
+    else if(!(flags & (ONLP_I2C_F_NO_MUX_DESELECT | ONLP_I2C_F_MUX_LAZY_DESELECT))) {
+        error = onlp_i2c_dev_mux_channels_deselect(dev);
+    }
+
+    if(dev_mux_lazy__(flags)) {
+        mux_state_unlock__();
+    }
+    return (error < 0) ? error : rv;
 }
 
 
@@ -414,14 +1026,9 @@ onlp_i2c_dev_read(onlp_i2c_dev_t* dev, uint8_t offset, int size,
     if( rv < 0 ) {
         AIM_LOG_ERROR("Device %s: read() failed: %d",
                       dev->name, rv);
-        return rv;
     }
 
-    if( (error = dev_mux_channels_deselect__(dev, flags)) < 0) {
-        return error;
-    }
-
-    return rv;
+    return dev_mux_channels_done__(dev, flags, rv);
 }
 
 
@@ -438,14 +1045,9 @@ onlp_i2c_dev_write(onlp_i2c_dev_t* dev,
     if( (rv = onlp_i2c_write(dev->bus, dev->addr, offset, size, data, flags)) < 0) {
         AIM_LOG_ERROR("Device %s: write() failed: %d",
                       dev->name, rv);
-        return rv;
     }
 
-    if( (error = dev_mux_channels_deselect__(dev, flags)) < 0) {
-        return error;
-    }
-
-    return rv;
+    return dev_mux_channels_done__(dev, flags, rv);
 }
 
 
@@ -461,14 +1063,9 @@ onlp_i2c_dev_readb(onlp_i2c_dev_t* dev, uint8_t offset, uint32_t flags)
     if( (rv = onlp_i2c_readb(dev->bus, dev->addr, offset, flags)) < 0) {
         AIM_LOG_ERROR("Device %s: readb() failed: %d",
                       dev->name, rv);
-        return rv;
-    }
-
-    if( (error = dev_mux_channels_deselect__(dev, flags)) < 0) {
-        return error;
     }
 
-    return rv;
+    return dev_mux_channels_done__(dev, flags, rv);
 }
 
 
@@ -485,14 +1082,9 @@ onlp_i2c_dev_writeb(onlp_i2c_dev_t* dev,
     if( (rv = onlp_i2c_writeb(dev->bus, dev->addr, offset, byte, flags)) < 0) {
         AIM_LOG_ERROR("Device %s: writeb() failed: %d",
                       dev->name, rv);
-        return rv;
-    }
-
-    if( (error = dev_mux_channels_deselect__(dev, flags)) < 0) {
-        return error;
     }
 
-    return rv;
+    return dev_mux_channels_done__(dev, flags, rv);
 }
 
 
@@ -509,14 +1101,9 @@ onlp_i2c_dev_readw(onlp_i2c_dev_t* dev,
     if( (rv = onlp_i2c_readw(dev->bus, dev->addr, offset, flags)) < 0) {
         AIM_LOG_ERROR("Device %s: readw() failed: %d",
                       dev->name, rv);
-        return rv;
     }
 
-    if( (error = dev_mux_channels_deselect__(dev, flags)) < 0) {
-        return error;
-    }
-
-    return rv;
+    return dev_mux_channels_done__(dev, flags, rv);
 }
 
 
@@ -533,14 +1120,9 @@ onlp_i2c_dev_writew(onlp_i2c_dev_t* dev,
     if( (rv = onlp_i2c_writew(dev->bus, dev->addr, offset, word, flags)) < 0) {
         AIM_LOG_ERROR("Device %s: writew() failed: %d",
                       dev->name, rv);
-        return rv;
     }
 
-    if( (error = dev_mux_channels_deselect__(dev, flags)) < 0) {
-        return error;
-    }
-
-    return rv;
+    return dev_mux_channels_done__(dev, flags, rv);
 }
 
 /**
@@ -0,0 +1,639 @@
+/************************************************************
+ * <bsn.cl fy=2014 v=onl>
+ *
+ *        Copyright 2014, 2015 Big Switch Networks, Inc.
+ *
+ * Licensed under the Eclipse Public License, Version 1.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *
+ *        http://www.eclipse.org/legal/epl-v10.html
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the
+ * License.
+ *
+ * </bsn.cl>
+ ************************************************************
+ *
+ *
+ *
+ ***********************************************************/
+#include <onlplib/ipmi.h>
+#include <onlp/onlp.h>
+
+#if ONLPLIB_CONFIG_INCLUDE_IPMI == 1
+
+#include <AIM/aim_time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <inttypes.h>
+#include <sys/ioctl.h>
+#include <linux/ipmi.h>
+#include "onlplib_log.h"
+
+#define IPMI_CMD_RESERVE_SDR_REPOSITORY 0x22
+#define IPMI_CMD_GET_SDR                0x23
+#define IPMI_CMD_GET_SENSOR_READING     0x2D
+
+#define IPMI_CC_RESERVATION_CANCELED    0xC5
+#define IPMI_CC_NOT_PRESENT             0xCB
+
+#define IPMI_SDR_TYPE_FULL              0x01
+#define IPMI_SDR_TYPE_COMPACT           0x02
+#define IPMI_SDR_HEADER_SIZE            5
+#define IPMI_SDR_READ_SIZE              16
+
+#define IPMI_SENSOR_READING_UNAVAILABLE 0x20
+#define IPMI_SENSOR_SCANNING_ENABLED    0x40
+
+typedef struct ipmi_sensor_s {
+    char name[17];
+    uint8_t owner;
+    uint8_t lun;
+    uint8_t number;
+
+    /* Full sensor records only. */
+    int full;
+    uint8_t format;
+    uint8_t linearization;
+    int m;
+    int b;
+    int bexp;
+    int rexp;
+
+    /* The last reading. */
+    uint64_t updated;
+    int status;
+    double value;
+} ipmi_sensor_t;
+
+static pthread_mutex_t ipmi_lock__ = PTHREAD_MUTEX_INITIALIZER;
+static char* ipmi_device__ = NULL;
+static int ipmi_fd__ = -1;
+static long ipmi_msgid__ = 0;
+
+static int ipmi_sdr_loaded__ = 0;
+/* The last failed SDR load, retried after the backoff interval. */
+static int ipmi_sdr_status__ = 0;
+static uint64_t ipmi_sdr_retry__ = 0;
+static uint64_t ipmi_sdr_backoff__ = 0;
+static int ipmi_sensor_count__ = 0;
+static ipmi_sensor_t ipmi_sensors__[ONLPLIB_CONFIG_IPMI_SENSORS_MAX];
+
+static int
+ipmi_open__(void)
+{
+    const char* path = ipmi_device__ ? ipmi_device__ : ONLPLIB_CONFIG_IPMI_DEVICE;
+
+    if(ipmi_fd__ >= 0) {
+        return 0;
+    }
+    if((ipmi_fd__ = open(path, O_RDWR)) < 0) {
+        AIM_LOG_ERROR("Could not open IPMI device %s: %{errno}", path, errno);
+        return ONLP_STATUS_E_INTERNAL;
+    }
+    return 0;
+}
+
+static void
+ipmi_close__(void)
+{
+    if(ipmi_fd__ >= 0) {
+        close(ipmi_fd__);
+        ipmi_fd__ = -1;
+    }
+    ipmi_sdr_loaded__ = 0;
+    ipmi_sdr_backoff__ = 0;
+    ipmi_sensor_count__ = 0;
+}
+
+/*
+ * Send a request and wait for its response.
+ * Returns the response data length, or negative on error.
+ * The completion code is returned separately.
+ */
+static int
+ipmi_send__(uint8_t owner, uint8_t lun, uint8_t netfn, uint8_t cmd,
+            const uint8_t* req, int req_len,
+            uint8_t* rsp, int rsp_len, uint8_t* cc)
+{
+    int rv;
+    uint64_t deadline;
+    struct ipmi_req r;
+    struct ipmi_system_interface_addr bmc;
+    struct ipmi_ipmb_addr ipmb;
+
+    if((rv = ipmi_open__()) < 0) {
+        return rv;
+    }
+
+    memset(&r, 0, sizeof(r));
+    if(owner == 0 || owner == IPMI_BMC_SLAVE_ADDR) {
+        memset(&bmc, 0, sizeof(bmc));
+        bmc.addr_type = IPMI_SYSTEM_INTERFACE_ADDR_TYPE;
+        bmc.channel = IPMI_BMC_CHANNEL;
+        bmc.lun = lun;
+        r.addr = (unsigned char*)&bmc;
+        r.addr_len = sizeof(bmc);
+    }
+    else {
+        /* Sensors owned by satellite controllers. */
+        memset(&ipmb, 0, sizeof(ipmb));
+        ipmb.addr_type = IPMI_IPMB_ADDR_TYPE;
+        ipmb.channel = 0;
+        ipmb.slave_addr = owner;
+        ipmb.lun = lun;
+        r.addr = (unsigned char*)&ipmb;
+        r.addr_len = sizeof(ipmb);
+    }
+    r.msgid = ++ipmi_msgid__;
+    r.msg.netfn = netfn;
+    r.msg.cmd = cmd;
+    r.msg.data = (unsigned char*)req;
+    r.msg.data_len = req_len;
+
+    if(ioctl(ipmi_fd__, IPMICTL_SEND_COMMAND, &r) < 0) {
+        AIM_LOG_ERROR("IPMI send (netfn 0x%x cmd 0x%x) failed: %{errno}",
+                      netfn, cmd, errno);
+        return ONLP_STATUS_E_INTERNAL;
+    }
+
+    deadline = aim_time_monotonic() + ONLPLIB_CONFIG_IPMI_TIMEOUT_MS * 1000ULL;
+    for(;;) {
+        struct pollfd pfd;
+        struct ipmi_addr addr;
+        struct ipmi_recv recv;
+        uint8_t data[IPMI_MAX_MSG_LENGTH];
+        uint64_t now = aim_time_monotonic();
+
+        if(now >= deadline) {
+            AIM_LOG_ERROR("IPMI request (netfn 0x%x cmd 0x%x) timed out.", netfn, cmd);
+            return ONLP_STATUS_E_INTERNAL;
+        }
+
+        pfd.fd = ipmi_fd__;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        rv = poll(&pfd, 1, (deadline - now + 999) / 1000);
+        if(rv < 0 && errno == EINTR) {
+            continue;
+        }
+        if(rv <= 0) {
+            continue;
+        }
+
+        memset(&recv, 0, sizeof(recv));
+        recv.addr = (unsigned char*)&addr;
+        recv.addr_len = sizeof(addr);
+        recv.msg.data = data;
+        recv.msg.data_len = sizeof(data);
+        if(ioctl(ipmi_fd__, IPMICTL_RECEIVE_MSG_TRUNC, &recv) < 0) {
+            if(errno == EAGAIN || errno == EINTR) {
+                continue;
+            }
+            AIM_LOG_ERROR("IPMI receive failed: %{errno}", errno);
+            return ONLP_STATUS_E_INTERNAL;
+        }
+
+        if(recv.msgid != r.msgid) {
+            /* Stale response to an earlier, timed out request. */
+            continue;
+        }
+        if(recv.msg.data_len < 1) {
+            return ONLP_STATUS_E_INTERNAL;
+        }
+
+        *cc = data[0];
+        rv = recv.msg.data_len - 1;
+        if(rv > rsp_len) {
+            rv = rsp_len;
+        }
+        memcpy(rsp, data + 1, rv);
+        return rv;
+    }
+}
+
+static int
+ipmi_cmd__(uint8_t netfn, uint8_t cmd, const uint8_t* req, int req_len,
+           uint8_t* rsp, int rsp_len)
+{
+    uint8_t cc;
+    int rv = ipmi_send__(0, 0, netfn, cmd, req, req_len, rsp, rsp_len, &cc);
+    if(rv >= 0 && cc != 0) {
+        AIM_LOG_VERBOSE("IPMI netfn 0x%x cmd 0x%x: completion code 0x%x", netfn, cmd, cc);
+        return ONLP_STATUS_E_INTERNAL;
+    }
+    return rv;
+}
+
+int
+onlp_ipmi_cmd(uint8_t netfn, uint8_t cmd, const uint8_t* req, int req_len,
+              uint8_t* rsp, int rsp_len)
+{
+    int rv;
+    pthread_mutex_lock(&ipmi_lock__);
+    rv = ipmi_cmd__(netfn, cmd, req, req_len, rsp, rsp_len);
+    pthread_mutex_unlock(&ipmi_lock__);
+    return rv;
+}
+
+int
+onlp_ipmi_device_set(const char* path)
+{
+    pthread_mutex_lock(&ipmi_lock__);
+    ipmi_close__();
+    aim_free(ipmi_device__);
+    ipmi_device__ = path ? aim_strdup(path) : NULL;
+    pthread_mutex_unlock(&ipmi_lock__);
+    return 0;
+}
+
+
+/************************************************************
+ *
+ * SDR Repository
+ *
+ ***********************************************************/
+
+static int
+sdr_reserve__(uint16_t* resv)
+{
+    uint8_t rsp[2];
+    uint8_t cc;
+    int rv = ipmi_send__(0, 0, ONLP_IPMI_NETFN_STORAGE, IPMI_CMD_RESERVE_SDR_REPOSITORY,
+                         NULL, 0, rsp, sizeof(rsp), &cc);
+    if(rv < 0) {
+        return rv;
+    }
+    /* Reservations are optional. Zero reads without one. */
+    *resv = (cc == 0 && rv == 2) ? (rsp[0] | (rsp[1] << 8)) : 0;
+    return 0;
+}
+
+static int
+sdr_read__(uint16_t resv, uint16_t id, int offset, int len,
+           uint8_t* dst, uint16_t* next, uint8_t* cc)
+{
+    int rv;
+    uint8_t rsp[2 + IPMI_SDR_READ_SIZE];
+    uint8_t req[6] = { resv & 0xFF, resv >> 8, id & 0xFF, id >> 8, offset, len };
+
+    rv = ipmi_send__(0, 0, ONLP_IPMI_NETFN_STORAGE, IPMI_CMD_GET_SDR,
+                     req, sizeof(req), rsp, sizeof(rsp), cc);
+    if(rv < 0 || *cc != 0) {
+        return rv;
+    }
+    if(rv != 2 + len) {
+        return ONLP_STATUS_E_INTERNAL;
+    }
+    *next = rsp[0] | (rsp[1] << 8);
+    memcpy(dst, rsp + 2, len);
+    return 0;
+}
+
+/* Sign-extend a field of the given width. */
+static int
+sdr_signed__(int v, int bits)
+{
+    return (v & (1 << (bits - 1))) ? v - (1 << bits) : v;
+}
+
+static void
+sdr_parse__(const uint8_t* rec, int len)
+{
+    int idx, idlen;
+    ipmi_sensor_t* s;
+
+    if(rec[3] == IPMI_SDR_TYPE_FULL && len >= 48) {
+        idx = 47;
+    }
+    else if(rec[3] == IPMI_SDR_TYPE_COMPACT && len >= 32) {
+        idx = 31;
+    }
+    else {
+        return;
+    }
+
+    if(ipmi_sensor_count__ >= AIM_ARRAYSIZE(ipmi_sensors__)) {
+        AIM_LOG_WARN("IPMI sensor table is full.");
+        return;
+    }
+    s = ipmi_sensors__ + ipmi_sensor_count__++;
+    memset(s, 0, sizeof(*s));
+
+    s->owner = rec[5];
+    s->lun = rec[6] & 0x3;
+    s->number = rec[7];
+
+    idlen = rec[idx] & 0x1F;
+    if(idlen > sizeof(s->name) - 1) {
+        idlen = sizeof(s->name) - 1;
+    }
+    if(idx + 1 + idlen > len) {
+        idlen = len - idx - 1;
+    }
+    memcpy(s->name, rec + idx + 1, idlen);
+    while(idlen > 0 && (s->name[idlen-1] == ' ' || s->name[idlen-1] == 0)) {
+        s->name[--idlen] = 0;
+    }
+
+    if(rec[3] == IPMI_SDR_TYPE_FULL) {
+        s->full = 1;
+        s->format = rec[20] >> 6;
+        s->linearization = rec[23] & 0x7F;
+        s->m = sdr_signed__(((rec[25] & 0xC0) << 2) | rec[24], 10);
+        s->b = sdr_signed__(((rec[27] & 0xC0) << 2) | rec[26], 10);
+        s->rexp = sdr_signed__(rec[29] >> 4, 4);
+        s->bexp = sdr_signed__(rec[29] & 0xF, 4);
+    }
+}
+
+static int
+sdr_load__(void)
+{
+    int rv;
+    int retries = 0;
+    uint16_t resv;
+    uint16_t id = 0;
+    uint8_t cc;
+    uint8_t rec[IPMI_SDR_HEADER_SIZE + 255];
+
+    ipmi_sensor_count__ = 0;
+    if((rv = sdr_reserve__(&resv)) < 0) {
+        return rv;
+    }
+
+    while(id != 0xFFFF) {
+        uint16_t next;
+        int offset, len;
+
+        len = IPMI_SDR_HEADER_SIZE;
+        rv = sdr_read__(resv, id, 0, IPMI_SDR_HEADER_SIZE, rec, &next, &cc);
+        if(rv == 0 && cc == 0) {
+            len += rec[4];
+        }
+        for(offset = IPMI_SDR_HEADER_SIZE; rv == 0 && cc == 0 && offset < len;
+            offset += IPMI_SDR_READ_SIZE) {
+            uint16_t unused;
+            int n = len - offset;
+            if(n > IPMI_SDR_READ_SIZE) {
+                n = IPMI_SDR_READ_SIZE;
+            }
+            rv = sdr_read__(resv, id, offset, n, rec + offset, &unused, &cc);
+        }
+        if(rv < 0) {
+            return rv;
+        }
+        if(cc == IPMI_CC_RESERVATION_CANCELED && retries++ < 8) {
+            /* The repository changed underneath us. Start over. */
+            ipmi_sensor_count__ = 0;
+            id = 0;
+            if((rv = sdr_reserve__(&resv)) < 0) {
+                return rv;
+            }
+            continue;
+        }
+        if(cc != 0) {
+            AIM_LOG_ERROR("Could not read SDR record 0x%x: completion code 0x%x", id, cc);
+            return ONLP_STATUS_E_INTERNAL;
+        }
+
+        sdr_parse__(rec, len);
+        if(next == id) {
+            break;
+        }
+        id = next;
+    }
+
+    AIM_LOG_VERBOSE("Loaded %d IPMI sensor records.", ipmi_sensor_count__);
+    ipmi_sdr_loaded__ = 1;
+    return 0;
+}
+
+/*
+ * Load the SDR repository if required. A failed load is
+ * not retried until its backoff interval has passed.
+ */
+static int
+sdr_ensure__(void)
+{
+    int rv;
+    uint64_t now;
+
+    if(ipmi_sdr_loaded__) {
+        return 0;
+    }
+
+    now = aim_time_monotonic();
+    if(ipmi_sdr_backoff__ && now < ipmi_sdr_retry__) {
+        return ipmi_sdr_status__;
+    }
+
+    if((rv = sdr_load__()) < 0) {
+        ipmi_sdr_status__ = rv;
+        ipmi_sdr_backoff__ = ipmi_sdr_backoff__ ? ipmi_sdr_backoff__ * 2 : 1000;
+        if(ipmi_sdr_backoff__ > ONLPLIB_CONFIG_IPMI_SDR_RETRY_MS) {
+            ipmi_sdr_backoff__ = ONLPLIB_CONFIG_IPMI_SDR_RETRY_MS;
+        }
+        ipmi_sdr_retry__ = now + ipmi_sdr_backoff__ * 1000;
+        return rv;
+    }
+    ipmi_sdr_backoff__ = 0;
+    return 0;
+}
+
+void
+onlp_ipmi_sdr_invalidate(void)
+{
+    pthread_mutex_lock(&ipmi_lock__);
+    ipmi_sdr_loaded__ = 0;
+    ipmi_sdr_backoff__ = 0;
+    pthread_mutex_unlock(&ipmi_lock__);
+}
+
+
+/************************************************************
+ *
+ * Sensor Readings
+ *
+ ***********************************************************/
+
+static double
+pow10__(int e)
+{
+    double v = 1;
+    for(; e > 0; e--) v *= 10;
+    for(; e < 0; e++) v /= 10;
+    return v;
+}
+
+/*
+ * y = L[(M * x + B * 10^Bexp) * 10^Rexp]
+ */
+static int
+sensor_convert__(ipmi_sensor_t* s, uint8_t raw, double* value)
+{
+    double x, y;
+
+    if(!s->full) {
+        *value = raw;
+        return 0;
+    }
+
+    switch(s->format)
+        {
+        case 0: x = raw; break;
+        case 1: x = (raw & 0x80) ? -(double)(~raw & 0xFF) : raw; break;
+        case 2: x = (int8_t)raw; break;
+        default: return ONLP_STATUS_E_UNSUPPORTED;
+        }
+
+    y = (s->m * x + s->b * pow10__(s->bexp)) * pow10__(s->rexp);
+
+    switch(s->linearization)
+        {
+        case 0: break;
+        case 7:
+            if(y == 0) {
+                return ONLP_STATUS_E_UNSUPPORTED;
+            }
+            y = 1 / y;
+            break;
+        case 8: y = y * y; break;
+        case 9: y = y * y * y; break;
+        default:
+            /* The logarithmic and exponential forms are not used by BMCs we support. */
+            return ONLP_STATUS_E_UNSUPPORTED;
+        }
+
+    *value = y;
+    return 0;
+}
+
+static int
+sensor_read__(ipmi_sensor_t* s)
+{
+    int rv;
+    uint8_t cc;
+    uint8_t rsp[4];
+
+    rv = ipmi_send__(s->owner, s->lun, ONLP_IPMI_NETFN_SENSOR, IPMI_CMD_GET_SENSOR_READING,
+                     &s->number, 1, rsp, sizeof(rsp), &cc);
+    if(rv < 0) {
+        return rv;
+    }
+    if(cc == IPMI_CC_NOT_PRESENT) {
+        return ONLP_STATUS_E_UNSUPPORTED;
+    }
+    if(cc != 0 || rv < 2) {
+        return ONLP_STATUS_E_INTERNAL;
+    }
+    if((rsp[1] & IPMI_SENSOR_READING_UNAVAILABLE) ||
+       !(rsp[1] & IPMI_SENSOR_SCANNING_ENABLED)) {
+        return ONLP_STATUS_E_UNSUPPORTED;
+    }
+    return sensor_convert__(s, rsp[0], &s->value);
+}
+
+int
+onlp_ipmi_sensor_get(const char* name, uint64_t max_age, double* value)
+{
+    int i, rv;
+    uint64_t now;
+    ipmi_sensor_t* s = NULL;
+
+    pthread_mutex_lock(&ipmi_lock__);
+
+    if((rv = sdr_ensure__()) < 0) {
+        goto done;
+    }
+
+    for(i = 0; i < ipmi_sensor_count__; i++) {
+        if(!strcmp(ipmi_sensors__[i].name, name)) {
+            s = ipmi_sensors__ + i;
+            break;
+        }
+    }
+    if(s == NULL) {
+        rv = ONLP_STATUS_E_MISSING;
+        goto done;
+    }
+
+    now = aim_time_monotonic();
+    if(s->updated == 0 || now - s->updated > max_age) {
+        s->status = sensor_read__(s);
+        s->updated = now;
+    }
+    if((rv = s->status) == 0) {
+        *value = s->value;
+    }
+
+ done:
+    pthread_mutex_unlock(&ipmi_lock__);
+    return rv;
+}
+
+void
+onlp_ipmi_sensors_show(aim_pvs_t* pvs)
+{
+    int i;
+    uint64_t now = aim_time_monotonic();
+
+    pthread_mutex_lock(&ipmi_lock__);
+    aim_printf(pvs, "%-16s %5s %5s %12s %10s\n", "name", "owner", "num", "value", "age(ms)");
+    for(i = 0; i < ipmi_sensor_count__; i++) {
+        ipmi_sensor_t* s = ipmi_sensors__ + i;
+        aim_printf(pvs, "%-16s  0x%02x  0x%02x ", s->name, s->owner, s->number);
+        if(s->updated == 0) {
+            aim_printf(pvs, "%12s %10s\n", "-", "-");
+        }
+        else if(s->status < 0) {
+            aim_printf(pvs, "%12s %10"PRIu64"\n", "na", (now - s->updated) / 1000);
+        }
+        else {
+            aim_printf(pvs, "%12.3f %10"PRIu64"\n", s->value, (now - s->updated) / 1000);
+        }
+    }
+    pthread_mutex_unlock(&ipmi_lock__);
+}
+
+#else
+
+int
+onlp_ipmi_device_set(const char* path)
+{
+    return ONLP_STATUS_E_UNSUPPORTED;
+}
+
+int
+onlp_ipmi_cmd(uint8_t netfn, uint8_t cmd, const uint8_t* req, int req_len,
+              uint8_t* rsp, int rsp_len)
+{
+    return ONLP_STATUS_E_UNSUPPORTED;
+}
+
+int
+onlp_ipmi_sensor_get(const char* name, uint64_t max_age, double* value)
+{
+    return ONLP_STATUS_E_UNSUPPORTED;
+}
+
+void
+onlp_ipmi_sdr_invalidate(void)
+{
+}
+
+void
+onlp_ipmi_sensors_show(aim_pvs_t* pvs)
+{
+    aim_printf(pvs, "IPMI support is not available in this build.\n");
+}
+
+#endif /* ONLPLIB_CONFIG_INCLUDE_IPMI */
@@ -89,6 +89,61 @@ onlplib_config_settings_t onlplib_config_settings[] =
     { __onlplib_config_STRINGIFY_NAME(ONLPLIB_CONFIG_INCLUDE_I2C_SMBUS), __onlplib_config_STRINGIFY_VALUE(ONLPLIB_CONFIG_INCLUDE_I2C_SMBUS) },
 #else
 { ONLPLIB_CONFIG_INCLUDE_I2C_SMBUS(__onlplib_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLPLIB_CONFIG_INCLUDE_I2C_FD_CACHE
+    { __onlplib_config_STRINGIFY_NAME(ONLPLIB_CONFIG_INCLUDE_I2C_FD_CACHE), __onlplib_config_STRINGIFY_VALUE(ONLPLIB_CONFIG_INCLUDE_I2C_FD_CACHE) },
+#else
+{ ONLPLIB_CONFIG_INCLUDE_I2C_FD_CACHE(__onlplib_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLPLIB_CONFIG_I2C_FD_CACHE_SIZE
+    { __onlplib_config_STRINGIFY_NAME(ONLPLIB_CONFIG_I2C_FD_CACHE_SIZE), __onlplib_config_STRINGIFY_VALUE(ONLPLIB_CONFIG_I2C_FD_CACHE_SIZE) },
+#else
+{ ONLPLIB_CONFIG_I2C_FD_CACHE_SIZE(__onlplib_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLPLIB_CONFIG_I2C_MUX_STATE_TTL
+    { __onlplib_config_STRINGIFY_NAME(ONLPLIB_CONFIG_I2C_MUX_STATE_TTL), __onlplib_config_STRINGIFY_VALUE(ONLPLIB_CONFIG_I2C_MUX_STATE_TTL) },
+#else
+{ ONLPLIB_CONFIG_I2C_MUX_STATE_TTL(__onlplib_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLPLIB_CONFIG_INCLUDE_IPMI
+    { __onlplib_config_STRINGIFY_NAME(ONLPLIB_CONFIG_INCLUDE_IPMI), __onlplib_config_STRINGIFY_VALUE(ONLPLIB_CONFIG_INCLUDE_IPMI) },
+#else
+{ ONLPLIB_CONFIG_INCLUDE_IPMI(__onlplib_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLPLIB_CONFIG_IPMI_DEVICE
+    { __onlplib_config_STRINGIFY_NAME(ONLPLIB_CONFIG_IPMI_DEVICE), __onlplib_config_STRINGIFY_VALUE(ONLPLIB_CONFIG_IPMI_DEVICE) },
+#else
+{ ONLPLIB_CONFIG_IPMI_DEVICE(__onlplib_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLPLIB_CONFIG_IPMI_TIMEOUT_MS
+    { __onlplib_config_STRINGIFY_NAME(ONLPLIB_CONFIG_IPMI_TIMEOUT_MS), __onlplib_config_STRINGIFY_VALUE(ONLPLIB_CONFIG_IPMI_TIMEOUT_MS) },
+#else
+{ ONLPLIB_CONFIG_IPMI_TIMEOUT_MS(__onlplib_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLPLIB_CONFIG_IPMI_SENSORS_MAX
+    { __onlplib_config_STRINGIFY_NAME(ONLPLIB_CONFIG_IPMI_SENSORS_MAX), __onlplib_config_STRINGIFY_VALUE(ONLPLIB_CONFIG_IPMI_SENSORS_MAX) },
+#else
+{ ONLPLIB_CONFIG_IPMI_SENSORS_MAX(__onlplib_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLPLIB_CONFIG_HWMON_ATTRIBUTES_MAX
+    { __onlplib_config_STRINGIFY_NAME(ONLPLIB_CONFIG_HWMON_ATTRIBUTES_MAX), __onlplib_config_STRINGIFY_VALUE(ONLPLIB_CONFIG_HWMON_ATTRIBUTES_MAX) },
+#else
+{ ONLPLIB_CONFIG_HWMON_ATTRIBUTES_MAX(__onlplib_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLPLIB_CONFIG_FILE_HANDLE_CACHE_SIZE
+    { __onlplib_config_STRINGIFY_NAME(ONLPLIB_CONFIG_FILE_HANDLE_CACHE_SIZE), __onlplib_config_STRINGIFY_VALUE(ONLPLIB_CONFIG_FILE_HANDLE_CACHE_SIZE) },
+#else
+{ ONLPLIB_CONFIG_FILE_HANDLE_CACHE_SIZE(__onlplib_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLPLIB_CONFIG_FILE_FIND_CACHE_SIZE
+    { __onlplib_config_STRINGIFY_NAME(ONLPLIB_CONFIG_FILE_FIND_CACHE_SIZE), __onlplib_config_STRINGIFY_VALUE(ONLPLIB_CONFIG_FILE_FIND_CACHE_SIZE) },
+#else
+{ ONLPLIB_CONFIG_FILE_FIND_CACHE_SIZE(__onlplib_config_STRINGIFY_NAME), "__undefined__" },
+#endif
+#ifdef ONLPLIB_CONFIG_IPMI_SDR_RETRY_MS
+    { __onlplib_config_STRINGIFY_NAME(ONLPLIB_CONFIG_IPMI_SDR_RETRY_MS), __onlplib_config_STRINGIFY_VALUE(ONLPLIB_CONFIG_IPMI_SDR_RETRY_MS) },
+#else
+{ ONLPLIB_CONFIG_IPMI_SDR_RETRY_MS(__onlplib_config_STRINGIFY_NAME), "__undefined__" },
 #endif
     { NULL, NULL }
 };
@@ -26,6 +26,10 @@
 #include "onlplib_log.h"
 #include <sys/ipc.h>
 #include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
 
 static int
 shared_pthread_mutex_init__(pthread_mutex_t* mutex)
@@ -211,6 +215,317 @@ onlp_shlock_name(onlp_shlock_t* lock)
 }
 
 
+/**
+ * Shared/exclusive locks.
+ *
+ * The lock state is protected by a robust mutex and waiters
+ * sleep on a process-shared condition. Readers are tracked
+ * by pid so that the state of a process which exits while
+ * holding the lock can be discarded.
+ */
+#define SHRWLOCK_MAGIC 0xFEEDBEEF
+#define SHRWLOCK_READERS_MAX 32
+
+/* Waiters rescan for dead holders at this interval (us) */
+#define SHRWLOCK_SCRUB_INTERVAL 1000000
+
+typedef struct shrwlock_reader_s {
+    pid_t pid;
+    int count;
+} shrwlock_reader_t;
+
+struct onlp_shrwlock_s {
+    uint32_t magic;
+    char name[64];
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+
+    /* Process holding the lock exclusively. */
+    pid_t writer;
+    /* Process waiting for exclusive access. Blocks new readers. */
+    pid_t writer_waiting;
+
+    shrwlock_reader_t readers[SHRWLOCK_READERS_MAX];
+};
+
+static int
+shared_pthread_cond_init__(pthread_cond_t* cond)
+{
+    int rv = -1;
+    pthread_condattr_t ca;
+
+    pthread_condattr_init(&ca);
+    if(pthread_condattr_setpshared(&ca, PTHREAD_PROCESS_SHARED) != 0) {
+        AIM_LOG_ERROR("setpshared() failed: %{errno}", errno);
+    }
+    else if(pthread_condattr_setclock(&ca, CLOCK_MONOTONIC) != 0) {
+        AIM_LOG_ERROR("setclock() failed: %{errno}", errno);
+    }
+    else if(pthread_cond_init(cond, &ca) != 0) {
+        AIM_LOG_ERROR("cond_init() failed: %{errno}", errno);
+    }
+    else {
+        rv = 0;
+    }
+    pthread_condattr_destroy(&ca);
+    return rv;
+}
+
+static void
+onlp_shrwlock_init__(onlp_shrwlock_t* l, const char* fmt, va_list vargs)
+{
+    if(l->magic != SHRWLOCK_MAGIC) {
+        memset(l, 0, sizeof(*l));
+        if(shared_pthread_mutex_init__(&l->mutex) != 0 ||
+           shared_pthread_cond_init__(&l->cond) != 0) {
+            /* There is no useful recovery from this */
+            AIM_DIE("shrwlock_init(): initialization failed\n");
+        }
+        char* s = aim_vfstrdup(fmt, vargs);
+        aim_strlcpy(l->name, s, sizeof(l->name));
+        aim_free(s);
+        l->magic = SHRWLOCK_MAGIC;
+    }
+}
+
+int
+onlp_shrwlock_create(key_t id, onlp_shrwlock_t** rvl, const char* fmt, ...)
+{
+    onlp_shrwlock_t* l = NULL;
+    int rv = onlp_shmem_create(id, sizeof(onlp_shrwlock_t), (void**)&l);
+
+    if(rv >= 0) {
+        va_list vargs;
+        va_start(vargs, fmt);
+        onlp_shrwlock_init__(l, fmt, vargs);
+        va_end(vargs);
+        *rvl = l;
+    }
+    else {
+        AIM_DIE("shrwlock_create(): shmem_create failed\n");
+        rv = -1;
+    }
+    return rv;
+}
+
+int
+onlp_shrwlock_destroy(onlp_shrwlock_t* lock)
+{
+    return shmdt(lock);
+}
+
+static int
+pid_dead__(pid_t pid)
+{
+    return kill(pid, 0) == -1 && errno == ESRCH;
+}
+
+/*
+ * Discard the state of any holder which no longer exists.
+ * Must be called with the state mutex held.
+ */
+static void
+shrwlock_scrub__(onlp_shrwlock_t* l)
+{
+    int i;
+    int changed = 0;
+
+    if(l->writer && pid_dead__(l->writer)) {
+        AIM_LOG_WARN("shrwlock %s: discarding exclusive owner %d which no longer exists.",
+                     l->name, l->writer);
+        l->writer = 0;
+        changed = 1;
+    }
+    if(l->writer_waiting && pid_dead__(l->writer_waiting)) {
+        l->writer_waiting = 0;
+        changed = 1;
+    }
+    for(i = 0; i < SHRWLOCK_READERS_MAX; i++) {
+        if(l->readers[i].count && pid_dead__(l->readers[i].pid)) {
+            AIM_LOG_WARN("shrwlock %s: discarding shared owner %d which no longer exists.",
+                         l->name, l->readers[i].pid);
+            l->readers[i].pid = 0;
+            l->readers[i].count = 0;
+            changed = 1;
+        }
+    }
+    if(changed) {
+        pthread_cond_broadcast(&l->cond);
+    }
+}
+
+static void
+shrwlock_mutex_lock__(onlp_shrwlock_t* l)
+{
+    int rv = pthread_mutex_lock(&l->mutex);
+    if(rv == EOWNERDEAD) {
+        AIM_LOG_WARN("Detected EOWNERDEAD on take.");
+        pthread_mutex_consistent(&l->mutex);
+        shrwlock_scrub__(l);
+    }
+    else if(rv != 0) {
+        AIM_DIE("mutex_lock failed: %{errno}", rv);
+    }
+}
+
+static shrwlock_reader_t*
+shrwlock_reader_slot__(onlp_shrwlock_t* l, pid_t pid, int alloc)
+{
+    int i;
+    shrwlock_reader_t* free_slot = NULL;
+
+    for(i = 0; i < SHRWLOCK_READERS_MAX; i++) {
+        if(l->readers[i].count) {
+            if(l->readers[i].pid == pid) {
+                return l->readers + i;
+            }
+        }
+        else if(free_slot == NULL) {
+            free_slot = l->readers + i;
+        }
+    }
+    if(alloc && free_slot) {
+        free_slot->pid = pid;
+        return free_slot;
+    }
+    return NULL;
+}
+
+static int
+shrwlock_readers__(onlp_shrwlock_t* l)
+{
+    int i;
+    for(i = 0; i < SHRWLOCK_READERS_MAX; i++) {
+        if(l->readers[i].count) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int
+shrwlock_blocked__(onlp_shrwlock_t* l, pid_t pid, int exclusive)
+{
+    if(l->writer) {
+        return 1;
+    }
+    if(exclusive) {
+        return shrwlock_readers__(l);
+    }
+    if(l->writer_waiting && l->writer_waiting != pid) {
+        return 1;
+    }
+    return shrwlock_reader_slot__(l, pid, 1) == NULL;
+}
+
+int
+onlp_shrwlock_take(onlp_shrwlock_t* l, int exclusive, int64_t timeout)
+{
+    struct timespec now;
+    uint64_t deadline = 0;
+    pid_t pid = getpid();
+
+    if(l == NULL) {
+        AIM_DIE("shrwlock_take(): lock is NULL");
+    }
+
+    if(timeout >= 0) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        deadline = (uint64_t)now.tv_sec*1000000 + now.tv_nsec/1000 + timeout;
+    }
+
+    shrwlock_mutex_lock__(l);
+
+    while(shrwlock_blocked__(l, pid, exclusive)) {
+        uint64_t wake;
+        struct timespec ts;
+        int rv;
+
+        if(exclusive) {
+            l->writer_waiting = pid;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        wake = (uint64_t)now.tv_sec*1000000 + now.tv_nsec/1000;
+        if(deadline && wake >= deadline) {
+            if(exclusive && l->writer_waiting == pid) {
+                l->writer_waiting = 0;
+                pthread_cond_broadcast(&l->cond);
+            }
+            pthread_mutex_unlock(&l->mutex);
+            return -1;
+        }
+        wake += SHRWLOCK_SCRUB_INTERVAL;
+        if(deadline && wake > deadline) {
+            wake = deadline;
+        }
+        ts.tv_sec = wake / 1000000;
+        ts.tv_nsec = (wake % 1000000) * 1000;
+
+        rv = pthread_cond_timedwait(&l->cond, &l->mutex, &ts);
+        if(rv == EOWNERDEAD) {
+            AIM_LOG_WARN("Detected EOWNERDEAD on wait.");
+            pthread_mutex_consistent(&l->mutex);
+            shrwlock_scrub__(l);
+        }
+        else if(rv == ETIMEDOUT) {
+            shrwlock_scrub__(l);
+        }
+        else if(rv != 0) {
+            AIM_DIE("cond_timedwait failed: %{errno}", rv);
+        }
+    }
+
+    if(exclusive) {
+        if(l->writer_waiting == pid) {
+            l->writer_waiting = 0;
+        }
+        l->writer = pid;
+    }
+    else {
+        shrwlock_reader_slot__(l, pid, 1)->count++;
+    }
+
+    pthread_mutex_unlock(&l->mutex);
+    return 0;
+}
+
+int
+onlp_shrwlock_give(onlp_shrwlock_t* l, int exclusive)
+{
+    pid_t pid = getpid();
+
+    if(l == NULL) {
+        AIM_DIE("shrwlock_give(): lock is NULL");
+    }
+
+    shrwlock_mutex_lock__(l);
+    if(exclusive) {
+        if(l->writer != pid) {
+            AIM_DIE("shrwlock %s: give by %d but owned by %d", l->name, pid, l->writer);
+        }
+        l->writer = 0;
+    }
+    else {
+        shrwlock_reader_t* r = shrwlock_reader_slot__(l, pid, 0);
+        if(r == NULL) {
+            AIM_DIE("shrwlock %s: shared give by %d which does not hold the lock", l->name, pid);
+        }
+        r->count--;
+    }
+    pthread_cond_broadcast(&l->cond);
+    pthread_mutex_unlock(&l->mutex);
+    return 0;
+}
+
+const char*
+onlp_shrwlock_name(onlp_shrwlock_t* lock)
+{
+    return lock->name;
+}
+
+
 static onlp_shlock_t* global_lock__ = NULL;
 
 
@@ -39,12 +39,40 @@ void __oom_shim_module_init__(void) {
     onlp_init();
 }
 
+typedef struct oom_portlist_s {
+    oom_port_t* portlist;
+    int listsize;
+    int count;
+} oom_portlist_t;
+
+static void oom_portlist_port__(void* cookie, int port, int status, const sff_eeprom_t* sff){
+    oom_port_t* pptr;
+    oom_portlist_t* pl = (oom_portlist_t*)cookie;
+
+    if(pl->count >= pl->listsize){
+        return;
+    }
+
+    pptr = &pl->portlist[pl->count++];
+    pptr->handle = (void *)(uintptr_t)port+1;
+    pptr->oom_class = OOM_PORT_CLASS_SFF;
+    sprintf(pptr->name, "port%d", port+1);
+
+    if(status == ONLP_STATUS_E_MISSING){
+        /* aim_printf(&aim_pvs_stdout, "module %d is not present\n", port);*/
+        pptr->oom_class = OOM_PORT_CLASS_UNKNOWN;
+        return;
+    }
+
+    if(status < 0){
+        aim_printf(&aim_pvs_stdout, "%4d  Error %{onlp_status}\n", port, status);
+        pptr->oom_class = OOM_PORT_CLASS_UNKNOWN;
+    }
+}
+
 /*Gets the portlist of the SFP ports on the switch*/
 int oom_get_portlist(oom_port_t portlist[], int listsize){
-    
-    int port,i=0;
-    oom_port_t* pptr;
-    
+    oom_portlist_t pl = { portlist, listsize, 0 };
 
     onlp_sfp_bitmap_t bitmap;
     onlp_sfp_bitmap_t_init(&bitmap);
@@ -58,36 +86,19 @@ int oom_get_portlist(oom_port_t portlist[], int listsize){
             return AIM_BITMAP_COUNT(&bitmap);
     }
 
-    AIM_BITMAP_ITER(&bitmap, port){
-        int rv;
-        
-        pptr = &portlist[i];
-        pptr->handle = (void *)(uintptr_t)port+1;
-        pptr->oom_class = OOM_PORT_CLASS_SFF; 
-        sprintf(pptr->name, "port%d", port+1);
-        i++;
-        
-        rv = onlp_sfp_is_present(port);
-        if(rv == 0){
-            /* aim_printf(&aim_pvs_stdout, "module %d is not present\n", port);*/
-            pptr->oom_class = OOM_PORT_CLASS_UNKNOWN;
-            continue;
-        }
-
-        if(rv < 0){
-            aim_printf(&aim_pvs_stdout, "%4d  Error %{onlp_status}\n", port, rv);
-            pptr->oom_class = OOM_PORT_CLASS_UNKNOWN;
-            continue;
-        }
+    /* Module identity is served from the shared SFP inventory. */
+    int rv = onlp_sfp_inventory_iterate(oom_portlist_port__, &pl);
+    if(rv < 0){
+        aim_printf(&aim_pvs_stdout, "Error reading the SFP inventory: %{onlp_status}\n", rv);
+        return rv;
     }
-    return 0;
+    return pl.count;
 }
 
 
 int oom_get_memory_sff(oom_port_t* port, int address, int page, int offset, int len, uint8_t* data){
     int rv;
     unsigned int port_num; 
-    uint8_t* idprom = NULL;
 
     port_num = (unsigned int)(uintptr_t)port->handle;
     port_num -= 1;
@@ -95,27 +106,17 @@ int oom_get_memory_sff(oom_port_t* port, int address, int page, int offset, int
     if (offset >= 256)
         return -1;  /* out of range */
 
-    /** 
-     * place holder implementation until onlp_sfp_eeprom_read() 
-     * can be improved to handle partial page gets
-     **/
-
-    if (address == 0xa0) {
-        rv = onlp_sfp_eeprom_read(port_num, &idprom);
-    } else if (address == 0xa2) {
-        rv = onlp_sfp_dom_read(port_num, &idprom);
-    } else {
+    if (address != 0xa0 && address != 0xa2) {
         aim_printf(&aim_pvs_stdout, "Error invalid address: 0x%02x\n", address);
         return -EINVAL;
     }
 
+    rv = onlp_sfp_eeprom_readv(port_num, address >> 1, page, offset, len, data);
     if(rv < 0) {
-        aim_printf(&aim_pvs_stdout, "Error reading eeprom: %{onlp_status}\n");
+        aim_printf(&aim_pvs_stdout, "Error reading eeprom: %{onlp_status}\n", rv);
         return -1;
     }
-    memcpy(data, &idprom[offset], len); 
-    aim_free(idprom);
-    
+
     return 0;
 }
 
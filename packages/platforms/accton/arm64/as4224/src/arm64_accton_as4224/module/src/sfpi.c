@@ -103,6 +103,17 @@ onlp_sfpi_bitmap_get(onlp_sfp_bitmap_t* bmap)
     return ONLP_STATUS_OK;
 }
 
+int
+onlp_sfpi_port_bus_get(int port, int* bus)
+{
+    int rv = onlp_i2c_bus_root(PORT_BUS_INDEX(port));
+    if(rv < 0) {
+        return rv;
+    }
+    *bus = rv;
+    return ONLP_STATUS_OK;
+}
+
 int
 onlp_sfpi_is_present(int port)
 {
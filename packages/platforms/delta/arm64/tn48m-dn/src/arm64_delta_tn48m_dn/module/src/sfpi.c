@@ -188,9 +188,14 @@ onlp_sfpi_eeprom_read(int port, uint8_t data[256])
      * Read the SFP eeprom into data[]
      *
      * Return OK if eeprom is read
+     *
+     * The platform init binds no kernel driver to the module EEPROMs.
+     * The read is forced so the SMBUS fallback matches the I2C_RDWR
+     * transfer, which does not check for one.
      */
     memset(data, 0, 256);
-    if (onlp_i2c_read(eeprom_bus, SFP_EEPROM_ADDR, 0, 256, data, 0) != 0)
+    if (onlp_i2c_read(eeprom_bus, SFP_EEPROM_ADDR, 0, 256, data,
+                      ONLP_I2C_F_FORCE | ONLP_I2C_F_USE_RDWR) != 0)
     {
         AIM_LOG_ERROR("Unable to read eeprom from port(%d)\r\n", port);
         return ONLP_STATUS_E_INTERNAL;
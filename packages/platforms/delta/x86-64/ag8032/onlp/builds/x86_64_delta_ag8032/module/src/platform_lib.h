@@ -28,6 +28,7 @@
 #define __PLAT_LIB_H__
 
 #include <onlplib/i2c.h>
+#include <onlplib/hwmon.h>
 
 #define ONIE_EEPROM_LOCATION	"/sys/bus/i2c/devices/i2c-5/5-0054/eeprom"
 
@@ -294,15 +295,9 @@ typedef struct plat_psu {
 	hook_present present;
 	cpld_reg_t present_cpld_reg;
 
-	char *vin_path;
-	char *vout_path;
-	char *iin_path;
-	char *iout_path;
-	char *pin_path;
-	char *pout_path;
-
-	char *vin_max_path;
-	char *vin_min_path;
+	// pmbus device directory, sampled through the hwmon handle
+	char *hwmon_path;
+	onlp_hwmon_t *hwmon;
 
 	hook_event event_callback;
 
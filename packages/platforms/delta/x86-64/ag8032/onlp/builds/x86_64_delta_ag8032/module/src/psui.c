@@ -37,16 +37,7 @@ static plat_psu_t plat_psus[] = {
 		.present = _psu_present,
 		.present_cpld_reg = CPLD_REG (CPLD_CPUPLD, 0x1a, 6, 1),
 
-		.vin_path = "/sys/bus/i2c/devices/4-0058/hwmon/*/in1_input",
-		.iin_path = "/sys/bus/i2c/devices/4-0058/hwmon/*/curr1_input",
-		.pin_path = "/sys/bus/i2c/devices/4-0058/hwmon/*/power1_input",
-
-		.vout_path = "/sys/bus/i2c/devices/4-0058/hwmon/*/in2_input",
-		.iout_path = "/sys/bus/i2c/devices/4-0058/hwmon/*/curr2_input",
-		.pout_path = "/sys/bus/i2c/devices/4-0058/hwmon/*/power2_input",
-
-		.vin_max_path = "/sys/bus/i2c/devices/4-0058/hwmon/*/in1_max",
-		.vin_min_path = "/sys/bus/i2c/devices/4-0058/hwmon/*/in1_min",
+		.hwmon_path = "/sys/bus/i2c/devices/4-0058",
 
 		.eeprom_bus = 4,
 		.eeprom_addr= 0x50,
@@ -64,16 +55,7 @@ static plat_psu_t plat_psus[] = {
 		.present = _psu_present,
 		.present_cpld_reg = CPLD_REG (CPLD_CPUPLD, 0x1a, 7, 1),
 
-		.vin_path = "/sys/bus/i2c/devices/4-0059/hwmon/*/in1_input",
-		.iin_path = "/sys/bus/i2c/devices/4-0059/hwmon/*/curr1_input",
-		.pin_path = "/sys/bus/i2c/devices/4-0059/hwmon/*/power1_input",
-
-		.vout_path = "/sys/bus/i2c/devices/4-0059/hwmon/*/in2_input",
-		.iout_path = "/sys/bus/i2c/devices/4-0059/hwmon/*/curr2_input",
-		.pout_path = "/sys/bus/i2c/devices/4-0059/hwmon/*/power2_input",
-
-		.vin_max_path = "/sys/bus/i2c/devices/4-0059/hwmon/*/in1_max",
-		.vin_min_path = "/sys/bus/i2c/devices/4-0059/hwmon/*/in1_min",
+		.hwmon_path = "/sys/bus/i2c/devices/4-0059",
 
 		.eeprom_bus = 4,
 		.eeprom_addr= 0x51,
@@ -120,9 +102,11 @@ static int _psu_event (void *e, int ev)
 			memset (psu->eeprom, 0xff, sizeof(psu->eeprom));
 		break;
 	case PLAT_PSU_PMBUS_DISCONNECT:
+	case PLAT_PSU_EVENT_UNPLUG:
 		memset (psu->eeprom, 0xff, sizeof(psu->eeprom));
+		onlp_hwmon_close (psu->hwmon);
+		psu->hwmon = NULL;
 		break;
-	case PLAT_PSU_EVENT_UNPLUG:
 	case PLAT_PSU_EVENT_PLUGIN:
 	default:
 		break;
@@ -137,13 +121,13 @@ static uint32_t _psu_vin_type_guess (plat_psu_t *psu)
 	int vmax = -1;
 	int vmin = -1;
 
-	if ((psu->vin_max_path) && 
-		(plat_os_file_read_int (&vmax, psu->vin_max_path, NULL) < 0))
+	if ((psu->hwmon) &&
+		(onlp_hwmon_value_get (psu->hwmon, "in1_max", &vmax) < 0))
 		vmax = -1;
-	if ((psu->vin_min_path) && 
-		(plat_os_file_read_int (&vmin, psu->vin_min_path, NULL) < 0))
+	if ((psu->hwmon) &&
+		(onlp_hwmon_value_get (psu->hwmon, "in1_min", &vmin) < 0))
 		vmin = -1;
-	
+
 	ret = 0;
 	if (12000 > vmin && 12000 < vmax)
 		ret |= ONLP_PSU_CAPS_DC12;
@@ -206,13 +190,17 @@ onlp_psui_info_get(onlp_oid_t id, onlp_psu_info_t* info)
 	}
 
 	///////////////////////////////////////////////////////////////
-	// get caps
-	if (psu->vin_path && plat_os_file_is_existed(psu->vin_path))  info->caps |= ONLP_PSU_CAPS_VIN;
-	if (psu->iin_path && plat_os_file_is_existed(psu->iin_path))  info->caps |= ONLP_PSU_CAPS_IIN;
-	if (psu->pin_path && plat_os_file_is_existed(psu->pin_path))  info->caps |= ONLP_PSU_CAPS_PIN;
-	if (psu->vout_path && plat_os_file_is_existed(psu->vout_path)) info->caps |= ONLP_PSU_CAPS_VOUT;
-	if (psu->iout_path && plat_os_file_is_existed(psu->iout_path)) info->caps |= ONLP_PSU_CAPS_IOUT;
-	if (psu->pout_path && plat_os_file_is_existed(psu->pout_path)) info->caps |= ONLP_PSU_CAPS_POUT;
+	// sample the pmbus device, the caps follow its attributes
+	error = 0;
+	if (psu->state == PLAT_PSU_STATE_PMBUS_READY) {
+		if (!psu->hwmon &&
+			onlp_hwmon_open (&psu->hwmon, "%s", psu->hwmon_path) < 0)
+			psu->hwmon = NULL;
+		if (psu->hwmon && onlp_hwmon_sample (psu->hwmon) < 0)
+			error ++;
+	}
+	if (psu->hwmon && !error)
+		onlp_hwmon_psu_info_get (psu->hwmon, info);
 
 	//// TODO : auto detect AC / DC type
 	// we do a guess
@@ -223,55 +211,11 @@ onlp_psui_info_get(onlp_oid_t id, onlp_psu_info_t* info)
 	eeprom_info_get (psu->eeprom, sizeof(psu->eeprom), "psu_series", info->serial);
 
 	///////////////////////////////////////////////////////////////
-	// get and check value
-	error = 0;
-	if (info->caps & ONLP_PSU_CAPS_VIN) {
-
-		if (psu->state != PLAT_PSU_STATE_PMBUS_READY) {
-				info->status |= ONLP_PSU_STATUS_FAILED;
-		} else {
-			
-			if (plat_os_file_read_int(&info->mvin, psu->vin_path, NULL) < 0) {
-				error ++;
-			} else {
-				if (info->mvin < 2)
-					info->status |= ONLP_PSU_STATUS_FAILED;
-			}
-		}
-	}
-
-	//// If VIN is not ok, skip other 
-	if ((info->status & ONLP_PSU_STATUS_FAILED) == 0) {
-
-	if (info->caps & ONLP_PSU_CAPS_IIN) {
-		if (plat_os_file_read_int(&info->miin, psu->iin_path, NULL) < 0)
-			error ++;
-	}
-	if (info->caps & ONLP_PSU_CAPS_PIN) {
-		if (plat_os_file_read_int(&info->mpin, psu->pin_path, NULL) < 0)
-			error ++;
-		else
-			info->mpin = info->mpin / 1000;
-	}
-	if (info->caps & ONLP_PSU_CAPS_VOUT) {
-		if (plat_os_file_read_int(&info->mvout, psu->vout_path, NULL) < 0) {
-			error ++;
-		} else {
-			if (info->mvout < 2)
-				info->status |= ONLP_PSU_STATUS_FAILED;
-		}
-	}
-	if (info->caps & ONLP_PSU_CAPS_IOUT) {
-		if (plat_os_file_read_int(&info->miout, psu->iout_path, NULL) < 0)
-			error ++;
-	}
-	if (info->caps & ONLP_PSU_CAPS_POUT) {
-		if (plat_os_file_read_int(&info->mpout, psu->pout_path, NULL) < 0)
-			error ++;
-		else
-			info->mpout = info->mpout / 1000;
-	}
-	} // if ((info->status & ONLP_PSU_STATUS_FAILED) == 0)
+	// check value
+	if ((info->caps & ONLP_PSU_CAPS_VIN) && info->mvin < 2)
+		info->status |= ONLP_PSU_STATUS_FAILED;
+	if ((info->caps & ONLP_PSU_CAPS_VOUT) && info->mvout < 2)
+		info->status |= ONLP_PSU_STATUS_FAILED;
 
     return error ? ONLP_STATUS_E_INTERNAL : ONLP_STATUS_OK;
 }
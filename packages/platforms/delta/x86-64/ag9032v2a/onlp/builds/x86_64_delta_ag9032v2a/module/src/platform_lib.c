@@ -64,23 +64,15 @@ void lockinit()
 
 int dni_bmc_sensor_read(char *device_name, UINT4 *num, UINT4 multiplier)
 {
-    FILE *fpRead;
-    char Buf[ 10 ]={0};
-    char ipmi_command[120] = {0};
-    int lenth=10;
-    float num_f;
-
-    sprintf(ipmi_command, "ipmitool sdr get %s |grep 'Sensor Reading'| awk -F':' '{print $2}'| awk -F' ' '{ print $1}'",      device_name);
-    fpRead = popen(ipmi_command, "r");
-
-    if(fpRead == NULL){
-        pclose(fpRead);
-                return ONLP_STATUS_E_GENERIC;
-    }
-    fgets(Buf, lenth , fpRead);
-    num_f = atof( Buf );
-    *num = num_f * multiplier;
-    pclose(fpRead);
+    double value = 0;
+    int rv;
+
+    /* Sensors without a reading (e.g. an absent PSU) read as zero. */
+    rv = onlp_ipmi_sensor_get(device_name, 0, &value);
+    if(rv < 0 && rv != ONLP_STATUS_E_UNSUPPORTED && rv != ONLP_STATUS_E_MISSING)
+        return rv;
+
+    *num = value * multiplier;
     return ONLP_STATUS_OK;
 }
 int
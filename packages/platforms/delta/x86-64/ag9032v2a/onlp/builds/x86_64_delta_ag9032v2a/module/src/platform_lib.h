@@ -29,6 +29,7 @@
 #include "x86_64_delta_ag9032v2a_log.h"
 #include <onlp/onlp.h>
 #include <onlplib/shlocks.h>
+#include <onlplib/ipmi.h>
 typedef unsigned int    UINT4;
 
 /* CPLD numbrt & peripherals */
@@ -28,6 +28,7 @@
 #include "x86_64_delta_agc7008s_log.h"
 #include <onlp/onlp.h>
 #include <onlplib/shlocks.h>
+#include <onlplib/ipmi.h>
 
 typedef unsigned int UINT4;
 
@@ -76,7 +77,6 @@ typedef unsigned int UINT4;
 #define IDPROM_PATH "/sys/class/i2c-adapter/i2c-0/0-0056/eeprom"
 #define PORT_EEPROM_FORMAT "/sys/bus/i2c/devices/%d-0050/eeprom"
 #define CHECK_TIME_FILE "/tmp/check_time_file"
-#define BMC_INFO_TABLE "/tmp/bmc_info"
 #define PREFIX_PATH   "/sys/bus/i2c/devices/"
 
 #define CPLD_VERSION_OFFSET             4
@@ -163,165 +163,57 @@ vendor_dev_t psu_dev_list[] =
     {"PSU2_Pout", PSU_SENSOR, PSU2_ID,      0}
 };
 
-check_time_t bmc_check = {0};
 
 int dni_bmc_sensor_read(char *device_name, UINT4 *num, UINT4 multiplier, int sensor_type)
 {
-    struct timeval new_tv;
-    FILE *fpRead = NULL;
-    char ipmi_cmd[VENDOR_MAX_CMD_SIZE] = {0};
-    char get_data_cmd[VENDOR_MAX_CMD_SIZE] = {0};
-    char buf[VENDOR_MAX_BUF_SIZE];
-    int rv = ONLP_STATUS_OK;
+    vendor_dev_t *dev_list = NULL;
+    int dev_list_size = 0;
     int dev_list_index = 0;
     int time_threshold = 0;
-    int ipmi_data_update = 0;
-    float num_f = 0;
-    long file_last_time = 0;
+    double value = 0;
+    int rv;
 
     switch (sensor_type)
     {
         case THERMAL_SENSOR:
+            dev_list = thermal_dev_list;
+            dev_list_size = THERMAL_LIST_SIZE;
             time_threshold = THERMAL_TIME_THRESHOLD;
             break;
         case FAN_SENSOR:
+            dev_list = fan_dev_list;
+            dev_list_size = FAN_LIST_SIZE;
             time_threshold = FAN_TIME_THRESHOLD;
             break;
         case PSU_SENSOR:
+            dev_list = psu_dev_list;
+            dev_list_size = PSU_LIST_SIZE;
             time_threshold = PSU_TIME_THRESHOLD;
             break;
+        default:
+            return ONLP_STATUS_E_PARAM;
     }
 
-    /* Check if the /tmp/bmc_info is exist or not and use
-       the current time to compare the time of temp file */
-    if (dni_check_file_exist(BMC_INFO_TABLE, &file_last_time))
+    for (dev_list_index = FIRST_DEV_INDEX; dev_list_index < dev_list_size; dev_list_index++)
     {
-        gettimeofday(&new_tv, NULL);
-        if (dni_ipmi_data_time_check(file_last_time, new_tv.tv_sec, time_threshold))
-            ipmi_data_update = 1;
-        else
-            ipmi_data_update = 0;
+        /* Ignore the empty dev_name */
+        if (strcmp(dev_list[dev_list_index].dev_name, "") == 0)
+            continue;
+        if (strstr(dev_list[dev_list_index].dev_name, device_name) == NULL)
+            continue;
+
+        /* Sensors without a reading (e.g. an absent PSU) read as zero. */
+        rv = onlp_ipmi_sensor_get(dev_list[dev_list_index].dev_name,
+                                  time_threshold * 1000000ULL, &value);
+        if (rv < 0 && rv != ONLP_STATUS_E_UNSUPPORTED && rv != ONLP_STATUS_E_MISSING)
+            return rv;
+
+        dev_list[dev_list_index].data = value;
+        *num = dev_list[dev_list_index].data * multiplier;
+        break;
     }
-    else
-        ipmi_data_update = 1;
-
-    /* A temp file is created but a new thread need to get the current time to compare */
-    if (bmc_check.time == 0 && dni_check_file_exist(BMC_INFO_TABLE, &file_last_time))
-    {
-        ipmi_data_update = 1;
-        gettimeofday(&new_tv, NULL);
-        bmc_check.time = new_tv.tv_sec;
-    }
-
-    if (ipmi_data_update == 1)
-    {
-        DNI_LOCK();
-        if (dni_ipmi_data_time_check(file_last_time, bmc_check.time, time_threshold))
-        {
-            sprintf(ipmi_cmd, "ipmitool sdr > /tmp/bmc_info");
-            system(ipmi_cmd);
-        }
 
-        /* Parse thermal_dev_list data */
-        for (dev_list_index = FIRST_DEV_INDEX; dev_list_index < THERMAL_LIST_SIZE; dev_list_index++)
-        {
-            memset(buf, 0, sizeof(buf));
-            /* Ignore the empty dev_name */
-            if (strcmp(thermal_dev_list[dev_list_index].dev_name, "") == 0)
-                continue;
-            sprintf(get_data_cmd, "cat /tmp/bmc_info | grep %s | awk -F'|' '{print $2}' | awk -F' ' '{ print $1}'",
-                thermal_dev_list[dev_list_index].dev_name);
-            fpRead = popen(get_data_cmd, "r");
-            if (fpRead != NULL)
-            {
-                if (fgets(buf, sizeof(buf), fpRead) != NULL)
-                {
-                    num_f = atof(buf);
-                    thermal_dev_list[dev_list_index].data = num_f;
-                }
-            }
-            pclose(fpRead);
-        }
-
-        /* Parse fan_dev_list data */
-        for (dev_list_index = FIRST_DEV_INDEX; dev_list_index < FAN_LIST_SIZE; dev_list_index++)
-        {
-            memset(buf, 0, sizeof(buf));
-            sprintf(get_data_cmd, "cat /tmp/bmc_info | grep %s | awk -F'|' '{print $2}' | awk -F' ' '{ print $1}'",
-                fan_dev_list[dev_list_index].dev_name);
-            fpRead = popen(get_data_cmd, "r");
-            if (fpRead != NULL)
-            {
-                if (fgets(buf, sizeof(buf), fpRead) != NULL)
-                {
-                    num_f = atof(buf);
-                    fan_dev_list[dev_list_index].data = num_f;
-                }
-            }
-            pclose(fpRead);
-        }
-
-        /* Parse psu_dev_list data */
-        for (dev_list_index = FIRST_DEV_INDEX; dev_list_index < PSU_LIST_SIZE; dev_list_index++)
-        {
-            memset(buf, 0, sizeof(buf));
-            sprintf(get_data_cmd, "cat /tmp/bmc_info | grep %s | awk -F'|' '{print $2}' | awk -F' ' '{ print $1}'",
-                psu_dev_list[dev_list_index].dev_name);
-            fpRead = popen(get_data_cmd, "r");
-            if (fpRead != NULL)
-            {
-                if (fgets(buf, sizeof(buf), fpRead) != NULL)
-                {
-                    num_f = atof(buf);
-                    psu_dev_list[dev_list_index].data = num_f;
-                }
-            }
-            pclose(fpRead);
-        }
-        gettimeofday(&new_tv, NULL);
-        bmc_check.time = new_tv.tv_sec;
-        DNI_UNLOCK();
-    }
-
-    if (sensor_type == THERMAL_SENSOR)
-    {
-        for (dev_list_index = FIRST_DEV_INDEX; dev_list_index < THERMAL_LIST_SIZE; dev_list_index++)
-        {
-            if (strstr(thermal_dev_list[dev_list_index].dev_name, device_name) != NULL)
-            {
-                *num = thermal_dev_list[dev_list_index].data * multiplier;
-                rv = ONLP_STATUS_OK;
-                goto END;
-            }
-        }
-    }
-    else if (sensor_type == FAN_SENSOR)
-    {
-        for (dev_list_index = FIRST_DEV_INDEX; dev_list_index < FAN_LIST_SIZE; dev_list_index++)
-        {
-            if (strstr(fan_dev_list[dev_list_index].dev_name, device_name) != NULL)
-            {
-                *num = fan_dev_list[dev_list_index].data * multiplier;
-                rv = ONLP_STATUS_OK;
-                goto END;
-            }
-        }
-    }
-    else if (sensor_type == PSU_SENSOR)
-    {
-        for (dev_list_index = FIRST_DEV_INDEX; dev_list_index < PSU_LIST_SIZE; dev_list_index++)
-        {
-            if (strstr(psu_dev_list[dev_list_index].dev_name, device_name) != NULL)
-            {
-                *num = psu_dev_list[dev_list_index].data * multiplier;
-                rv = ONLP_STATUS_OK;
-                goto END;
-            }
-        }
-    }
-
-END:
-    return rv;
+    return ONLP_STATUS_OK;
 }
 
 swpld_info_t swpld_table[]=
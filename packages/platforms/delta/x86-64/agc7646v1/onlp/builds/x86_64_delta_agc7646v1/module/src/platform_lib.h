@@ -29,6 +29,7 @@
 #include "x86_64_delta_agc7646v1_log.h"
 #include <onlp/onlp.h>
 #include <onlplib/shlocks.h>
+#include <onlplib/ipmi.h>
 
 typedef unsigned int    UINT4;
 
@@ -72,7 +73,6 @@ typedef unsigned int    UINT4;
 #define IDPROM_PATH "/sys/class/i2c-adapter/i2c-1/1-0053/eeprom"
 #define PORT_EEPROM_FORMAT "/sys/bus/i2c/devices/%d-0050/eeprom"
 #define CHECK_TIME_FILE "/tmp/check_time_file"
-#define BMC_INFO_TABLE "/tmp/bmc_info"
 #define PREFIX_PATH   "/sys/bus/i2c/devices/"
 
 #define ATTRIBUTE_BASE_DEC             10
@@ -154,21 +154,13 @@ bmc_info_t dev[] =
     {"PSU2_Temp_1", 0}
 };
 
-check_time_t bmc_check = {0};
 
 int dni_bmc_sensor_read(char *device_name, UINT4 *num, UINT4 multiplier, int sensor_type)
 {
-    struct timeval new_tv;
-    FILE *fpRead = NULL;
-    char ipmi_cmd[120] = {0};
-    char get_data_cmd[120] = {0};
-    char Buf[10];
-    int rv = ONLP_STATUS_OK;
     int dev_num = 0;
     int time_threshold = 0;
-    int ipmi_data_update = 0;
-    float num_f = 0;
-    long file_last_time = 0;
+    double value = 0;
+    int rv;
 
     switch(sensor_type)
     {
@@ -183,70 +175,22 @@ int dni_bmc_sensor_read(char *device_name, UINT4 *num, UINT4 multiplier, int sen
             break;
     }
 
-    if(dni_check_file_exist(BMC_INFO_TABLE, &file_last_time))
-    {
-        gettimeofday(&new_tv,NULL);
-        if(dni_ipmi_data_time_check(file_last_time, new_tv.tv_sec, time_threshold))
-        {
-            ipmi_data_update = 1;
-        }
-        else
-        {
-            ipmi_data_update = 0;
-        }
-    }
-    else
+    for(dev_num = 0; dev_num < DEV_NUM; dev_num++)
     {
-        ipmi_data_update = 1;
-    }
+        if(strstr(dev[dev_num].tag, device_name) == NULL)
+            continue;
 
-    if(bmc_check.time == 0 && dni_check_file_exist(BMC_INFO_TABLE, &file_last_time))
-    {
-        ipmi_data_update = 1;
-        gettimeofday(&new_tv,NULL);
-        bmc_check.time = new_tv.tv_sec;
-    }
+        /* Sensors without a reading (e.g. an absent PSU) read as zero. */
+        rv = onlp_ipmi_sensor_get(dev[dev_num].tag, time_threshold * 1000000ULL, &value);
+        if(rv < 0 && rv != ONLP_STATUS_E_UNSUPPORTED && rv != ONLP_STATUS_E_MISSING)
+            return rv;
 
-    if(ipmi_data_update == 1)
-    {
-        DNI_LOCK();
-        if(dni_ipmi_data_time_check(file_last_time, bmc_check.time, time_threshold))
-        {
-            sprintf(ipmi_cmd, "ipmitool sdr > /tmp/bmc_info");
-            system(ipmi_cmd);
-        }
-
-        for(dev_num = 0; dev_num < DEV_NUM; dev_num++)
-        {
-            memset(Buf, 0, sizeof(Buf));
-            sprintf(get_data_cmd, "cat /tmp/bmc_info | grep %s | awk -F'|' '{print $2}' | awk -F' ' '{ print $1}'", dev[dev_num].tag);
-            fpRead = popen(get_data_cmd, "r");
-            if(fpRead != NULL)
-            {
-                if(fgets(Buf, sizeof(Buf), fpRead) != NULL)
-                {
-                    num_f = atof(Buf);
-                    dev[dev_num].data = num_f;
-                }
-            }
-            pclose(fpRead);
-        }
-        gettimeofday(&new_tv,NULL);
-        bmc_check.time = new_tv.tv_sec;
-        DNI_UNLOCK();
+        dev[dev_num].data = value;
+        *num = dev[dev_num].data * multiplier;
+        break;
     }
 
-    for(dev_num = 0; dev_num < DEV_NUM; dev_num++)
-    {
-        if(strstr(dev[dev_num].tag, device_name) != NULL)
-        {
-            *num = dev[dev_num].data * multiplier;
-            rv =  ONLP_STATUS_OK;
-            goto END;
-        }
-    }
-END:
-    return rv;
+    return ONLP_STATUS_OK;
 }
 
 swpld_info_t swpld_table[]=
@@ -30,7 +30,12 @@
 #include <onlplib/file.h>
 #include <onlplib/i2c.h>
 #include <onlplib/sfp.h>
+#include <errno.h>
 #include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <linux/ethtool.h>
+#include <linux/sockios.h>
 #include "mlnx_common_log.h"
 #include "mlnx_common_int.h"
 
@@ -89,25 +94,111 @@ mc_sfp_get_port_path(int port, char *node_name)
     return sfp_node_path;
 }
 
-static char*
-mc_sfp_convert_i2c_path(int port, int devaddr)
+static int mc_sfp_ethtool_fd = -1;
+
+static int
+mc_sfp_ethtool(int port, void* data)
 {
-    sprintf(sfp_node_path, "%s/sfp%d", SFP_PATH, port);
-    return sfp_node_path;
+    struct ifreq ifr;
+
+    if (mc_sfp_ethtool_fd < 0) {
+        mc_sfp_ethtool_fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (mc_sfp_ethtool_fd < 0) {
+            AIM_LOG_ERROR("Unable to open ethtool socket: %{errno}", errno);
+            return -1;
+        }
+    }
+
+    memset(&ifr, 0, sizeof(ifr));
+    snprintf(ifr.ifr_name, sizeof(ifr.ifr_name), "sfp%d", port);
+    ifr.ifr_data = data;
+    return ioctl(mc_sfp_ethtool_fd, SIOCETHTOOL, &ifr);
 }
 
 static int
-mc_sfp_prepare_eeprom_dump(int port, const char* path)
+mc_sfp_ethtool_modinfo(int port, struct ethtool_modinfo* modinfo)
 {
-    char* cmd = aim_fstrdup("ethtool -m sfp%d raw on length 256 > %s", port, path);
+    memset(modinfo, 0, sizeof(*modinfo));
+    modinfo->cmd = ETHTOOL_GMODULEINFO;
+    if (mc_sfp_ethtool(port, modinfo) < 0) {
+        return (errno == EOPNOTSUPP) ? ONLP_STATUS_E_UNSUPPORTED :
+            ONLP_STATUS_E_MISSING;
+    }
+    return ONLP_STATUS_OK;
+}
 
-    if(system(cmd) != 0) {
-        aim_free(cmd);
-        return ONLP_STATUS_E_INTERNAL;
+/*
+ * The A2h device is only present in the linear layout of
+ * SFF-8472 modules. For other module types offset 256 is an
+ * upper page of A0h.
+ */
+static int
+mc_sfp_ethtool_dom_check(int port)
+{
+    struct ethtool_modinfo modinfo;
+    int rv = mc_sfp_ethtool_modinfo(port, &modinfo);
+    if (rv < 0) {
+        return rv;
+    }
+    if (modinfo.type != ETH_MODULE_SFF_8472 || modinfo.eeprom_len <= 256) {
+        return ONLP_STATUS_E_UNSUPPORTED;
     }
-    aim_free(cmd);
+    return ONLP_STATUS_OK;
+}
 
-	return ONLP_STATUS_OK;
+/*
+ * Read from the module EEPROM of the port's netdev using the
+ * ethtool ioctls. The offset is in the driver's linear layout:
+ * the A2h device follows A0h for SFF-8472, and upper pages follow
+ * page 0 at 128 bytes each for SFF-8636 and CMIS.
+ */
+static int
+mc_sfp_ethtool_read(int port, int offset, int len, uint8_t* dst)
+{
+    struct ethtool_modinfo modinfo;
+    struct ethtool_eeprom* eeprom;
+    int rv;
+
+    if ((rv = mc_sfp_ethtool_modinfo(port, &modinfo)) < 0) {
+        return rv;
+    }
+    if (offset + len > modinfo.eeprom_len) {
+        return ONLP_STATUS_E_UNSUPPORTED;
+    }
+
+    eeprom = aim_zmalloc(sizeof(*eeprom) + len);
+    eeprom->cmd = ETHTOOL_GMODULEEEPROM;
+    eeprom->offset = offset;
+    eeprom->len = len;
+    if (mc_sfp_ethtool(port, eeprom) < 0) {
+        AIM_LOG_ERROR("Unable to read eeprom from port(%d): %{errno}\r\n", port, errno);
+        rv = ONLP_STATUS_E_INTERNAL;
+    }
+    else {
+        memcpy(dst, eeprom->data, len);
+        rv = ONLP_STATUS_OK;
+    }
+    aim_free(eeprom);
+    return rv;
+}
+
+/*
+ * Single byte or word access to A0h or A2h, as through i2c.
+ */
+static int
+mc_sfp_dev_read(int port, uint8_t devaddr, uint8_t addr, int len, uint8_t* dst)
+{
+    if (devaddr == 0x51) {
+        int rv = mc_sfp_ethtool_dom_check(port);
+        if (rv < 0) {
+            return rv;
+        }
+        return mc_sfp_ethtool_read(port, 256 + addr, len, dst);
+    }
+    if (devaddr != 0x50) {
+        return ONLP_STATUS_E_UNSUPPORTED;
+    }
+    return mc_sfp_ethtool_read(port, addr, len, dst);
 }
 
 /************************************************************
@@ -174,12 +265,6 @@ onlp_sfpi_presence_bitmap_get(onlp_sfp_bitmap_t* dst)
 int
 onlp_sfpi_eeprom_read(int port, uint8_t data[256])
 {
-    char* path = mc_sfp_get_port_path(port, NULL);
-
-	if (mc_sfp_prepare_eeprom_dump(port, path) != ONLP_STATUS_OK) {
-            AIM_LOG_ERROR("Unable to prepare sfp%d eeprom dump\r\n", port);
-            return ONLP_STATUS_E_INTERNAL;
-	}
     /*
      * Read the SFP eeprom into data[]
      *
@@ -187,71 +272,90 @@ onlp_sfpi_eeprom_read(int port, uint8_t data[256])
      * Return OK if eeprom is read
      */
     memset(data, 0, 256);
-
-    if (onlplib_sfp_eeprom_read_file(path, data) != 0) {
-        AIM_LOG_ERROR("Unable to read eeprom from port(%d)\r\n", port);
-        return ONLP_STATUS_E_INTERNAL;
-    }
-
-    return ONLP_STATUS_OK;
+    return mc_sfp_ethtool_read(port, 0, 256, data);
 }
 
 int
-onlp_sfpi_dev_readb(int port, uint8_t devaddr, uint8_t addr)
+onlp_sfpi_dom_read(int port, uint8_t data[256])
 {
-    char* path = mc_sfp_convert_i2c_path(port, devaddr);
-    uint8_t data;
-    int fd;
-    int nrd;
-
-    if (!path)
-		return ONLP_STATUS_E_MISSING;
-
-    fd = open(path, O_RDONLY);
-    if (fd < 0)
-		return ONLP_STATUS_E_MISSING;
-
-    lseek(fd, addr, SEEK_SET);
-    nrd = read(fd, &data, 1);
-    close(fd);
-
-    if (nrd != 1) {
-		AIM_LOG_INTERNAL("Failed to read EEPROM file '%s'", path);
-		return ONLP_STATUS_E_INTERNAL;
+    /* SFF-8472 A2h follows A0h. */
+    int rv = mc_sfp_ethtool_dom_check(port);
+    if (rv < 0) {
+        return rv;
     }
-    return data;
+    memset(data, 0, 256);
+    return mc_sfp_ethtool_read(port, 256, 256, data);
 }
 
 int
-onlp_sfpi_dev_readw(int port, uint8_t devaddr, uint8_t addr)
+onlp_sfpi_eeprom_readv(int port, uint8_t devaddr, int page,
+                       int offset, int len, uint8_t* dst)
 {
-    char* path = mc_sfp_convert_i2c_path(port, devaddr);
-    uint16_t data;
-    int fd;
-    int nrd;
-
-    if (!path){
-		return ONLP_STATUS_E_MISSING;
+    if (devaddr == 0x51) {
+        /* SFF-8472 A2h. Its upper pages are not exposed. */
+        if (page != 0 && offset + len > 128) {
+            return ONLP_STATUS_E_UNSUPPORTED;
+        }
+        int rv = mc_sfp_ethtool_dom_check(port);
+        if (rv < 0) {
+            return rv;
+        }
+        return mc_sfp_ethtool_read(port, 256 + offset, len, dst);
+    }
+    if (devaddr != 0x50) {
+        return ONLP_STATUS_E_UNSUPPORTED;
     }
 
-    fd = open(path, O_RDONLY);
-    if (fd < 0) {
-		return ONLP_STATUS_E_MISSING;
+    if (page == 0 || offset + len <= 128) {
+        return mc_sfp_ethtool_read(port, offset, len, dst);
     }
 
-    lseek(fd, addr, SEEK_SET);
-    nrd = read(fd, &data, 2);
-    close(fd);
+    /* SFP modules have no upper pages at A0h. */
+    struct ethtool_modinfo modinfo;
+    int rv = mc_sfp_ethtool_modinfo(port, &modinfo);
+    if (rv < 0) {
+        return rv;
+    }
+    if (modinfo.type == ETH_MODULE_SFF_8079 || modinfo.type == ETH_MODULE_SFF_8472) {
+        return ONLP_STATUS_E_UNSUPPORTED;
+    }
 
-    if (nrd != 2) {
-		AIM_LOG_INTERNAL("Failed to read EEPROM file '%s'", path);
-		return ONLP_STATUS_E_INTERNAL;
+    if (offset < 128) {
+        rv = mc_sfp_ethtool_read(port, offset, 128 - offset, dst);
+        if (rv < 0) {
+            return rv;
+        }
+        dst += 128 - offset;
+        len -= 128 - offset;
+        offset = 128;
     }
-    return data;
+    /* Upper page N is at N * 128 + 128. */
+    return mc_sfp_ethtool_read(port, page * 128 + offset, len, dst);
+}
+
+int
+onlp_sfpi_dev_readb(int port, uint8_t devaddr, uint8_t addr)
+{
+    uint8_t data;
+    int rv = mc_sfp_dev_read(port, devaddr, addr, 1, &data);
+    return (rv < 0) ? rv : data;
+}
+
+int
+onlp_sfpi_dev_readw(int port, uint8_t devaddr, uint8_t addr)
+{
+    uint8_t data[2];
+    int rv = mc_sfp_dev_read(port, devaddr, addr, 2, data);
+    /* SMBus word order, as onlp_i2c_readw() returns it. */
+    return (rv < 0) ? rv : (data[0] | (data[1] << 8));
 }
 
 int
 onlp_sfpi_denit(void)
 {
+    if (mc_sfp_ethtool_fd >= 0) {
+        close(mc_sfp_ethtool_fd);
+        mc_sfp_ethtool_fd = -1;
+    }
     return ONLP_STATUS_OK;
 }